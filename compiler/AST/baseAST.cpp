@@ -330,6 +330,118 @@ int lastNodeIDUsed() {
 }
 
 
+//
+// AST nodes are allocated from arenas, one per node size.  Nodes are
+// carved out of large blocks, and those that cleanAst() deletes are
+// kept on a free list for their size to be reused by the next nodes of
+// that size.  Large compiles create and delete many millions of nodes,
+// and this is much cheaper than going through malloc() for each one,
+// with less per-node overhead.  Blocks are never returned to the system.
+//
+// Nodes are allocated with malloc() instead when the compiler is built
+// with AddressSanitizer or run under valgrind by the test system, so
+// that those can still catch uses of deleted nodes.
+//
+static const size_t kArenaGrain     = 16;
+static const size_t kArenaMaxNode   = 1024;
+static const size_t kArenaBlockSize = 1024 * 1024;
+
+struct ArenaFreeNode {
+  ArenaFreeNode* next;
+};
+
+static ArenaFreeNode* arenaFreeList[kArenaMaxNode / kArenaGrain + 1];
+static char*          arenaBlockPos    = NULL;
+static char*          arenaBlockEnd    = NULL;
+static size_t         arenaBytesInUse  = 0;
+static size_t         arenaBytesInHeap = 0;
+
+static bool useArenas() {
+  static int use = -1;
+
+  if (use == -1) {
+#if defined(__SANITIZE_ADDRESS__)
+    use = 0;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+    use = 0;
+#endif
+#endif
+
+    if (use == -1) {
+      const char* vgrnd = getenv("CHPL_TEST_VGRND_COMP");
+
+      use = (vgrnd != NULL && strcmp(vgrnd, "on") == 0) ? 0 : 1;
+    }
+  }
+
+  return use == 1;
+}
+
+void* BaseAST::operator new(size_t size) {
+  size_t rounded = (size + kArenaGrain - 1) & ~(kArenaGrain - 1);
+  void*  retval  = NULL;
+
+  arenaBytesInUse += rounded;
+
+  if (rounded > kArenaMaxNode || useArenas() == false) {
+    arenaBytesInHeap += rounded;
+    retval            = malloc(size);
+
+    if (retval == NULL)
+      INT_FATAL("out of memory for AST nodes");
+
+  } else if (ArenaFreeNode* node = arenaFreeList[rounded / kArenaGrain]) {
+    arenaFreeList[rounded / kArenaGrain] = node->next;
+    retval                               = node;
+
+  } else {
+    if (arenaBlockPos + rounded > arenaBlockEnd) {
+      arenaBlockPos = (char*) malloc(kArenaBlockSize);
+
+      if (arenaBlockPos == NULL)
+        INT_FATAL("out of memory for AST nodes");
+
+      arenaBlockEnd     = arenaBlockPos + kArenaBlockSize;
+      arenaBytesInHeap += kArenaBlockSize;
+    }
+
+    retval         = arenaBlockPos;
+    arenaBlockPos += rounded;
+  }
+
+  return retval;
+}
+
+void BaseAST::operator delete(void* ptr, size_t size) {
+  size_t rounded = (size + kArenaGrain - 1) & ~(kArenaGrain - 1);
+
+  if (ptr == NULL)
+    return;
+
+  arenaBytesInUse -= rounded;
+
+  if (rounded > kArenaMaxNode || useArenas() == false) {
+    arenaBytesInHeap -= rounded;
+    free(ptr);
+
+  } else {
+    ArenaFreeNode* node = (ArenaFreeNode*) ptr;
+
+    node->next                           = arenaFreeList[rounded / kArenaGrain];
+    arenaFreeList[rounded / kArenaGrain] = node;
+  }
+}
+
+size_t astBytesInUse() {
+  return arenaBytesInUse;
+}
+
+size_t astBytesReserved() {
+  return arenaBytesInHeap;
+}
+
+
 // This is here so that we can break on the creation of a particular
 // BaseAST instance in gdb.
 static void checkid(int id) {
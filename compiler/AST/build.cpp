@@ -44,6 +44,7 @@
 #include <utility>
 
 static BlockStmt* findStmtWithTag(PrimitiveTag tag, BlockStmt* blockStmt);
+static Expr* extractLocaleID(Expr* expr);
 
 void checkControlFlow(Expr* expr, const char* context) {
   Vec<const char*> labelSet; // all labels in expr argument
@@ -1176,6 +1177,127 @@ static BlockStmt* buildLoweredCoforall(Expr* indices,
 }
 
 
+// Build up a coforall+on over an array of locales whose tasks may be
+// started down a tree of the locales rather than all from here.  For
+//
+//     coforall loc in tmpIter do on loc { body(); }
+//
+// this builds
+//
+//     var _coforallCount = _endCountAlloc(false);
+//     var numTasks = tmpIter.size;
+//     _upEndCount(_coforallCount, false, numTasks);
+//     const chpl__treeRoot = chpl__coforallOnTreeRoot(tmpIter);
+//     for loc in chpl__coforallOnTreeRoots(tmpIter, chpl__treeRoot) {
+//       /* PRIM_BLOCK_COFORALL_ON */ on loc {
+//         for chpl__treeChild in chpl__coforallOnTreeChildren(chpl__treeRoot) {
+//           const childLoc = chpl__coforallOnTreeLocale(chpl__treeChild);
+//           /* PRIM_COFORALL_ON_FORWARD */ <this on-block, on and for childLoc>
+//         }
+//         body();
+//         _downEndCount(_coforallCount, nil);
+//       }
+//     }
+//     _waitEndCount(_coforallCount, false, numTasks);
+//     _endCountFree(_coforallCount);
+//
+// When tmpIter is the Locales array and there are more locales than the
+// tree fanout, chpl__treeRoot is this locale's id, the outer loop yields
+// just this locale, and each task starts the ones for its children before
+// running the body.  Otherwise chpl__treeRoot is -1, the outer loop yields
+// all of tmpIter and there are no children, which is the same as the
+// bounded case of buildLoweredCoforall().  createTaskFunctions() replaces
+// the PRIM_COFORALL_ON_FORWARD with a call that starts the on_fn again,
+// with 'childLoc' as the target locale and as 'loc'.
+static BlockStmt* buildTreeCoforallOn(Expr* indices,
+                                      VarSymbol* iterator,
+                                      BlockStmt* body) {
+  UnresolvedSymExpr* index = toUnresolvedSymExpr(indices);
+  BlockStmt* onBlock = findStmtWithTag(PRIM_BLOCK_ON, body);
+  INT_ASSERT(index && onBlock);
+
+  VarSymbol* coforallCount = newTempConst("_coforallCount");
+  coforallCount->addFlag(FLAG_END_COUNT);
+  VarSymbol* numTasks = newTemp("numTasks");
+
+  // This is referenced in the task, and unlike a temp, will be passed
+  // to it as a task function argument by createTaskFunctions().
+  VarSymbol* treeRoot = new VarSymbol("chpl__treeRoot");
+  treeRoot->addFlag(FLAG_CONST);
+
+  VarSymbol* childLoc = newTempConst("childLoc");
+  VarSymbol* childLocID = newTempConst("childLocID");
+  BlockStmt* forwardBlk = new BlockStmt();
+  forwardBlk->insertAtTail(new DefExpr(childLoc));
+  forwardBlk->insertAtTail(new CallExpr(PRIM_MOVE, childLoc,
+                             new CallExpr("chpl__coforallOnTreeLocale",
+                               new UnresolvedSymExpr("chpl__treeChild"))));
+  forwardBlk->insertAtTail(new DefExpr(childLocID));
+  forwardBlk->insertAtTail(new CallExpr(PRIM_MOVE, childLocID,
+                             new CallExpr(PRIM_DEREF,
+                               extractLocaleID(new SymExpr(childLoc)))));
+  forwardBlk->insertAtTail(new CallExpr(PRIM_COFORALL_ON_FORWARD,
+                                        childLocID, childLoc,
+                                        new UnresolvedSymExpr(index->unresolved)));
+
+  onBlock->blockInfoGet()->primitive = primitives[PRIM_BLOCK_COFORALL_ON];
+  onBlock->insertAtHead(ForLoop::buildForLoop(
+                          new UnresolvedSymExpr("chpl__treeChild"),
+                          new CallExpr("chpl__coforallOnTreeChildren",
+                                       treeRoot),
+                          forwardBlk, false, false));
+  // Note: gNil is here so error handling can be added by compiler
+  // in parallel pass.
+  onBlock->insertAtTail(new CallExpr("_downEndCount", coforallCount, gNil));
+
+  BlockStmt* block = new BlockStmt();
+  block->insertAtTail(new DefExpr(coforallCount));
+  block->insertAtTail(new CallExpr(PRIM_MOVE, coforallCount, new CallExpr("_endCountAlloc", gFalse)));
+  block->insertAtTail(new DefExpr(numTasks));
+  block->insertAtTail(new CallExpr(PRIM_MOVE, numTasks, new CallExpr(".", iterator,  new_CStringSymbol("size"))));
+  block->insertAtTail(new CallExpr("_upEndCount", coforallCount, gFalse, numTasks));
+  block->insertAtTail(new DefExpr(treeRoot,
+                                  new CallExpr("chpl__coforallOnTreeRoot",
+                                               iterator)));
+  block->insertAtTail(ForLoop::buildCoforallLoop(indices,
+                        new CallExpr("chpl__coforallOnTreeRoots",
+                                     iterator, treeRoot),
+                        body, false));
+  block->insertAtTail(new DeferStmt(new CallExpr("_endCountFree", coforallCount)));
+  block->insertAtTail(new CallExpr("_waitEndCount", coforallCount, gFalse, numTasks));
+  return block;
+}
+
+
+// Is 'body' just "on <index>", where <index> is the coforall's (only)
+// index variable, and not yielding from an iterator?
+static bool isOnIndexBody(Expr* indices, BlockStmt* body) {
+  UnresolvedSymExpr* index = toUnresolvedSymExpr(indices);
+  BlockStmt* onBlock = findStmtWithTag(PRIM_BLOCK_ON, body);
+  if (index == NULL || onBlock == NULL)
+    return false;
+
+  std::vector<CallExpr*> calls;
+  collectCallExprs(body, calls);
+  for_vector(CallExpr, call, calls)
+    if (call->isPrimitive(PRIM_YIELD))
+      return false;
+
+  // buildOnStmt() puts the on-expression in a temp just before the block.
+  if (CallExpr* move = toCallExpr(onBlock->prev))
+    if (move->isPrimitive(PRIM_MOVE))
+      if (CallExpr* deref = toCallExpr(move->get(2)))
+        if (deref->isPrimitive(PRIM_DEREF))
+          if (CallExpr* getLocale = toCallExpr(deref->get(1)))
+            if (getLocale->isPrimitive(PRIM_WIDE_GET_LOCALE))
+              if (UnresolvedSymExpr* target =
+                    toUnresolvedSymExpr(getLocale->get(1)))
+                return target->unresolved == index->unresolved;
+
+  return false;
+}
+
+
 // Remove an extra level of BlockStmt to simplify pattern matching later
 // in compilation. Ex. test/parallel/taskPar/taskIntents/ri-coforall+on.chpl
 static void removeWrappingBlock(BlockStmt*& block) {
@@ -1228,6 +1350,21 @@ static void removeWrappingBlock(BlockStmt*& block) {
 // they're available, we won't manipulate here.runningTaskCount, and we'll use
 // PRIM_BLOCK_COFORALL_ON instead of PRIM_BLOCK_COFORALL so that we just do
 // remote-forks instead of creating any tasks locally.
+//
+// And when that is exactly
+//
+//     coforall loc in iterator do on loc { body(); }
+//
+// with no task intents, the bounded case becomes
+//
+//     param isLocArr = chpl__coforallOnTree(tmpIter);
+//     if isLocArr {
+//       <see buildTreeCoforallOn()>
+//     } else {
+//       <the bounded case>
+//     }
+//
+// where chpl__coforallOnTree() is true if tmpIter is an array of locales.
 BlockStmt* buildCoforallLoopStmt(Expr* indices,
                                  Expr* iterator,
                                  CallExpr* byref_vars,
@@ -1245,6 +1382,9 @@ BlockStmt* buildCoforallLoopStmt(Expr* indices,
 
   SET_LINENO(body);
 
+  bool onIndex = !zippered && byref_vars == NULL &&
+                 isOnIndexBody(indices, body);
+
   VarSymbol* tmpIter = newTemp("tmpIter");
   tmpIter->addFlag(FLAG_EXPR_TEMP);
   tmpIter->addFlag(FLAG_MAYBE_REF);
@@ -1255,6 +1395,18 @@ BlockStmt* buildCoforallLoopStmt(Expr* indices,
   coforallBlk->insertAtTail(new CallExpr(PRIM_MOVE, tmpIter, iterator));
 
   BlockStmt* vectorCoforallBlk = buildLoweredCoforall(indices, tmpIter, copyByrefVars(byref_vars), body->copy(), zippered, /*bounded=*/true);
+  if (onIndex) {
+    BlockStmt* boundedCoforallBlk = vectorCoforallBlk;
+    BlockStmt* treeCoforallBlk = buildTreeCoforallOn(indices->copy(), tmpIter, body->copy());
+    VarSymbol* isLocArr = newTemp("isLocArr");
+    isLocArr->addFlag(FLAG_MAYBE_PARAM);
+    vectorCoforallBlk = new BlockStmt(new DefExpr(isLocArr));
+    vectorCoforallBlk->insertAtTail(new CallExpr(PRIM_MOVE, isLocArr,
+                                    new CallExpr("chpl__coforallOnTree", tmpIter)));
+    vectorCoforallBlk->insertAtTail(new CondStmt(new SymExpr(isLocArr),
+                                                 treeCoforallBlk,
+                                                 boundedCoforallBlk));
+  }
   BlockStmt* nonVectorCoforallBlk = buildLoweredCoforall(indices, tmpIter, byref_vars, body, zippered, /*bounded=*/false);
 
   VarSymbol* isRngDomArr = newTemp("isRngDomArr");
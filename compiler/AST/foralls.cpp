@@ -1470,6 +1470,41 @@ static Expr* lowerReduceOp(Expr* ref, SymExpr* opSE, SymExpr* dataSE,
   return new CallExpr(opSE, iitR);
 }
 
+// Should "op reduce data" be done by chpl__commAllreduce() instead of
+// a forall?  If so, return the resolved type of the reduce op.
+// See chpl__canCommAllreduce() in ChapelReduce.  Only reductions of
+// whole arrays by op classes (not instances) are candidates, and only
+// in multilocale programs.  The module code doing it uses reduce
+// expressions itself, so those in internal modules are always lowered
+// to foralls.
+static Symbol* commAllreduceOpType(Expr* ref, SymExpr* opSE, Expr* opExpr,
+                                   SymExpr* dataSE, bool zippered)
+{
+  if (fLocal || zippered || ref->getModule()->modTag == MOD_INTERNAL)
+    return NULL;
+
+  if (!isTypeSymbol(opSE->symbol()) ||
+      !dataSE->symbol()->getValType()->symbol->hasFlag(FLAG_ARRAY))
+    return NULL;
+
+  Expr* opCall = opExpr->copy();
+  ref->insertBefore(opCall);
+  Expr* opTypeR = resolveExpr(opCall)->remove();
+  SymExpr* opTypeSE = toSymExpr(opTypeR);
+  if (opTypeSE == NULL || !isTypeSymbol(opTypeSE->symbol()))
+    return NULL;
+
+  Symbol*   opType = opTypeSE->symbol();
+  CallExpr* check  = new CallExpr("chpl__canCommAllreduce",
+                                  opType, dataSE->symbol());
+  ref->insertBefore(check);
+  Expr* checkR = resolveExpr(check);
+  bool  use    = isSymExpr(checkR) && toSymExpr(checkR)->symbol() == gTrue;
+  checkR->remove();
+
+  return use ? opType : NULL;
+}
+
 //
 // lowerPrimReduce(call), where 'call' is PRIM_REDUCE, converts:
 //   move call_tmp, call
@@ -1502,6 +1537,8 @@ Expr* lowerPrimReduce(CallExpr* call) {
   bool  reqSerial = false; // We may need it for #11819, otherwise remove it.
 
   Expr* opExpr = lowerReduceOp(callStmt, opSE, dataSE, zippered);
+  Symbol* opType = commAllreduceOpType(callStmt, opSE, opExpr,
+                                       dataSE, zippered);
 
   Symbol* result = NULL;
   if (callStmt == call) {
@@ -1514,6 +1551,20 @@ Expr* lowerPrimReduce(CallExpr* call) {
     result = toSymExpr(move->get(1))->symbol();
   }
 
+  if (opType != NULL) {
+    // Leave this to resolution, starting at the no-op.
+    CallExpr* allreduce = new CallExpr(PRIM_MOVE, result,
+                            new CallExpr("chpl__commAllreduce",
+                                         opType, dataSE->symbol()));
+    if (callStmt == call) {
+      callStmt->insertBefore(allreduce);
+      call->replace(new SymExpr(result));
+    } else {
+      callStmt->replace(allreduce);
+    }
+    return noop;
+  }
+
   VarSymbol*       idx  = newTemp("chpl_redIdx");
   ShadowVarSymbol* svar = new ShadowVarSymbol(TFI_REDUCE, "chpl_redSVar",
                                               new SymExpr(result), opExpr);
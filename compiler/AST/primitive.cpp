@@ -926,6 +926,9 @@ initPrimitive() {
   prim_def(PRIM_BLOCK_LOCAL, "local block", returnInfoVoid);
   // BlockStmt::blockInfo - unlocal local block
   prim_def(PRIM_BLOCK_UNLOCAL, "unlocal block", returnInfoVoid);
+  // Marks where a coforall+on task forwards itself to the given locale
+  //   (locale id, locale, index var); replaced by createTaskFunctions
+  prim_def(PRIM_COFORALL_ON_FORWARD, "coforall on forward", returnInfoVoid);
 
   // The arg is an iterator record (or iterator class) temp or iterator call.
   // Indicates whether the iterator has the corresponding leader iterator.
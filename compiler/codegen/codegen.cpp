@@ -35,6 +35,7 @@
 #include "LayeredValueTable.h"
 #include "mli.h"
 #include "mysystem.h"
+#include "objectCache.h"
 #include "passes.h"
 #include "stlUtil.h"
 #include "stmt.h"
@@ -1188,6 +1189,9 @@ static void genFunctionTables() {
 //
 static const char* sCfgFname = "chpl_compilation_config";
 
+// With --incremental, the object files the user modules are compiled to
+static std::vector<const char*> userObjFiles;
+
 static void codegen_header_compilation_config() {
   const bool usingLauncher = 0 != strcmp(CHPL_LAUNCHER, "none");
   // Generate C code only when not in LLVM mode or when using a launcher
@@ -2390,7 +2394,6 @@ void codegen() {
     fprintf(mainfile.fptr, "#include \"%s.c\"\n", sCfgFname);
     fprintf(mainfile.fptr, "#include \"chpl__defn.c\"\n");
 
-    std::vector<const char*> userFileName;
     if(fIncrementalCompilation) {
       ChainHashMap<char*, StringHashFns, int> fileNameHashMap;
       forv_Vec(ModuleSymbol, currentModule, allModules) {
@@ -2403,13 +2406,13 @@ void codegen() {
           char path[FILENAME_MAX];
           strncpy(path, astr(modulefile.pathname), modulePathLen-2);
           path[modulePathLen-2]='\0';
-          userFileName.push_back(astr(path));
+          userObjFiles.push_back(astr(path));
           closeCFile(&modulefile);
         }
       }
     }
     
-    codegen_makefile(&mainfile, NULL, false, userFileName);
+    codegen_makefile(&mainfile, NULL, false, userObjFiles);
   }
 
   if (fLibraryCompile && fLibraryMakefile) {
@@ -2506,7 +2509,25 @@ void makeBinary(void) {
     const char* command = astr(astr(CHPL_MAKE, " "),
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
+
+    // Only the user modules whose objects aren't already cached
+    // need to be compiled.
+    if (fIncrementalCompilation) {
+      std::vector<const char*> toBuild = restoreCachedObjects(userObjFiles);
+      std::string              objs;
+
+      for_vector(const char, objFile, toBuild) {
+        objs += " ";
+        objs += objFile;
+      }
+
+      command = astr(command, " CHPLUSEROBJ_BUILD='", objs.c_str(), "'");
+    }
+
     mysystem(command, "compiling generated source");
+
+    if (fIncrementalCompilation)
+      saveCachedObjects();
   }
 
   if (fLibraryCompile && fLibraryPython) {
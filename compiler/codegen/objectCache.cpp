@@ -0,0 +1,221 @@
+/*
+ * Copyright 2020 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "objectCache.h"
+
+#include "driver.h"
+#include "files.h"
+#include "misc.h"
+#include "stlUtil.h"
+#include "stringutil.h"
+
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// The cache directory actually in use, or NULL if caching is off.
+static const char* cacheDir = NULL;
+
+// The objects that missed in the cache, with their keys, to be saved
+// once they have been compiled.
+static std::vector<std::pair<const char*, std::string> > pendingObjects;
+
+static int numHits   = 0;
+static int numMisses = 0;
+
+static const char* getCacheDir() {
+  if (fIncrementalCacheDir[0] != '\0')
+    return astr(fIncrementalCacheDir);
+
+  if (const char* xdg = getenv("XDG_CACHE_HOME"))
+    if (xdg[0] != '\0')
+      return astr(xdg, "/chpl/incremental");
+
+  if (const char* home = getenv("HOME"))
+    if (home[0] != '\0')
+      return astr(home, "/.cache/chpl/incremental");
+
+  return NULL;
+}
+
+// 64-bit FNV-1a, continued from 'hash'.
+static uint64_t hashBytes(uint64_t hash, const std::string& bytes) {
+  for (size_t i = 0; i < bytes.size(); i++) {
+    hash ^= (unsigned char) bytes[i];
+    hash *= UINT64_C(0x100000001b3);
+  }
+
+  return hash;
+}
+
+static bool readWholeFile(const char* path, std::string& contents) {
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+
+  if (!in)
+    return false;
+
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  contents = ss.str();
+
+  return !in.bad();
+}
+
+static bool copyFile(const char* from, const char* to) {
+  std::ifstream in(from, std::ios::in | std::ios::binary);
+  if (!in)
+    return false;
+
+  std::ofstream out(to, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
+
+  out << in.rdbuf();
+  out.close();
+
+  return !in.bad() && !out.fail();
+}
+
+//
+// Everything, other than the generated code itself, that affects the
+// object a generated C file compiles to.  These are the settings
+// codegen_makefile() passes on to the runtime Makefiles.
+//
+static std::string compileSettings() {
+  std::string settings;
+
+  settings += compileVersion;
+  settings += '\n';
+  settings += CHPL_HOME;
+  settings += '\n';
+  settings += CHPL_RUNTIME_INCL;
+  settings += '\n';
+  settings += genMakefileEnvCache();
+  settings += '\n';
+
+  settings += ccflags;
+  settings += '\n';
+  for_vector(const char, dirName, incDirs) {
+    settings += dirName;
+    settings += '\n';
+  }
+
+  settings += istr(ccwarnings);
+  settings += istr(debugCCode);
+  settings += istr(optimizeCCode);
+  settings += istr(specializeCCode);
+  settings += istr(ffloatOpt);
+  settings += istr(fLibraryCompile);
+  settings += istr(fLinkStyle);
+
+  return settings;
+}
+
+std::vector<const char*>
+restoreCachedObjects(const std::vector<const char*>& objFiles) {
+  std::vector<const char*> toBuild;
+  std::string              settings;
+  std::string              header;
+
+  cacheDir = getCacheDir();
+
+  if (cacheDir == NULL ||
+      readWholeFile(genIntermediateFilename("chpl__header.h"),
+                    header) == false) {
+    cacheDir = NULL;
+    return objFiles;
+  }
+
+  ensureDirExists(cacheDir, "creating incremental compilation cache");
+
+  settings = compileSettings();
+
+  for_vector(const char, objFile, objFiles) {
+    std::string source;
+    uint64_t    hash = UINT64_C(0xcbf29ce484222325);
+    char        key[32];
+
+    if (readWholeFile(astr(objFile, ".c"), source) == false) {
+      toBuild.push_back(objFile);
+      continue;
+    }
+
+    hash = hashBytes(hash, settings);
+    hash = hashBytes(hash, header);
+    hash = hashBytes(hash, source);
+
+    snprintf(key, sizeof(key), "%016" PRIx64, hash);
+
+    const char* cachedFile = astr(cacheDir, "/", key, ".o");
+
+    if (copyFile(cachedFile, objFile) == true) {
+      numHits++;
+
+    } else {
+      numMisses++;
+      pendingObjects.push_back(std::make_pair(objFile, std::string(key)));
+      toBuild.push_back(objFile);
+    }
+  }
+
+  return toBuild;
+}
+
+void saveCachedObjects() {
+  if (cacheDir != NULL) {
+    for (size_t i = 0; i < pendingObjects.size(); i++) {
+      const char* objFile    = pendingObjects[i].first;
+      const char* key        = pendingObjects[i].second.c_str();
+      const char* cachedFile = astr(cacheDir, "/", key, ".o");
+      const char* tmpFile    = astr(cachedFile, ".tmp", istr(getpid()));
+
+      // Copy then rename, so that a concurrent compile never sees a
+      // partly written object.  Failing to save one is not an error;
+      // that module will just be compiled again next time.
+      if (copyFile(objFile, tmpFile) == false ||
+          rename(tmpFile, cachedFile) != 0) {
+        remove(tmpFile);
+      }
+    }
+  }
+
+  if (printPasses == true || printPassesFile != NULL) {
+    char text[128];
+
+    snprintf(text, sizeof(text), "%32s : %d hit%s, %d miss%s\n",
+             "incremental object cache",
+             numHits, numHits == 1 ? "" : "s",
+             numMisses, numMisses == 1 ? "" : "es");
+
+    if (printPasses == true)
+      fputs(text, stderr);
+
+    if (printPassesFile != NULL)
+      fputs(text, printPassesFile);
+  }
+
+  pendingObjects.clear();
+}
@@ -24,6 +24,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class astlocT;
@@ -118,7 +119,7 @@ private:
 
   typedef std::set<const ResolveScope*>  ScopeSet;
 
-  typedef std::map<const char*, Symbol*> Bindings;
+  typedef std::unordered_map<const char*, Symbol*> Bindings;
   typedef std::map<Symbol*, UseImportList> UseImportMap;
 
                         ResolveScope();
@@ -269,6 +269,10 @@ public:
 
   static  const       std::string tabText;
 
+  // AST nodes are allocated from arenas; see baseAST.cpp
+  static void*      operator new(size_t size);
+  static void       operator delete(void* ptr, size_t size);
+
 protected:
                     BaseAST(AstTag type);
   virtual          ~BaseAST();
@@ -286,6 +290,10 @@ GenRet baseASTCodegenString(const char* str);
 // get the current AST node id
 int    lastNodeIDUsed();
 
+// bytes of memory held by live AST nodes, and reserved for them
+size_t astBytesInUse();
+size_t astBytesReserved();
+
 // trace various AST node removals
 void   trace_remove(BaseAST* ast, char flag);
 
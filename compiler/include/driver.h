@@ -55,6 +55,7 @@ extern bool fNoDivZeroChecks;
 extern bool fMungeUserIdents;
 extern bool fEnableTaskTracking;
 extern bool fLLVMWideOpt;
+extern int fLLVMJobs;
 
 extern bool fAutoLocalAccess;
 extern bool fAutoLocalAccessDynamic;
@@ -132,6 +133,7 @@ extern const char* CHPL_LLVM_UNIQ_CFG_PATH;
 
 extern bool  printPasses;
 extern FILE* printPassesFile;
+extern bool  printPassesMemory;
 
 extern char fExplainCall[256];
 extern int  explainCallID;
@@ -244,6 +246,7 @@ extern bool fMinimalModules;
 
 // Set to true if we want to enable incremental compilation.
 extern bool fIncrementalCompilation;
+extern char fIncrementalCacheDir[FILENAME_MAX+1];
 
 // LLVM flags (-mllvm)
 extern std::string llvmFlags;
@@ -45,6 +45,8 @@ struct fileinfo {
   const char* pathname;
 };
 
+std::string genMakefileEnvCache(void);
+
 void codegen_makefile(fileinfo* mainfile, const char** tmpbinname=NULL, bool skip_compile_link=false, const std::vector<const char *>& splitFiles = std::vector<const char*>());
 
 void ensureDirExists(const char* /* dirname */, const char* /* explanation */);
@@ -83,6 +83,7 @@ symbolFlag( FLAG_COERCE_TEMP , npr, "coerce temp" , "a temporary that was stores
 symbolFlag( FLAG_COERCE_FN,  ypr, "coerce fn" , "coerce copy/move function" )
 symbolFlag( FLAG_CODEGENNED , npr, "codegenned" , "code has been generated for this type" )
 symbolFlag( FLAG_COFORALL_INDEX_VAR , npr, "coforall index var" , ncm )
+symbolFlag( FLAG_COFORALL_ON_TREE , npr, "coforall on tree" , "coforall+on task function started down a tree of locales, or the function that starts it on the child locales" )
 symbolFlag( FLAG_COMMAND_LINE_SETTING , ypr, "command line setting" , ncm )
 // The compiler-generated flag has these meanings:
 // 1. In various parts of the compiler, when printing filename/lineno
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LLVM_SPLIT_MODULE_
+#define _LLVM_SPLIT_MODULE_
+
+#ifdef HAVE_LLVM
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace llvm
+{
+  class Function;
+  class Module;
+}
+
+// Split M into (at most) numParts modules that can be optimized and
+// compiled to separate object files, then linked back together.
+//
+// 'order' lists the function definitions to be divided up, in the order
+// they should be kept together (e.g. grouped by Chapel module).  They
+// are cut into runs of roughly equal size, one per partition.  Other
+// definitions that are cheap to duplicate (local or linkonce functions
+// whose address is not taken, and unnamed_addr constants) are copied
+// into each partition that refers to them, so that they can still be
+// inlined there.  Everything else goes in partition 0.  Local symbols
+// referred to from another partition are made hidden and external.
+//
+// M is modified (by that last step) but otherwise left intact.
+// partCallback is called with each partition in turn.  Partitions other
+// than 0 are skipped if they would be empty.
+void splitModuleLLVM(llvm::Module& M,
+                     unsigned numParts,
+                     const std::vector<llvm::Function*>& order,
+                     std::function<void(unsigned partNum,
+                                        std::unique_ptr<llvm::Module> part)>
+                       partCallback);
+
+#endif // end HAVE_LLVM
+
+#endif
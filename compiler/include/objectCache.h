@@ -0,0 +1,42 @@
+/*
+ * Copyright 2020 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OBJECT_CACHE_H_
+#define _OBJECT_CACHE_H_
+
+#include <vector>
+
+//
+// With --incremental, each user module's generated C is compiled to its
+// own object file.  These objects are kept in an on-disk cache keyed by
+// a hash of the generated code, the header it includes, and everything
+// else that goes into compiling it (flags, target, compiler version), so
+// that modules whose generated code has not changed since an earlier
+// compile do not have to be compiled again.
+//
+// objFiles are the object files to be built, each from the .c file of
+// the same name.  restoreCachedObjects() copies in the ones found in
+// the cache and returns the rest, which the caller should compile.
+// After they have been, saveCachedObjects() adds them to the cache.
+//
+std::vector<const char*> restoreCachedObjects(const std::vector<const char*>& objFiles);
+void                     saveCachedObjects();
+
+#endif
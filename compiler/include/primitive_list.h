@@ -192,6 +192,7 @@
   PRIMITIVE_R(PRIM_BLOCK_COFORALL_ON)
   PRIMITIVE_R(PRIM_BLOCK_LOCAL)
   PRIMITIVE_R(PRIM_BLOCK_UNLOCAL)
+  PRIMITIVE_R(PRIM_COFORALL_ON_FORWARD)
 
   PRIMITIVE_R(PRIM_HAS_LEADER)
   PRIMITIVE_R(PRIM_TO_LEADER)
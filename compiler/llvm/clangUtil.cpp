@@ -30,6 +30,7 @@
 #include <cstring>
 #include <cstdio>
 #include <sstream>
+#include <thread>
 
 #ifdef HAVE_LLVM
 #include "clang/AST/GlobalDecl.h"
@@ -56,6 +57,7 @@
 
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
@@ -98,6 +100,7 @@
 #include "build.h"
 
 #include "llvmDebug.h"
+#include "llvmSplitModule.h"
 #include "llvmVer.h"
 
 #include "../ifa/prim_data.h"
@@ -3194,6 +3197,189 @@ static std::string getLibraryOutputPath();
 static void moveGeneratedLibraryFile(const char* tmpbinname);
 static void moveResultFromTmp(const char* resultName, const char* tmpbinname);
 
+// Add the passes to emit a .o file for 'mod' to 'out', and run them.
+static void emitObjectFileLLVM(llvm::TargetMachine* targetMachine,
+                               llvm::Module& mod,
+                               llvm::raw_pwrite_stream& out) {
+  llvm::legacy::PassManager emitPM;
+
+  emitPM.add(createTargetTransformInfoWrapperPass(
+             targetMachine->getTargetIRAnalysis()));
+
+#if HAVE_LLVM_VER >= 100
+  llvm::CodeGenFileType FileType = llvm::CGFT_ObjectFile;
+#else
+  llvm::TargetMachine::CodeGenFileType FileType =
+    llvm::TargetMachine::CGFT_ObjectFile;
+#endif
+
+  bool disableVerify = ! developer;
+#if HAVE_LLVM_VER > 60
+  targetMachine->addPassesToEmitFile(emitPM, out,
+                                     nullptr,
+                                     FileType,
+                                     disableVerify);
+#else
+  targetMachine->addPassesToEmitFile(emitPM, out,
+                                     FileType,
+                                     disableVerify);
+#endif
+
+  // Run the passes to emit the .o file now!
+  emitPM.run(mod);
+}
+
+// One piece of the program, for --llvm-jobs.  It is handed to its
+// thread as bitcode, since each thread needs its own LLVMContext.
+struct LLVMPartition {
+  std::string bitcode;
+  std::string objFilename;
+  std::string optFilename;  // save optimized bitcode here, if set
+  std::string error;
+};
+
+// Optimize one partition and emit its .o file.  This runs on its own
+// thread, so it must not touch the AST or report errors directly.
+static void optimizeAndEmitPartition(LLVMPartition* part,
+                                     const llvm::TargetMachine* protoTM) {
+  llvm::LLVMContext ctx;
+
+  llvm::MemoryBufferRef buf(part->bitcode, part->objFilename);
+  llvm::Expected<std::unique_ptr<llvm::Module> > modOrErr =
+    llvm::parseBitcodeFile(buf, ctx);
+  if (!modOrErr) {
+    part->error = llvm::toString(modOrErr.takeError());
+    return;
+  }
+  std::unique_ptr<llvm::Module> mod = std::move(*modOrErr);
+
+  // TargetMachines can't be shared between threads, so make our own.
+  std::unique_ptr<llvm::TargetMachine> targetMachine(
+    protoTM->getTarget().createTargetMachine(
+      protoTM->getTargetTriple().str(),
+      protoTM->getTargetCPU(),
+      protoTM->getTargetFeatureString(),
+      protoTM->Options,
+      protoTM->getRelocationModel(),
+      protoTM->getCodeModel(),
+      protoTM->getOptLevel()));
+
+  {
+    PassManagerBuilder PMBuilder;
+    configurePMBuilder(PMBuilder, /* for function passes */ false);
+
+    llvm::legacy::PassManager mpm;
+    mpm.add(createTargetTransformInfoWrapperPass(
+            targetMachine->getTargetIRAnalysis()));
+    Triple TargetTriple(mod->getTargetTriple());
+    llvm::TargetLibraryInfoImpl TLII(TargetTriple);
+    mpm.add(new TargetLibraryInfoWrapperPass(TLII));
+
+    PMBuilder.populateModulePassManager(mpm);
+    mpm.run(*mod);
+  }
+
+  if (!part->optFilename.empty()) {
+    std::error_code tmpErr;
+    ToolOutputFile output(part->optFilename.c_str(),
+                          tmpErr, sys::fs::F_None);
+    if (tmpErr) {
+      part->error = "could not open output file " + part->optFilename;
+      return;
+    }
+#if HAVE_LLVM_VER < 70
+    WriteBitcodeToFile(mod.get(), output.os());
+#else
+    WriteBitcodeToFile(*mod, output.os());
+#endif
+    output.keep();
+    output.os().flush();
+  }
+
+  std::error_code error;
+  llvm::raw_fd_ostream outputOfile(part->objFilename, error,
+                                   llvm::sys::fs::F_None);
+  if (error || outputOfile.has_error()) {
+    part->error = "could not open output file " + part->objFilename;
+    return;
+  }
+
+  emitObjectFileLLVM(targetMachine.get(), *mod, outputOfile);
+  outputOfile.close();
+}
+
+// Split the module into numParts pieces, keeping the functions from
+// each Chapel module together where possible, then optimize them and
+// emit a .o file for each on numParts threads.  The .o file for the
+// first piece is moduleFilename; the names of the others are returned.
+static std::vector<std::string>
+optimizeAndEmitPartitions(unsigned numParts, std::string moduleFilename) {
+  GenInfo* info = gGenInfo;
+
+  std::map<ModuleSymbol*, std::vector<llvm::Function*> > fnsByModule;
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    llvm::Function* func = info->module->getFunction(fn->cname);
+    if (func != NULL && !func->isDeclaration())
+      fnsByModule[fn->getModule()].push_back(func);
+  }
+
+  std::vector<llvm::Function*> order;
+  std::set<llvm::Function*> inOrder;
+  forv_Vec(ModuleSymbol, mod, allModules) {
+    for (llvm::Function* func : fnsByModule[mod])
+      if (inOrder.insert(func).second)
+        order.push_back(func);
+  }
+
+  std::vector<LLVMPartition> parts(numParts);
+
+  splitModuleLLVM(*info->module, numParts, order,
+                  [&](unsigned partNum, std::unique_ptr<llvm::Module> partM) {
+    llvm::raw_string_ostream os(parts[partNum].bitcode);
+#if HAVE_LLVM_VER < 70
+    WriteBitcodeToFile(partM.get(), os);
+#else
+    WriteBitcodeToFile(*partM, os);
+#endif
+    os.flush();
+  });
+
+  std::vector<std::string> otherOFiles;
+  std::vector<std::thread> threads;
+
+  for (unsigned i = 0; i < numParts; i++) {
+    LLVMPartition& part = parts[i];
+    if (part.bitcode.empty())
+      continue;
+
+    if (i == 0) {
+      part.objFilename = moduleFilename;
+    } else {
+      part.objFilename =
+        genIntermediateFilename(astr("chpl__module-", istr(i), ".o"));
+      otherOFiles.push_back(part.objFilename);
+    }
+
+    if (saveCDir[0] != '\0')
+      part.optFilename =
+        genIntermediateFilename(astr("chpl__module-opt1-", istr(i), ".bc"));
+
+    threads.push_back(std::thread(optimizeAndEmitPartition,
+                                  &part, info->targetMachine));
+  }
+
+  for (std::thread& t : threads)
+    t.join();
+
+  for (LLVMPartition& part : parts) {
+    if (!part.error.empty())
+      USR_FATAL("LLVM code generation failed for %s: %s",
+                part.objFilename.c_str(), part.error.c_str());
+  }
+
+  return otherOFiles;
+}
+
 void makeBinaryLLVM(void) {
 
   GenInfo* info = gGenInfo;
@@ -3238,13 +3424,16 @@ void makeBinaryLLVM(void) {
 #endif
 
 
-  // Open the output file
-  std::error_code error;
-  llvm::sys::fs::OpenFlags flags = llvm::sys::fs::F_None;
-
-  llvm::raw_fd_ostream outputOfile(moduleFilename, error, flags);
-  if (error || outputOfile.has_error())
-    USR_FATAL("Could not open output file %s", moduleFilename.c_str());
+  // With --llvm-jobs, optimize and emit the module in pieces, in
+  // parallel.  The wide pointer optimization and printing IR by stage
+  // need the whole module, so they are only done serially.
+  unsigned numPartitions = 1;
+  if (fLLVMJobs != 1 && !fLLVMWideOpt &&
+      (llvmPrintIrStageNum == llvmStageNum::NOPRINT ||
+       llvmPrintIrStageNum == llvmStageNum::NONE)) {
+    numPartitions = (fLLVMJobs > 0) ? fLLVMJobs
+                                    : std::thread::hardware_concurrency();
+  }
 
   static bool addedGlobalExts = false;
   if( ! addedGlobalExts ) {
@@ -3296,7 +3485,8 @@ void makeBinaryLLVM(void) {
   }
 
   // Setup for and run LLVM optimization passes
-  {
+  // (for more than one partition this is done on each one, below)
+  if (numPartitions <= 1) {
     adjustLayoutForGlobalToWide();
 
     llvm::legacy::PassManager mpm;
@@ -3395,35 +3585,22 @@ void makeBinaryLLVM(void) {
         == llvm::Reloc::Model::PIC_);
   }
 
-  // Emit the .o file for linking with clang
-  // Setup and run LLVM passes to emit a .o file to outputOfile
-  {
-    llvm::legacy::PassManager emitPM;
-
-    emitPM.add(createTargetTransformInfoWrapperPass(
-               info->targetMachine->getTargetIRAnalysis()));
+  // Emit the .o file(s) for linking with clang
+  std::vector<std::string> partitionOFiles;
 
-#if HAVE_LLVM_VER >= 100
-    llvm::CodeGenFileType FileType = llvm::CGFT_ObjectFile;
-#else
-    llvm::TargetMachine::CodeGenFileType FileType =
-      llvm::TargetMachine::CGFT_ObjectFile;
-#endif
+  if (numPartitions > 1) {
+    partitionOFiles = optimizeAndEmitPartitions(numPartitions,
+                                                moduleFilename);
+  } else {
+    // Open the output file
+    std::error_code error;
+    llvm::sys::fs::OpenFlags flags = llvm::sys::fs::F_None;
 
-    bool disableVerify = ! developer;
-#if HAVE_LLVM_VER > 60
-    info->targetMachine->addPassesToEmitFile(emitPM, outputOfile,
-                                             nullptr,
-                                             FileType,
-                                             disableVerify);
-#else
-    info->targetMachine->addPassesToEmitFile(emitPM, outputOfile,
-                                             FileType,
-                                             disableVerify);
-#endif
+    llvm::raw_fd_ostream outputOfile(moduleFilename, error, flags);
+    if (error || outputOfile.has_error())
+      USR_FATAL("Could not open output file %s", moduleFilename.c_str());
 
-    // Run the passes to emit the .o file now!
-    emitPM.run(*info->module);
+    emitObjectFileLLVM(info->targetMachine, *info->module, outputOfile);
     outputOfile.close();
   }
 
@@ -3524,7 +3701,7 @@ void makeBinaryLLVM(void) {
     useLinkCXX = ldOverride[0];
 
 
-  std::vector<std::string> dotOFiles;
+  std::vector<std::string> dotOFiles(partitionOFiles);
 
   // Gather C flags for compiling C files.
   std::string cargs;
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2020 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "llvmSplitModule.h"
+
+#ifdef HAVE_LLVM
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalAlias.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+#include "llvmUtil.h"
+
+using namespace llvm;
+
+typedef SmallPtrSet<const GlobalValue*, 16> GlobalValueSet;
+
+// Can this definition be copied into every partition that uses it,
+// rather than living in just one?
+static bool isCopyable(const GlobalValue* GV,
+                       const GlobalValueSet& ordered) {
+  if (GV->isDeclaration())
+    return false;
+
+  if (!GV->hasLocalLinkage() &&
+      !GV->hasLinkOnceLinkage() &&
+      !GV->hasAvailableExternallyLinkage())
+    return false;
+
+  if (const Function* F = dyn_cast<Function>(GV)) {
+    // Functions being divided up are only copied if they are sure to be
+    // inlined; copies of functions whose address is taken would compare
+    // unequal.
+    if (ordered.count(F) && !F->hasFnAttribute(Attribute::AlwaysInline))
+      return false;
+    return !F->hasAddressTaken();
+  }
+
+  if (const GlobalVariable* V = dyn_cast<GlobalVariable>(GV))
+    return V->isConstant() && V->hasGlobalUnnamedAddr();
+
+  return false;
+}
+
+// Gather the globals a definition refers to, directly or through
+// constant expressions.
+static void collectReferences(const GlobalValue* GV,
+                              SmallVectorImpl<const GlobalValue*>& refs) {
+  SmallVector<const Constant*, 64> worklist;
+  SmallPtrSet<const Constant*, 32> visited;
+
+  auto push = [&](const Value* V) {
+    if (const Constant* C = dyn_cast<Constant>(V))
+      if (visited.insert(C).second)
+        worklist.push_back(C);
+  };
+
+  if (const Function* F = dyn_cast<Function>(GV)) {
+    for (const BasicBlock& BB : *F)
+      for (const Instruction& I : BB)
+        for (const Value* Op : I.operands())
+          push(Op);
+    if (F->hasPersonalityFn())
+      push(F->getPersonalityFn());
+    if (F->hasPrefixData())
+      push(F->getPrefixData());
+    if (F->hasPrologueData())
+      push(F->getPrologueData());
+  } else if (const GlobalVariable* V = dyn_cast<GlobalVariable>(GV)) {
+    if (V->hasInitializer())
+      push(V->getInitializer());
+  } else if (const GlobalAlias* A = dyn_cast<GlobalAlias>(GV)) {
+    push(A->getAliasee());
+  }
+
+  while (!worklist.empty()) {
+    const Constant* C = worklist.pop_back_val();
+    if (const GlobalValue* G = dyn_cast<GlobalValue>(C)) {
+      if (G != GV)
+        refs.push_back(G);
+      continue;
+    }
+    for (const Value* Op : C->operands())
+      push(Op);
+  }
+}
+
+static size_t functionSize(const Function* F) {
+  size_t size = 1;
+  for (const BasicBlock& BB : *F)
+    size += BB.size();
+  return size;
+}
+
+void splitModuleLLVM(Module& M,
+                     unsigned numParts,
+                     const std::vector<Function*>& order,
+                     std::function<void(unsigned partNum,
+                                        std::unique_ptr<Module> part)>
+                       partCallback) {
+  if (numParts < 1)
+    numParts = 1;
+
+  GlobalValueSet ordered;
+  for (Function* F : order)
+    ordered.insert(F);
+
+  // Decide which partition owns each definition that is not copyable.
+  // The ordered functions are cut into runs of about equal size; the
+  // rest go in partition 0.
+  DenseMap<const GlobalValue*, unsigned> owner;
+  std::vector<std::vector<const GlobalValue*> > owned(numParts);
+
+  auto own = [&](const GlobalValue* GV, unsigned part) {
+    if (GV->isDeclaration() || isCopyable(GV, ordered) || owner.count(GV))
+      return;
+    owner[GV] = part;
+    owned[part].push_back(GV);
+  };
+
+  size_t totalSize = 0;
+  for (Function* F : order)
+    totalSize += functionSize(F);
+
+  size_t sizeSoFar = 0;
+  for (Function* F : order) {
+    unsigned part = (unsigned) ((sizeSoFar * numParts) / (totalSize + 1));
+    own(F, part);
+    sizeSoFar += functionSize(F);
+  }
+
+  for (const Function& F : M)
+    own(&F, 0);
+  for (const GlobalVariable& V : M.globals())
+    own(&V, 0);
+  for (const GlobalAlias& A : M.aliases())
+    own(&A, 0);
+
+  // Find what each partition needs: what it owns, plus the copyable
+  // definitions those refer to, transitively.  Note the owned local
+  // symbols that are referred to from outside their partition.
+  DenseMap<const GlobalValue*, SmallVector<const GlobalValue*, 8> > refsOf;
+  std::vector<GlobalValueSet> inPart(numParts);
+  SetVector<GlobalValue*> toExternalize;
+
+  for (unsigned part = 0; part < numParts; part++) {
+    std::vector<const GlobalValue*> worklist(owned[part]);
+    inPart[part].insert(owned[part].begin(), owned[part].end());
+
+    while (!worklist.empty()) {
+      const GlobalValue* GV = worklist.back();
+      worklist.pop_back();
+
+      auto it = refsOf.find(GV);
+      if (it == refsOf.end()) {
+        it = refsOf.insert(std::make_pair(GV,
+                             SmallVector<const GlobalValue*, 8>())).first;
+        collectReferences(GV, it->second);
+      }
+
+      for (const GlobalValue* ref : it->second) {
+        if (ref->isDeclaration())
+          continue;
+        if (isCopyable(ref, ordered)) {
+          if (inPart[part].insert(ref).second)
+            worklist.push_back(ref);
+        } else {
+          auto o = owner.find(ref);
+          unsigned refPart = (o == owner.end()) ? 0 : o->second;
+          if (refPart != part)
+            toExternalize.insert(const_cast<GlobalValue*>(ref));
+        }
+      }
+    }
+  }
+
+  for (GlobalValue* GV : toExternalize) {
+    if (GV->hasLocalLinkage()) {
+      GV->setLinkage(GlobalValue::ExternalLinkage);
+      GV->setVisibility(GlobalValue::HiddenVisibility);
+      if (!GV->hasName())
+        GV->setName("chpl__split");
+    } else if (GV->hasLinkOnceLinkage()) {
+      // Don't let the owning partition drop it if it is unused there.
+      GV->setLinkage(GV->hasLinkOnceODRLinkage()
+                     ? GlobalValue::WeakODRLinkage
+                     : GlobalValue::WeakAnyLinkage);
+    }
+  }
+
+  for (unsigned part = 0; part < numParts; part++) {
+    if (owned[part].empty() && part != 0)
+      continue;
+
+    const GlobalValueSet& defs = inPart[part];
+    ValueToValueMapTy VMap;
+#if HAVE_LLVM_VER < 70
+    std::unique_ptr<Module> partM =
+      CloneModule(&M, VMap, [&](const GlobalValue* GV) {
+                              return defs.count(GV) > 0; });
+#else
+    std::unique_ptr<Module> partM =
+      CloneModule(M, VMap, [&](const GlobalValue* GV) {
+                             return defs.count(GV) > 0; });
+#endif
+
+    // CloneModule leaves a declaration for each definition it didn't
+    // copy.  That is fine except for the special appending globals
+    // (llvm.used etc.), which only partition 0 has.
+    if (part != 0) {
+      for (const GlobalVariable& V : M.globals()) {
+        if (V.hasAppendingLinkage()) {
+          GlobalVariable* copy = partM->getNamedGlobal(V.getName());
+          if (copy && copy->use_empty())
+            copy->eraseFromParent();
+        }
+      }
+    }
+
+    partCallback(part, std::move(partM));
+  }
+}
+
+#endif // end HAVE_LLVM
@@ -27,6 +27,8 @@
 #include <cstring>
 #include <algorithm>
 
+#include <sys/resource.h>
+
 // Used to collect the times as the program runs
 class Phase
 {
@@ -102,6 +104,10 @@ static void PassesReport(FILE*                    fp,
                          const std::vector<Pass>& passes,
                          unsigned long            totalTime);
 
+static void          ResetPeakMemory();
+static unsigned long PeakMemory();
+static unsigned long sPeakMemory = 0;
+
 /************************************* | **************************************
 *                                                                             *
 * Implementation of PhaseTracker                                              *
@@ -144,6 +150,9 @@ void PhaseTracker::StartPhase(const char* name,
   Phase* phase = new Phase(name, passId, subPhase, mTimer.elapsedUsecs());
 
   mPhases.push_back(phase);
+
+  if (subPhase == kPrimary && printPassesMemory == true)
+    ResetPeakMemory();
 }
 
 void PhaseTracker::Stop()
@@ -318,12 +327,36 @@ void Phase::ReportPass(unsigned long now) const
     ReportText(text);
   }
 
+  if (printPassesMemory == true)
+  {
+    char text[64];
+
+    snprintf(text, sizeof(text), "  peak %8.1f MiB  AST %8.1f MiB",
+             PeakMemory()    / (1024.0 * 1024.0),
+             astBytesInUse() / (1024.0 * 1024.0));
+
+    ReportText(text);
+  }
+
   ReportText("\n");
 }
 
 void Phase::ReportTotal(unsigned long totalTime)
 {
   ReportTime("total time", totalTime / 1e6);
+
+  if (printPassesMemory == true)
+  {
+    char text[64];
+
+    PeakMemory();
+
+    snprintf(text, sizeof(text), "  peak %8.1f MiB",
+             sPeakMemory / (1024.0 * 1024.0));
+
+    ReportText(text);
+  }
+
   ReportText("\n\n\n\n");
 }
 
@@ -457,5 +490,67 @@ void Pass::Footer(FILE*         fp,
           totalTime / 1e6);
 }
 
+/************************************* | **************************************
+*                                                                             *
+* Peak memory use.  On Linux the peak resident set size can be reset at the   *
+* start of each pass, so that the peak reported for a pass is the peak        *
+* during that pass.  Elsewhere it is the peak since the compiler started.     *
+* sPeakMemory tracks the peak over the whole compilation.                     *
+*                                                                             *
+************************************** | *************************************/
+
+static void ResetPeakMemory()
+{
+  PeakMemory();
+
+#ifdef __linux__
+  if (FILE* fp = fopen("/proc/self/clear_refs", "w"))
+  {
+    fputs("5", fp);
+    fclose(fp);
+  }
+#endif
+}
+
+// In bytes
+static unsigned long PeakMemory()
+{
+  unsigned long retval = 0;
+
+#ifdef __linux__
+  if (FILE* fp = fopen("/proc/self/status", "r"))
+  {
+    char line[256];
 
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+      if (strncmp(line, "VmHWM:", 6) == 0)
+      {
+        retval = strtoul(line + 6, NULL, 10) * 1024;
+        break;
+      }
+    }
 
+    fclose(fp);
+  }
+#endif
+
+  if (retval == 0)
+  {
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+      retval = usage.ru_maxrss;
+#else
+      retval = usage.ru_maxrss * 1024UL;
+#endif
+    }
+  }
+
+  if (retval > sPeakMemory)
+    sPeakMemory = retval;
+
+  return retval;
+}
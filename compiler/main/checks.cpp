@@ -644,6 +644,7 @@ checkTaskRemovedPrims()
        case PRIM_BLOCK_BEGIN_ON:
        case PRIM_BLOCK_COBEGIN_ON:
        case PRIM_BLOCK_COFORALL_ON:
+       case PRIM_COFORALL_ON_FORWARD:
         if (call->parentSymbol)
           INT_FATAL("Primitive should no longer be in AST");
         break;
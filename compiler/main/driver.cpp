@@ -165,12 +165,16 @@ bool fAutoLocalAccess = true;
 bool fAutoLocalAccessDynamic = true;
 bool fReportAutoLocalAccess= false;
 
-bool  printPasses     = false;
-FILE* printPassesFile = NULL;
+bool  printPasses       = false;
+FILE* printPassesFile   = NULL;
+bool  printPassesMemory = false;
 
 // flag for llvmWideOpt
 bool fLLVMWideOpt = false;
 
+// threads for LLVM optimization and code generation (0 for one per core)
+int fLLVMJobs = 1;
+
 bool fWarnConstLoops = true;
 bool fWarnUnstable = false;
 
@@ -189,6 +193,7 @@ bool fNoRemoveEmptyRecords = true;
 bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fIncrementalCompilation = false;
+char fIncrementalCacheDir[FILENAME_MAX + 1] = "";
 bool fNoOptimizeForallUnordered = false;
 
 int optimize_on_clause_limit = 20;
@@ -989,6 +994,7 @@ static ArgumentDescription arg_desc[] = {
 
  {"", ' ', NULL, "LLVM Code Generation Options", NULL, NULL, NULL, NULL},
  {"llvm", ' ', NULL, "[Don't] use the LLVM code generator", "N", &fYesLlvmCodegen, "CHPL_LLVM_CODEGEN", setLlvmCodegen},
+ {"llvm-jobs", ' ', "<n>", "Optimize and generate code for LLVM in parallel on <n> threads, 0 for one per core", "I", &fLLVMJobs, "CHPL_LLVM_JOBS", NULL},
  {"llvm-wide-opt", ' ', NULL, "Enable [disable] LLVM wide pointer optimizations", "N", &fLLVMWideOpt, "CHPL_LLVM_WIDE_OPTS", NULL},
  {"mllvm", ' ', "<flags>", "LLVM flags (can be specified multiple times)", "S", NULL, "CHPL_MLLVM", setLLVMFlags},
 
@@ -996,6 +1002,7 @@ static ArgumentDescription arg_desc[] = {
  {"print-commands", ' ', NULL, "[Don't] print system commands", "N", &printSystemCommands, "CHPL_PRINT_COMMANDS", NULL},
  {"print-passes", ' ', NULL, "[Don't] print compiler passes", "N", &printPasses, "CHPL_PRINT_PASSES", NULL},
  {"print-passes-file", ' ', "<filename>", "Print compiler passes to <filename>", "S", NULL, "CHPL_PRINT_PASSES_FILE", setPrintPassesFile},
+ {"print-passes-memory", ' ', NULL, "[Don't] print peak memory use with compiler passes", "N", &printPassesMemory, "CHPL_PRINT_PASSES_MEMORY", NULL},
 
  {"", ' ', NULL, "Miscellaneous Options", NULL, NULL, NULL, NULL},
  DRIVER_ARG_DEVELOPER,
@@ -1128,6 +1135,7 @@ static ArgumentDescription arg_desc[] = {
  {"remove-unreachable-blocks", ' ', NULL, "[Don't] remove unreachable blocks after resolution", "N", &fRemoveUnreachableBlocks, "CHPL_REMOVE_UNREACHABLE_BLOCKS", NULL},
  {"replace-array-accesses-with-ref-temps", ' ', NULL, "Enable [disable] replacing array accesses with reference temps (experimental)", "N", &fReplaceArrayAccessesWithRefTemps, NULL, NULL },
  {"incremental", ' ', NULL, "Enable [disable] using incremental compilation", "N", &fIncrementalCompilation, "CHPL_INCREMENTAL_COMP", NULL},
+ {"incremental-cache-dir", ' ', "<directory>", "Cache objects compiled with --incremental in directory", "P", fIncrementalCacheDir, "CHPL_INCREMENTAL_CACHE_DIR", NULL},
  {"minimal-modules", ' ', NULL, "Enable [disable] using minimal modules",               "N", &fMinimalModules, "CHPL_MINIMAL_MODULES", NULL},
  {"print-chpl-settings", ' ', NULL, "Print current chapel settings and exit", "F", &fPrintChplSettings, NULL,NULL},
  {"stop-after-pass", ' ', "<passname>", "Stop compilation after reaching this pass", "S128", &stopAfterPass, "CHPL_STOP_AFTER_PASS", NULL},
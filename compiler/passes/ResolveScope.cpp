@@ -55,7 +55,7 @@
 
 ResolveScope* rootScope;
 
-static std::map<BaseAST*, ResolveScope*> sScopeMap;
+static std::unordered_map<BaseAST*, ResolveScope*> sScopeMap;
 
 ResolveScope* ResolveScope::getRootModule() {
   ResolveScope* retval = new ResolveScope(theProgram, NULL);
@@ -102,7 +102,7 @@ ResolveScope* ResolveScope::findOrCreateScopeFor(DefExpr* def) {
 }
 
 ResolveScope* ResolveScope::getScopeFor(BaseAST* ast) {
-  std::map<BaseAST*, ResolveScope*>::iterator it;
+  std::unordered_map<BaseAST*, ResolveScope*>::iterator it;
   ResolveScope*                               retval = NULL;
 
   it = sScopeMap.find(ast);
@@ -115,7 +115,7 @@ ResolveScope* ResolveScope::getScopeFor(BaseAST* ast) {
 }
 
 void ResolveScope::destroyAstMap() {
-  std::map<BaseAST*, ResolveScope*>::iterator it;
+  std::unordered_map<BaseAST*, ResolveScope*>::iterator it;
 
   for (it = sScopeMap.begin(); it != sScopeMap.end(); it++) {
     delete it->second;
@@ -664,6 +664,89 @@ static void replaceVarUses(Expr* topAst, SymbolMap& vars) {
   }
 }
 
+//
+// A coforall+on lowered as a tree (see buildTreeCoforallOn()) has its
+// task forward itself to its children in the tree.  Replace each
+// PRIM_COFORALL_ON_FORWARD(localeID, loc, index) in the on_fn with a
+// call that starts the on_fn again, passing along its own formals except
+// for the target locale, which is 'localeID', and the coforall index,
+// which is 'loc'.  'call' is the one that starts the on_fn from the
+// coforall loop.
+//
+// The call goes through a plain function rather than being made from the
+// on_fn directly, because the passes that traverse into task functions
+// from their call sites do not expect a task function to call itself.
+//
+static FnSymbol* buildCoforallOnForwardFn(FnSymbol* fn) {
+  FnSymbol* fwdFn = new FnSymbol("coforall_on_fwd_fn");
+  CallExpr* call  = new CallExpr(fn);
+
+  fwdFn->addFlag(FLAG_COMPILER_GENERATED);
+  fwdFn->addFlag(FLAG_COFORALL_ON_TREE);
+
+  for_formals(formal, fn) {
+    Type*      type = formal->type == dtUnknown ? dtAny : formal->type;
+    ArgSymbol* arg  = new ArgSymbol(formal->intent, formal->name, type);
+
+    fwdFn->insertFormalAtTail(arg);
+    call->insertAtTail(arg);
+  }
+
+  fwdFn->insertAtTail(call);
+  fwdFn->insertAtTail(new CallExpr(PRIM_RETURN, gVoid));
+  fwdFn->retType = dtVoid;
+
+  fn->defPoint->insertBefore(new DefExpr(fwdFn));
+
+  return fwdFn;
+}
+
+static void replaceCoforallOnForwards(FnSymbol* fn, CallExpr* call) {
+  std::vector<CallExpr*> calls;
+  FnSymbol*              fwdFn = NULL;
+  SymbolMap              indexMap;
+
+  collectCallExprs(fn->body, calls);
+
+  for_vector(CallExpr, fwd, calls) {
+    if (!fwd->isPrimitive(PRIM_COFORALL_ON_FORWARD))
+      continue;
+
+    // Skip those for nested coforall+ons, whose blocks are still here.
+    Symbol* index = toSymExpr(fwd->get(3))->symbol();
+    if (!isCorrespCoforallIndex(fn, index))
+      continue;
+
+    SET_LINENO(fwd);
+
+    // The coforall index would otherwise become a formal only in
+    // flattenFunctions(), too late for the forward to replace it.
+    if (fwdFn == NULL) {
+      indexMap.put(index, markUnspecified);
+      addVarsToFormalsActuals(fn, indexMap, call, /*isCoforall=*/true);
+      replaceVarUses(fn->body, indexMap);
+
+      fwdFn = buildCoforallOnForwardFn(fn);
+      fn->addFlag(FLAG_COFORALL_ON_TREE);
+    }
+    index = indexMap.get(index);
+
+    ArgSymbol* localeArg = fn->getFormal(1);
+    CallExpr*  fwdCall   = new CallExpr(fwdFn);
+
+    for_formals(formal, fn) {
+      if (formal == localeArg)
+        fwdCall->insertAtTail(fwd->get(1)->copy());
+      else if (formal == index)
+        fwdCall->insertAtTail(fwd->get(2)->copy());
+      else
+        fwdCall->insertAtTail(formal);
+    }
+
+    fwd->replace(fwdCall);
+  }
+}
+
 static
 bool isAtomicFunctionWithOrderArgument(FnSymbol* fnSymbol, ArgSymbol** order = NULL)
 {
@@ -939,6 +1022,9 @@ void createTaskFunctions(void) {
 
           addVarsToFormalsActuals(fn, uses, call, isCoforall);
           replaceVarUses(fn->body, uses);
+
+          if (info->isPrimitive(PRIM_BLOCK_COFORALL_ON))
+            replaceCoforallOnForwards(fn, call);
         }
       } // if fn
     } // if blockInfo
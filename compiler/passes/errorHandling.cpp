@@ -1132,6 +1132,11 @@ static void checkErrorHandling(FnSymbol* fn, implicitThrowsReasons_t* reasons)
       USR_FATAL_CONT(fn, "deinit is not permitted to throw");
   }
 
+  // A coforall+on tree task is checked from the coforall that starts it,
+  // not from the function that starts it again on the child locales.
+  if (fn->hasFlag(FLAG_COFORALL_ON_TREE) && !isTaskFun(fn))
+    return;
+
   error_checking_mode_t mode = computeErrorCheckingMode(fn);
   INT_ASSERT(mode != ERROR_MODE_UNKNOWN);
 
@@ -48,6 +48,7 @@
 #include <map>
 #include <set>
 #include <stack>
+#include <unordered_map>
 
 /************************************* | **************************************
 *                                                                             *
@@ -64,7 +65,7 @@
 // Note that this caching is not enabled until after use expression
 // have been resolved.
 //
-static std::map<BlockStmt*, Vec<VisibilityStmt*>*> moduleUsesCache;
+static std::unordered_map<BlockStmt*, Vec<VisibilityStmt*>*> moduleUsesCache;
 static bool enableModuleUsesCache = false;
 
 // To avoid duplicate user warnings in checkIdInsideWithClause().
@@ -1501,7 +1502,7 @@ static void adjustTypeMethodsOnClasses() {
 
 
 void destroyModuleUsesCaches() {
-  std::map<BlockStmt*, Vec<VisibilityStmt*>*>::iterator use;
+  std::unordered_map<BlockStmt*, Vec<VisibilityStmt*>*>::iterator use;
 
   for (use = moduleUsesCache.begin(); use != moduleUsesCache.end(); use++) {
     delete use->second;
@@ -1833,7 +1834,10 @@ bool lookupThisScopeAndUses(const char*           name,
       if (block->useList != NULL) {
         Vec<VisibilityStmt*>* moduleUses = NULL;
 
-        if (moduleUsesCache.count(block) == 0) {
+        std::unordered_map<BlockStmt*, Vec<VisibilityStmt*>*>::iterator
+          cached = moduleUsesCache.find(block);
+
+        if (cached == moduleUsesCache.end()) {
           moduleUses = new Vec<VisibilityStmt*>();
 
           for_actuals(expr, block->useList) {
@@ -1854,7 +1858,7 @@ bool lookupThisScopeAndUses(const char*           name,
           if (enableModuleUsesCache)
             moduleUsesCache[block] = moduleUses;
         } else {
-          moduleUses = moduleUsesCache[block];
+          moduleUses = cached->second;
         }
 
         forv_Vec(Stmt, stmt, *moduleUses) {
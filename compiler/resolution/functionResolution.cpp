@@ -5626,8 +5626,12 @@ static void handleTaskIntentArgs(CallInfo& info, FnSymbol* taskFn) {
       // by blank or const intent. As of this writing (6'2015)
       // records and strings are (incorrectly) captured at the point
       // when the task function/arg bundle is created.
+      // Nor does it capture when a coforall+on tree task is started
+      // again on the child locales: its formals were captured already.
       bool shouldCapture = false;
+      bool isTreeFwd     = call->parentSymbol->hasFlag(FLAG_COFORALL_ON_TREE);
       if (taskFn->hasFlag(FLAG_COBEGIN_OR_COFORALL) == true &&
+          isTreeFwd                                 == false &&
           varActual->isConstValWillNotChange()      == false &&
           (concreteIntent(formal->intent, formal->type->getValType())
            & INTENT_FLAG_IN)) {
@@ -5691,24 +5695,33 @@ static void captureTaskIntentValues(int        argNum,
 
   INT_ASSERT(parent);
 
-  if (taskFn->hasFlag(FLAG_ON) && !parent->isForLoop()) {
-    // coforall ... { on ... { .... }} ==> there is an intermediate BlockStmt
-    parent = toBlockStmt(parent->parentExpr);
+  Expr* marker = NULL;
 
-    INT_ASSERT(parent);
-  }
+  if (taskFn->hasFlag(FLAG_COFORALL_ON_TREE)) {
+    // The root task of a coforall+on tree is started just once, from here.
+    marker = call;
+
+  } else {
+    if (taskFn->hasFlag(FLAG_ON) && !parent->isForLoop()) {
+      // coforall ... { on ... { .... }} ==> there is an intermediate BlockStmt
+      parent = toBlockStmt(parent->parentExpr);
 
-  if (fVerify == true) {
-    if (argNum == 0 || (argNum == 1 && taskFn->hasFlag(FLAG_ON) == true)) {
-      verifyTaskFnCall(parent, call); //assertions only
+      INT_ASSERT(parent);
     }
-  }
 
-  Expr* marker = parentToMarker(parent, call);
+    if (fVerify == true) {
+      if (argNum == 0 || (argNum == 1 && taskFn->hasFlag(FLAG_ON) == true)) {
+        verifyTaskFnCall(parent, call); //assertions only
+      }
+    }
+
+    marker = parentToMarker(parent, call);
+  }
 
   if (varActual->hasFlag(FLAG_NO_CAPTURE_FOR_TASKING) == true) {
 
-  } else if (varActual->defPoint->parentExpr == parent) {
+  } else if (marker != call ? varActual->defPoint->parentExpr == parent
+                            : varActual->hasFlag(FLAG_COFORALL_INDEX_VAR)) {
     // Index variable of the coforall loop? Do not capture it!
     INT_ASSERT(varActual->hasFlag(FLAG_COFORALL_INDEX_VAR));
 
@@ -1462,6 +1462,8 @@ proc Block.chpl__locToLocIdx(loc: locale) {
 proc BlockArr.dsiHasSingleLocalSubdomain() param return true;
 proc BlockDom.dsiHasSingleLocalSubdomain() param return true;
 
+override proc BlockArr.dsiHasDisjointLocalSubdomains() param return true;
+
 // returns the current locale's subdomain
 
 proc BlockArr.dsiLocalSubdomain(loc: locale) {
@@ -1264,6 +1264,8 @@ proc Cyclic.dsiTargetLocales() {
 proc CyclicArr.dsiHasSingleLocalSubdomain() param return true;
 proc CyclicDom.dsiHasSingleLocalSubdomain() param return true;
 
+override proc CyclicArr.dsiHasDisjointLocalSubdomains() param return true;
+
 proc CyclicArr.dsiLocalSubdomain(loc: locale) {
   if (loc == here) {
     // quick solution if we have a local array
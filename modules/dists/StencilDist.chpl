@@ -1909,6 +1909,8 @@ proc Stencil.chpl__locToLocIdx(loc: locale) {
 proc StencilArr.dsiHasSingleLocalSubdomain() param return true;
 proc StencilDom.dsiHasSingleLocalSubdomain() param return true;
 
+override proc StencilArr.dsiHasDisjointLocalSubdomains() param return true;
+
 // returns the current locale's subdomain
 
 proc StencilArr.dsiLocalSubdomain(loc: locale) {
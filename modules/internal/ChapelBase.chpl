@@ -1161,6 +1161,53 @@ module ChapelBase {
       chpl_rt_reset_task_spawn();
   }
 
+  //
+  // Support for "coforall loc in Locales do on loc", lowered as a tree
+  // (see buildTreeCoforallOn() in the compiler).  The tree of locales
+  // is rooted at the one the coforall started on, and has the same
+  // shape and fanout as the runtime's broadcast trees.  Each task
+  // starts the ones for its children before running the loop body.
+  //
+  pragma "fn synchronization free"
+  extern proc chpl_comm_bcast_fanout(): c_int;
+
+  proc chpl__coforallOnTree(x) param return false;
+  proc chpl__coforallOnTree(x: [] locale) param return true;
+
+  // The tree is used only for the Locales array itself, and only if
+  // there are more locales than the fanout; otherwise it's flat anyway.
+  // Returns the root of the tree, or -1 for no tree.
+  proc chpl__coforallOnTreeRoot(const ref x: [] locale) {
+    if rootLocaleInitialized &&
+       x._value == Locales._value &&
+       chpl_comm_bcast_fanout() < numLocales - 1 then
+      return here.id;
+    else
+      return -1;
+  }
+
+  iter chpl__coforallOnTreeRoots(const ref x: [] locale, root) {
+    if root < 0 {
+      for loc in x do
+        yield loc;
+    } else {
+      yield Locales[root];
+    }
+  }
+
+  iter chpl__coforallOnTreeChildren(root) {
+    if root >= 0 {
+      const fanout = chpl_comm_bcast_fanout(): int;
+      const rank = (here.id - root + numLocales) % numLocales;
+      for childRank in rank*fanout+1..min(rank*fanout+fanout, numLocales-1) do
+        yield (root + childRank) % numLocales;
+    }
+  }
+
+  proc chpl__coforallOnTreeLocale(node) {
+    return Locales[node];
+  }
+
   config param useAtomicTaskCnt =  CHPL_NETWORK_ATOMICS!="none";
 
   // Parent class for _EndCount instances so that it's easy
@@ -671,6 +671,10 @@ module ChapelDistribution {
 
     proc dsiStaticFastFollowCheck(type leadType) param return false;
 
+    // True if each element is owned by just one locale, and
+    // dsiLocalSubdomain(here) gives the indices of the ones owned here.
+    proc dsiHasDisjointLocalSubdomains() param return false;
+
     proc dsiGetBaseDom(): unmanaged BaseDom {
       halt("internal error: dsiGetBaseDom is not implemented");
       pragma "unsafe" var ret: unmanaged BaseDom; // nil
@@ -26,34 +26,91 @@
 // chpl_TableEntry is the type for each hashtable slot
 // chpl__hashtable is the record implementing a hashtable
 // chpl__defaultHash is the default hash function for most types
+//
+// The table uses open addressing in the style of a Swiss table. Besides
+// the slots, it keeps a control byte per slot, recording whether the slot
+// is empty, deleted, or full, and for a full slot 7 bits of its key's hash.
+// Slots are probed in groups of 8 whose control bytes are packed into one
+// uint(64), so a lookup can check a whole group for candidate keys with a
+// handful of word operations and only compares keys whose hash bits match.
+// Table sizes are powers of 2.
+//
+// A chpl__hashtable created with concurrent=true splits its slots into
+// segments, each guarded by its own lock (see chpl__hashtableStripes).
+// A key only ever probes the slots of its segment, so operations on keys
+// in different segments can proceed in parallel. Slot numbers remain
+// global, so code indexing other data by slot number works unchanged.
 pragma "unsafe"
 module ChapelHashtable {
 
   use ChapelBase, DSIUtil;
+  private use ChapelLocks;
 
-  // empty needs to be 0 so memset 0 sets it
   enum chpl__hash_status { empty=0, full, deleted };
 
+  // The status of a slot is kept in its control byte, not in the entry.
   record chpl_TableEntry {
-    var status: chpl__hash_status = chpl__hash_status.empty;
     var key;
     var val;
-    inline proc isFull() {
-      return this.status == chpl__hash_status.full;
-    }
   }
 
-  private inline proc chpl__primes return
-    (0, 23, 53, 89, 191, 383, 761, 1531, 3067, 6143, 12281, 24571, 49139, 98299,
-     196597, 393209, 786431, 1572853, 3145721, 6291449, 12582893, 25165813,
-     50331599, 100663291, 201326557, 402653171, 805306357, 1610612711, 3221225461,
-     6442450939, 12884901877, 25769803751, 51539607551, 103079215087,
-     206158430183, 412316860387, 824633720831, 1649267441651, 3298534883309,
-     6597069766631, 13194139533299, 26388279066623, 52776558133177,
-     105553116266489, 211106232532969, 422212465065953, 844424930131963,
-     1688849860263901, 3377699720527861, 6755399441055731, 13510798882111483,
-     27021597764222939, 54043195528445869, 108086391056891903, 216172782113783773,
-     432345564227567561, 864691128455135207);
+  // #### control bytes ####
+
+  // empty needs to be 0 so that zeroed control words are all empty.
+  // A full slot has the high bit set and 7 bits of its key's hash.
+  private param _ctrlEmpty = 0:uint;
+  private param _ctrlDeleted = 1:uint;
+
+  private param _groupSize = 8;
+  private param _ctrlLsbs = 0x0101010101010101:uint;
+  private param _ctrlMsbs = 0x8080808080808080:uint;
+
+  // the largest tableSizeNum; chpl__tableSize(it) is 2**59
+  private param _maxTableSizeNum = 56;
+
+  // Returns the table size for the size index sizeNum.
+  // Size index 0 is an empty table. The smallest table has 2 groups.
+  private inline proc chpl__tableSize(sizeNum: int): int {
+    return if sizeNum == 0 then 0 else 1 << (sizeNum + 3);
+  }
+
+  // The control byte for a slot holding a key with hash 'hash'.
+  // chpl__defaultHashWrapper returns 63 bits, so this uses the top 7.
+  private inline proc _ctrlFull(hash: uint): uint {
+    return 0x80 | (hash >> 56);
+  }
+
+  // Returns a word with the high bit set in each byte of 'word' that is 0
+  private inline proc _zeroBytes(word: uint): uint {
+    const low7 = ~_ctrlMsbs;
+    return ~(((word & low7) + low7) | word | low7);
+  }
+
+  // Returns a mask of the bytes in the control word 'word' equal to 'ctrl'
+  private inline proc _matchCtrl(word: uint, ctrl: uint): uint {
+    return _zeroBytes(word ^ (_ctrlLsbs * ctrl));
+  }
+
+  private inline proc _matchEmpty(word: uint): uint {
+    return _zeroBytes(word);
+  }
+
+  private inline proc _matchEmptyOrDeleted(word: uint): uint {
+    return ~word & _ctrlMsbs;
+  }
+
+  // Returns the index within the group of the first byte set in 'mask'
+  private inline proc _firstInMask(mask: uint): int {
+    extern proc chpl_bitops_ctz_64(x: uint(64)): uint(64);
+    return (chpl_bitops_ctz_64(mask) >> 3):int;
+  }
+
+  // Only a hint, so it takes the address without the locality check
+  // c_ptrTo() would do; prefetching a remote address is harmless.
+  private inline proc _prefetch(ref x) {
+    extern proc chpl_prefetch(addr: c_void_ptr);
+    chpl_prefetch(__primitive("_wide_get_addr", x));
+  }
 
   // ### allocation helpers ###
 
@@ -155,10 +212,6 @@ module ChapelHashtable {
     }
   }
 
-  private inline proc _isSlotFull(const ref aSlot: chpl_TableEntry): bool {
-    return aSlot.status == chpl__hash_status.full;
-  }
-
   // #### iteration helpers ####
 
   // Returns the number of chunks to use in parallel iteration
@@ -264,38 +317,85 @@ module ChapelHashtable {
     proc finishRehash(oldSize: int) { }
   }
 
+  // Per-segment state of a concurrent chpl__hashtable. The padding keeps
+  // each segment on its own cache line so that tasks working on different
+  // segments don't contend on the lock words or the counts.
+  record chpl__hashtableSegment {
+    var lock: chpl_LocalSpinlock;
+    var numFullSlots: int;
+    var numDeletedSlots: int;
+    var pad: 5*int;
+  }
+
+  class chpl__hashtableStripes {
+    // a power of 2, and the maximum number of segments in the table
+    const numLocks: int;
+    var segments: _ddata(chpl__hashtableSegment);
+    // set by removals that leave a segment sparse; checked before
+    // taking all of the locks to consider shrinking the table
+    var shrinkHint: chpl__processorAtomicType(bool);
+
+    proc init() {
+      // Use a few locks per task so that collisions are unlikely
+      var n = 1;
+      while n < 4*here.maxTaskPar && n < 1024 do n *= 2;
+      this.numLocks = n;
+      this.segments = _ddata_allocate(chpl__hashtableSegment, n);
+    }
+    proc deinit() {
+      for i in 0..#numLocks do
+        chpl__autoDestroy(segments[i]);
+      _ddata_free(segments, numLocks);
+    }
+  }
+
   record chpl__hashtable {
     type keyType;
     type valType;
+    param concurrent: bool = false;
 
+    // For a concurrent table, these are only maintained per segment;
+    // use numFullSlots() for the total.
     var tableNumFullSlots: int;
     var tableNumDeletedSlots: int;
 
     var tableSizeNum: int;
     var tableSize: int;
     var table: _ddata(chpl_TableEntry(keyType, valType)); // 0..<tableSize
+    var ctrl: _ddata(uint); // control words, 0..<tableSize/8
+
+    // always 1 unless concurrent; tableSize is a multiple of it
+    var tableNumSegments: int;
+    var tableSegmentShift: int; // log2(tableNumSegments)
+    var stripes: if concurrent then owned chpl__hashtableStripes
+                 else nothing;
 
     var rehashHelpers: owned chpl__rehashHelpers?;
 
     var postponeResize: bool;
 
-    proc init(type keyType, type valType,
+    proc init(type keyType, type valType, param concurrent: bool = false,
               in rehashHelpers: owned chpl__rehashHelpers? = nil) {
       this.keyType = keyType;
       this.valType = valType;
+      this.concurrent = concurrent;
       this.tableNumFullSlots = 0;
       this.tableNumDeletedSlots = 0;
       this.tableSizeNum = 0;
-      this.tableSize = chpl__primes(tableSizeNum);
+      this.tableSize = chpl__tableSize(tableSizeNum);
+      this.tableNumSegments = 1;
+      if concurrent then
+        this.stripes = new chpl__hashtableStripes();
       this.rehashHelpers = rehashHelpers;
       this.postponeResize = false;
       this.complete();
 
       // allocates a _ddata(chpl_TableEntry(keyType,valType)) storing the table
       // All elements are memset to 0 (no initializer is run for the idxType)
-      // This allows them to be empty, but the key and val
-      // are considered uninitialized.
+      // The key and val are considered uninitialized until the
+      // slot's control byte says it is full.
       this.table = allocateTable(this.tableSize);
+      this.ctrl = allocateCtrl(this.tableSize);
     }
     proc deinit() {
       // Go through the full slots in the current table and run
@@ -304,29 +404,186 @@ module ChapelHashtable {
         if _deinitElementsIsParallel(keyType) &&
            _deinitElementsIsParallel(valType) {
           forall slot in _allSlots(tableSize) {
-            ref aSlot = table[slot];
-            if _isSlotFull(aSlot) {
-              _deinitSlot(aSlot);
+            if isSlotFull(slot) {
+              _deinitSlot(table[slot]);
             }
           }
         } else {
           for slot in _allSlots(tableSize) {
-            ref aSlot = table[slot];
-            if _isSlotFull(aSlot) {
-              _deinitSlot(aSlot);
+            if isSlotFull(slot) {
+              _deinitSlot(table[slot]);
             }
           }
         }
       }
 
-      // Free the buffer
+      // Free the buffers
       _freeData(table, tableSize);
+      _freeData(ctrl, tableSize/_groupSize);
+    }
+
+    // #### control byte helpers ####
+
+    inline proc _getCtrl(slot: int): uint {
+      const shift = (slot % _groupSize) * 8;
+      return (ctrl[slot / _groupSize] >> shift) & 0xff;
+    }
+
+    inline proc _setCtrl(slot: int, c: uint) {
+      const shift = (slot % _groupSize) * 8;
+      ref word = ctrl[slot / _groupSize];
+      word = (word & ~(0xff:uint << shift)) | (c << shift);
+    }
+
+    // Returns the status of a slot, as recorded in its control byte
+    proc slotStatus(slot: int): chpl__hash_status {
+      const c = _getCtrl(slot);
+      if c == _ctrlEmpty then
+        return chpl__hash_status.empty;
+      else if c == _ctrlDeleted then
+        return chpl__hash_status.deleted;
+      else
+        return chpl__hash_status.full;
+    }
+
+    // #### concurrency helpers ####
+
+    // Returns the segment that a key with hash value 'hash' belongs to
+    inline proc _segmentForHash(hash: uint): int {
+      if !concurrent || tableNumSegments == 1 then return 0;
+      // Fibonacci hashing: take the top bits of the product so that keys
+      // with poor hash functions (e.g. small integers) still spread out
+      // over the segments
+      const nBits = 64 - tableSegmentShift;
+      return ((hash * 0x9E3779B97F4A7C15:uint) >> nBits):int;
+    }
+
+    // Returns the number of segments used when tableSizeNum is sizeNum
+    proc _numSegmentsFor(sizeNum: int): int {
+      if !concurrent then
+        return 1;
+      else if sizeNum <= 1 then
+        return 1;
+      else
+        return min(stripes.numLocks, 1 << (sizeNum-1));
+    }
+
+    // Returns the table size used when tableSizeNum is sizeNum
+    proc _tableSizeFor(sizeNum: int): int {
+      return _numSegmentsFor(sizeNum) * chpl__tableSize(sizeNum);
+    }
+
+    // Returns the number of full slots in the table. For a concurrent
+    // table the result is only exact while all of the locks are held.
+    proc numFullSlots(): int {
+      if concurrent {
+        var n = 0;
+        for i in 0..#stripes.numLocks do
+          n += stripes.segments[i].numFullSlots;
+        return n;
+      } else {
+        return tableNumFullSlots;
+      }
+    }
+
+    // Locks the segment that 'key' belongs to. Until unlockKey is called,
+    // no other task can change the slots that 'key' could occupy.
+    proc lockKey(key: keyType) {
+      if !concurrent then
+        compilerError("lockKey requires a concurrent chpl__hashtable");
+      const hash = chpl__defaultHashWrapper(key):uint;
+      while true {
+        const seg = _segmentForHash(hash);
+        stripes.segments[seg].lock.lock();
+        // The number of segments only changes while all locks are held,
+        // so if the segment is still right it will stay right.
+        if seg == _segmentForHash(hash) then
+          return;
+        stripes.segments[seg].lock.unlock();
+      }
+    }
+
+    proc unlockKey(key: keyType) {
+      if !concurrent then
+        compilerError("unlockKey requires a concurrent chpl__hashtable");
+      const seg = _segmentForHash(chpl__defaultHashWrapper(key):uint);
+      stripes.segments[seg].lock.unlock();
+    }
+
+    // Unlocks the segment containing slotNum. This is useful when the key
+    // has been moved into the table. The caller must hold that lock.
+    proc unlockSlot(slotNum: int) {
+      if !concurrent then
+        compilerError("unlockSlot requires a concurrent chpl__hashtable");
+      const segSize = tableSize / tableNumSegments;
+      stripes.segments[slotNum / segSize].lock.unlock();
+    }
+
+    // Locks every segment, for operations on the table as a whole.
+    proc lockAll() {
+      if !concurrent then
+        compilerError("lockAll requires a concurrent chpl__hashtable");
+      // always acquire in the same order to avoid deadlock
+      for i in 0..#stripes.numLocks do
+        stripes.segments[i].lock.lock();
+    }
+
+    proc unlockAll() {
+      if !concurrent then
+        compilerError("unlockAll requires a concurrent chpl__hashtable");
+      for i in 0..#stripes.numLocks do
+        stripes.segments[i].lock.unlock();
+    }
+
+    // Trades the lock on key's segment for all of the locks
+    proc _lockAllFromKey(key: keyType) {
+      unlockKey(key);
+      lockAll();
+    }
+
+    // Releases all of the locks except the one on key's (possibly new)
+    // segment
+    proc _unlockAllToKey(key: keyType) {
+      const seg = _segmentForHash(chpl__defaultHashWrapper(key):uint);
+      for i in 0..#stripes.numLocks do
+        if i != seg then
+          stripes.segments[i].lock.unlock();
+    }
+
+    // Returns true if every segment would be at most half full after
+    // rehashing to size index newSizeNum. Keys don't necessarily spread
+    // evenly over the segments, so this needs checking before shrinking.
+    // Segment j of the smaller table gets the keys of the current segments
+    // whose numbers have j as their leading bits, since both use the top
+    // bits of the same product.
+    proc _segmentsFitInSize(newSizeNum: int): bool {
+      if concurrent {
+        const newNumSegments = _numSegmentsFor(newSizeNum);
+        const ratio = tableNumSegments / newNumSegments;
+        for j in 0..#newNumSegments {
+          var n = 0;
+          for i in j*ratio..#ratio do
+            n += stripes.segments[i].numFullSlots;
+          if 2*n > chpl__tableSize(newSizeNum) then
+            return false;
+        }
+      }
+      return true;
+    }
+
+    // Returns true if adding to the segment for 'hash' should grow the
+    // table. This is the per-segment version of the load factor check.
+    proc _segmentNeedsGrow(hash: uint): bool {
+      if tableSize == 0 then return true;
+      const ref segment = stripes.segments[_segmentForHash(hash)];
+      const segSize = tableSize / tableNumSegments;
+      return (segment.numFullSlots+segment.numDeletedSlots+1)*2 > segSize;
     }
 
     // #### iteration helpers ####
 
     inline proc isSlotFull(slot: int): bool {
-      return table[slot].status == chpl__hash_status.full;
+      return (_getCtrl(slot) & 0x80) != 0;
     }
 
     iter allSlots() {
@@ -368,37 +625,73 @@ module ChapelHashtable {
     // filledSlotFound will be true if a matching filled slot was found.
     // slot will be the matching filled slot in that event.
     //
-    // If no matching slot was found, slot will store an
-    // empty slot that may be re-used for faster addition to the domain
-    //
-    // This function never returns deleted slots.
+    // If no matching slot was found, slot will store the first empty
+    // or deleted slot in the probe sequence, which may be re-used
+    // for faster addition to the domain, or -1 if there is none.
     proc _findSlot(key: keyType) : (bool, int) {
+      if tableSize == 0 then return (false, -1);
+
+      const hash = chpl__defaultHashWrapper(key):uint;
+      const c = _ctrlFull(hash);
       var firstOpen = -1;
-      for slotNum in _lookForSlots(key) {
-        const slotStatus = table[slotNum].status;
-        // if we encounter a slot that's empty, our element could not
-        // be found past this point.
-        if (slotStatus == chpl__hash_status.empty) {
-          if firstOpen == -1 then firstOpen = slotNum;
-          return (false, firstOpen);
-        } else if (slotStatus == chpl__hash_status.full) {
-          if (table[slotNum].key == key) {
+      for group in _lookForGroups(hash, tableSize) {
+        // start fetching the group's entries while its control word loads
+        _prefetch(table[group*_groupSize]);
+        const word = ctrl[group];
+        // only compare keys whose hash bits match
+        var candidates = _matchCtrl(word, c);
+        while candidates != 0 {
+          const slotNum = group*_groupSize + _firstInMask(candidates);
+          if table[slotNum].key == key then
             return (true, slotNum);
-          }
-        } else { // this entry was removed, but is the first slot we could use
-          if firstOpen == -1 then firstOpen = slotNum;
+          candidates &= candidates - 1;
         }
+        if firstOpen == -1 {
+          const open = _matchEmptyOrDeleted(word);
+          if open != 0 then
+            firstOpen = group*_groupSize + _firstInMask(open);
+        }
+        // Keys are only ever placed in the first group with room in their
+        // probe sequence, so our key can't be past a group with an empty slot.
+        if _matchEmpty(word) != 0 then
+          return (false, firstOpen);
+      }
+      return (false, firstOpen);
+    }
+
+    // Finds a slot for a key known not to be in the table,
+    // when there are no deleted slots. For use while rehashing.
+    proc _findSlotForNewKey(hash: uint): int {
+      for group in _lookForGroups(hash, tableSize) {
+        const empty = _matchEmpty(ctrl[group]);
+        if empty != 0 then
+          return group*_groupSize + _firstInMask(empty);
+      }
+      return -1;
+    }
+
+    // Yields the groups to probe for a key with hash 'hash', in order.
+    // The probes visit groups at triangular offsets from the first, which
+    // covers every group since the number of groups is a power of 2.
+    // A concurrent table only probes the groups in the key's segment.
+    iter _lookForGroups(hash: uint, numSlots: int) {
+      const numGroups = numSlots / _groupSize / tableNumSegments;
+      const first = _segmentForHash(hash) * numGroups;
+      const mask = (numGroups - 1):uint;
+      var g = hash & mask;
+      for probe in 1..numGroups:uint {
+        yield first + g:int;
+        g = (g + probe) & mask;
       }
-      return (false, -1);
     }
 
     iter _lookForSlots(key: keyType, numSlots = tableSize) {
-      const baseSlot = chpl__defaultHashWrapper(key):uint;
       if numSlots == 0 then return;
-      for probe in 0..numSlots/2 {
-        var uprobe = probe:uint;
-        var n = numSlots:uint;
-        yield ((baseSlot + uprobe**2)%n):int;
+      const hash = chpl__defaultHashWrapper(key):uint;
+      for group in _lookForGroups(hash, numSlots) {
+        for i in 0..#_groupSize {
+          yield group*_groupSize + i;
+        }
       }
     }
 
@@ -409,12 +702,23 @@ module ChapelHashtable {
     // Finds a slot available for adding a key
     // or a slot that was already present with that key.
     // It can rehash the table.
+    // For a concurrent table, the caller must hold lockKey(key); the lock
+    // might be released and reacquired while the table is resized.
     // returns (foundFullSlot, slotNum)
     proc findAvailableSlot(key: keyType): (bool, int) {
       var slotNum = -1;
       var foundSlot = false;
 
-      if (tableNumFullSlots+tableNumDeletedSlots+1)*2 > tableSize {
+      if concurrent {
+        const hash = chpl__defaultHashWrapper(key):uint;
+        if _segmentNeedsGrow(hash) {
+          _lockAllFromKey(key);
+          // check again since another task may have grown the table
+          if _segmentNeedsGrow(hash) then
+            resize(grow=true);
+          _unlockAllToKey(key);
+        }
+      } else if (tableNumFullSlots+tableNumDeletedSlots+1)*2 > tableSize {
         resize(grow=true);
       }
 
@@ -431,7 +735,13 @@ module ChapelHashtable {
         // This can happen if there are too many deleted elements in the
         // table. In that event, we can garbage collect the table by rehashing
         // everything now.
-        rehash(tableSizeNum, tableSize);
+        if concurrent {
+          _lockAllFromKey(key);
+          rehash(tableSizeNum, tableSize);
+          _unlockAllToKey(key);
+        } else {
+          rehash(tableSizeNum, tableSize);
+        }
 
         (foundSlot, slotNum) = _findSlot(key);
 
@@ -439,36 +749,38 @@ module ChapelHashtable {
           // This shouldn't be possible since we just garbage collected
           // the deleted entries & the table should only ever be half
           // full of non-deleted entries.
-          halt("couldn't add key -- ", tableNumFullSlots, " / ", tableSize, " taken");
+          halt("couldn't add key -- ", numFullSlots(), " / ", tableSize, " taken");
           return (false, -1);
         }
         return (foundSlot, slotNum);
       }
     }
 
-    proc fillSlot(ref tableEntry: chpl_TableEntry(keyType, valType),
+    proc fillSlot(slotNum: int,
                   in key: keyType,
                   in val: valType) {
-      if tableEntry.status == chpl__hash_status.full {
+      ref tableEntry = table[slotNum];
+      const oldCtrl = _getCtrl(slotNum);
+      if (oldCtrl & 0x80) != 0 {
         _deinitSlot(tableEntry);
+      } else if concurrent {
+        ref segment = stripes.segments[slotNum / (tableSize/tableNumSegments)];
+        if oldCtrl == _ctrlDeleted {
+          segment.numDeletedSlots -= 1;
+        }
+        segment.numFullSlots += 1;
       } else {
-        if tableEntry.status == chpl__hash_status.deleted {
+        if oldCtrl == _ctrlDeleted {
           tableNumDeletedSlots -= 1;
         }
         tableNumFullSlots += 1;
       }
 
-      tableEntry.status = chpl__hash_status.full;
+      _setCtrl(slotNum, _ctrlFull(chpl__defaultHashWrapper(key):uint));
       // move the key/val into the table
       _moveInit(tableEntry.key, key);
       _moveInit(tableEntry.val, val);
     }
-    proc fillSlot(slotNum: int,
-                  in key: keyType,
-                  in val: valType) {
-      ref tableEntry = table[slotNum];
-      fillSlot(tableEntry, key, val);
-    }
 
     // remove pattern:
     //   findFullSlot
@@ -490,51 +802,89 @@ module ChapelHashtable {
     // Clears a slot that is full
     // (Should not be called on empty/deleted slots)
     // Returns the key and value that were removed in the out arguments
-    proc clearSlot(ref tableEntry: chpl_TableEntry(keyType, valType),
-                   out key: keyType, out val: valType) {
+    proc clearSlot(slotNum: int, out key: keyType, out val: valType) {
       // move the table entry into the key/val variables to be returned
+      ref tableEntry = table[slotNum];
       key = _moveToReturn(tableEntry.key);
       val = _moveToReturn(tableEntry.val);
 
-      // set the slot status to deleted
-      tableEntry.status = chpl__hash_status.deleted;
+      // If the slot's group has an empty slot, no probe sequence has ever
+      // continued past this group, so the slot can go back to empty.
+      // Otherwise it has to be marked deleted.
+      const deleted = _matchEmpty(ctrl[slotNum / _groupSize]) == 0;
+      _setCtrl(slotNum, if deleted then _ctrlDeleted else _ctrlEmpty);
 
       // update the table counts
-      tableNumFullSlots -= 1;
-      tableNumDeletedSlots += 1;
+      if concurrent {
+        const segSize = tableSize / tableNumSegments;
+        ref segment = stripes.segments[slotNum / segSize];
+        segment.numFullSlots -= 1;
+        if deleted then segment.numDeletedSlots += 1;
+        if segment.numFullSlots*8 < segSize then
+          stripes.shrinkHint.write(true);
+      } else {
+        tableNumFullSlots -= 1;
+        if deleted then tableNumDeletedSlots += 1;
+      }
     }
-    proc clearSlot(slotNum: int, out key: keyType, out val: valType) {
-      // move the table entry into the key/val variables to be returned
-      ref tableEntry = table[slotNum];
-      clearSlot(tableEntry, key, val);
+
+    // Marks all of the empty and deleted slots as empty.
+    // Only valid once every full slot has been cleared, or for a
+    // concurrent table, while all of the locks are held.
+    proc forgetDeletedSlots() {
+      if numFullSlots() != 0 then
+        halt("forgetDeletedSlots called on a table with full slots");
+      for i in 0..#tableSize/_groupSize do
+        ctrl[i] = 0;
+      if concurrent {
+        for i in 0..#stripes.numLocks do
+          stripes.segments[i].numDeletedSlots = 0;
+      } else {
+        tableNumDeletedSlots = 0;
+      }
     }
 
+    // For a concurrent table, the caller must hold all of the locks
     proc maybeShrinkAfterRemove() {
-      if (tableNumFullSlots*8 < tableSize && tableSizeNum > 0) {
+      if (numFullSlots()*8 < tableSize && tableSizeNum > 0) {
         resize(grow=false);
       }
     }
 
+    // Like maybeShrinkAfterRemove, but for a concurrent table when the
+    // caller holds none of the locks. Only takes the locks if a removal
+    // left some segment sparse.
+    proc maybeShrinkAfterRemoveConcurrent() {
+      if !concurrent then
+        compilerError("maybeShrinkAfterRemoveConcurrent requires ",
+                      "a concurrent chpl__hashtable");
+      if postponeResize || !stripes.shrinkHint.read() then
+        return;
+
+      lockAll();
+      stripes.shrinkHint.write(false);
+      maybeShrinkAfterRemove();
+      unlockAll();
+    }
+
     // #### rehash / resize helpers ####
 
-    proc _findPrimeSizeIndex(numKeys:int) {
-      //Find the first suitable prime
+    proc _findSizeIndex(numKeys:int) {
+      //Find the first size that keeps the table at most half full
       var threshold = (numKeys + 1) * 2;
-      var prime = 0;
-      var primeLoc = 0;
-      for i in 0..#chpl__primes.size {
-          if chpl__primes(i) > threshold {
-            prime = chpl__primes(i);
-            primeLoc = i;
+      var sizeLoc = 0;
+      for i in 1.._maxTableSizeNum {
+          if _tableSizeFor(i) > threshold {
+            sizeLoc = i;
             break;
           }
       }
 
-      //No suitable prime found
-      if prime == 0 {
+      //No suitable size found
+      if sizeLoc == 0 {
         halt("Requested capacity (", numKeys, ") exceeds maximum size");
       }
-      return primeLoc;
+      return sizeLoc;
     }
 
     proc allocateData(size: int, type tableEltType) {
@@ -551,19 +901,42 @@ module ChapelHashtable {
         return _allocateData(size, chpl_TableEntry(keyType, valType));
       }
     }
+    // allocates the control words for a table of size 'size', all empty
+    proc allocateCtrl(size:int) {
+      if size == 0 {
+        return nil;
+      } else {
+        return _ddata_allocate(uint, size/_groupSize);
+      }
+    }
 
     // newSize is the new table size
-    // newSizeNum is an index into chpl__primes == newSize
+    // newSizeNum is the size index; newSize == _tableSizeFor(newSizeNum)
     // assumes the array is already locked
+    // (for a concurrent table, that all of the locks are held)
     proc rehash(newSizeNum:int, newSize:int) {
       // save the old table
       var oldSize = tableSize;
       var oldTable = table;
+      var oldCtrl = ctrl;
+
+      var entries = numFullSlots();
 
       tableSizeNum = newSizeNum;
       tableSize = newSize;
+      tableNumSegments = _numSegmentsFor(newSizeNum);
+      tableSegmentShift = 0;
+      while (1 << tableSegmentShift) < tableNumSegments do
+        tableSegmentShift += 1;
+
+      if concurrent {
+        // the counts are rebuilt below as the entries are moved
+        for i in 0..#stripes.numLocks {
+          stripes.segments[i].numFullSlots = 0;
+          stripes.segments[i].numDeletedSlots = 0;
+        }
+      }
 
-      var entries = tableNumFullSlots;
       if entries > 0 {
         // There were entries, so carefully move them to the a new allocation
 
@@ -572,6 +945,7 @@ module ChapelHashtable {
         }
 
         table = allocateTable(tableSize);
+        ctrl = allocateCtrl(tableSize);
 
         if rehashHelpers != nil then
           rehashHelpers!.startRehash(tableSize);
@@ -587,13 +961,14 @@ module ChapelHashtable {
         // same position in the new array which would lead to data
         // races. So it's not as simple as using forall here.
         for oldslot in _allSlots(oldSize) {
-          if oldTable[oldslot].status == chpl__hash_status.full {
+          const oldSlotCtrl = (oldCtrl[oldslot / _groupSize] >>
+                               ((oldslot % _groupSize) * 8)) & 0xff;
+          if (oldSlotCtrl & 0x80) != 0 {
             ref oldEntry = oldTable[oldslot];
-            // find a destination slot
-            var (foundSlot, newslot) = _findSlot(oldEntry.key);
-            if foundSlot {
-              halt("duplicate element found while resizing for key");
-            }
+            // find a destination slot. The keys are known to be distinct,
+            // so there's no need to compare them.
+            const hash = chpl__defaultHashWrapper(oldEntry.key):uint;
+            const newslot = _findSlotForNewKey(hash);
             if newslot < 0 {
               halt("couldn't add element during resize - got slot ", newslot,
                    " for key");
@@ -601,7 +976,9 @@ module ChapelHashtable {
 
             // move the key and value from the old entry into the new one
             ref dstSlot = table[newslot];
-            dstSlot.status = chpl__hash_status.full;
+            _setCtrl(newslot, oldSlotCtrl);
+            if concurrent then
+              stripes.segments[newslot / (tableSize/tableNumSegments)].numFullSlots += 1;
             _moveInit(dstSlot.key, _moveToReturn(oldEntry.key));
             _moveInit(dstSlot.val, _moveToReturn(oldEntry.val));
 
@@ -616,6 +993,7 @@ module ChapelHashtable {
 
         // delete the old allocation
         _freeData(oldTable, oldSize);
+        _freeData(oldCtrl, oldSize/_groupSize);
 
       } else {
         // There were no entries, so just make a new allocation
@@ -628,19 +1006,24 @@ module ChapelHashtable {
 
         // delete the old allocation
         _freeData(oldTable, oldSize);
+        _freeData(oldCtrl, oldSize/_groupSize);
 
         table = allocateTable(tableSize);
+        ctrl = allocateCtrl(tableSize);
         tableNumDeletedSlots = 0;
       }
     }
 
     proc requestCapacity(numKeys:int) {
-      if tableNumFullSlots < numKeys {
+      if numFullSlots() < numKeys {
+
+        var sizeLoc = _findSizeIndex(numKeys);
+        var size = _tableSizeFor(sizeLoc);
 
-        var primeLoc = _findPrimeSizeIndex(numKeys);
-        var prime = chpl__primes(primeLoc);
+        if sizeLoc < tableSizeNum && !_segmentsFitInSize(sizeLoc) then
+          return;
 
-        rehash(primeLoc, prime);
+        rehash(sizeLoc, size);
       }
     }
 
@@ -649,12 +1032,13 @@ module ChapelHashtable {
 
       var newSizeNum = tableSizeNum;
       newSizeNum += if grow then 1 else -1;
-      if newSizeNum > chpl__primes.size then
+      if newSizeNum > _maxTableSizeNum then
         halt("associative array exceeds maximum size");
 
-      var newSize = chpl__primes(newSizeNum);
+      var newSize = _tableSizeFor(newSizeNum);
 
-      if grow==false && 2*tableNumFullSlots > newSize {
+      if grow==false && (2*numFullSlots() > newSize ||
+                         !_segmentsFitInSize(newSizeNum)) {
         // don't shrink if the number of elements would not
         // fit into the new size.
         return;
@@ -72,6 +72,119 @@ module ChapelReduce {
     delete localOp;
   }
 
+  //
+  // 'op reduce A', where A is a distributed array each element of which
+  // is owned by just one locale, can be done by the runtime's collective
+  // allreduce when the op and element type are ones it handles.  Each
+  // locale reduces the part of A it owns and then the locales combine
+  // their results together, instead of each combining its result into
+  // a single reduction state on the locale doing the reduce.  The
+  // compiler calls chpl__canCommAllreduce() to decide whether to call
+  // chpl__commAllreduce() instead of lowering the reduce to a forall.
+  //
+  config param useCommAllreduce = true;
+
+  proc chpl__commReduceOpName(type opType) param {
+    if isSubtype(opType, SumReduceScanOp) then return "sum";
+    else if isSubtype(opType, MinReduceScanOp) then return "min";
+    else if isSubtype(opType, MaxReduceScanOp) then return "max";
+    else if isSubtype(opType, LogicalAndReduceScanOp) then return "land";
+    else if isSubtype(opType, LogicalOrReduceScanOp) then return "lor";
+    else return "";
+  }
+
+  proc chpl__canCommAllreduce(type opType, data) param {
+    if !useCommAllreduce || (CHPL_COMM != "gasnet" && CHPL_COMM != "ofi") {
+      return false;
+    } else if !isArray(data) {
+      return false;
+    } else if !data._value.dsiHasDisjointLocalSubdomains() {
+      return false;
+    } else {
+      type eltType = data.eltType;
+      param opName = chpl__commReduceOpName(opType);
+      if opName == "sum" || opName == "min" || opName == "max" then
+        return (isIntType(eltType) || isUintType(eltType) ||
+                isRealType(eltType)) &&
+               (numBits(eltType) == 32 || numBits(eltType) == 64);
+      else if opName == "land" || opName == "lor" then
+        return eltType == bool;
+      else
+        return false;
+    }
+  }
+
+  proc chpl__commAllreduce(type opType, data) {
+    use SysCTypes;
+    extern proc chpl_comm_allreduce_new_id(): uint(64);
+    extern proc chpl_comm_allreduce(id: uint(64), buf: c_void_ptr,
+                                    count: size_t, reduceType: c_int,
+                                    reduceOp: c_int);
+
+    type eltType = data.eltType;
+    param opName = chpl__commReduceOpName(opType);
+    const reduceType = chpl__commReduceType(eltType);
+    const reduceOp = chpl__commReduceOp(opName);
+    const id = chpl_comm_allreduce_new_id();
+    const origin = here.id;
+    var result: eltType;
+
+    coforall loc in Locales with (ref result) do on loc {
+      const mySubdom = data.localSubdomain();
+      var x: eltType;
+      if opName == "sum" then
+        x = + reduce [i in mySubdom] data.localAccess[i];
+      else if opName == "min" then
+        x = min reduce [i in mySubdom] data.localAccess[i];
+      else if opName == "max" then
+        x = max reduce [i in mySubdom] data.localAccess[i];
+      else if opName == "land" then
+        x = && reduce [i in mySubdom] data.localAccess[i];
+      else
+        x = || reduce [i in mySubdom] data.localAccess[i];
+
+      chpl_comm_allreduce(id, c_ptrTo(x), 1, reduceType, reduceOp);
+      if here.id == origin then
+        result = x;
+    }
+
+    return result;
+  }
+
+  private proc chpl__commReduceType(type eltType) {
+    use SysCTypes;
+    extern const CHPL_COMM_REDUCE_INT32: c_int;
+    extern const CHPL_COMM_REDUCE_INT64: c_int;
+    extern const CHPL_COMM_REDUCE_UINT32: c_int;
+    extern const CHPL_COMM_REDUCE_UINT64: c_int;
+    extern const CHPL_COMM_REDUCE_REAL32: c_int;
+    extern const CHPL_COMM_REDUCE_REAL64: c_int;
+    extern const CHPL_COMM_REDUCE_BOOL: c_int;
+
+    if eltType == int(32) then return CHPL_COMM_REDUCE_INT32;
+    else if eltType == int(64) then return CHPL_COMM_REDUCE_INT64;
+    else if eltType == uint(32) then return CHPL_COMM_REDUCE_UINT32;
+    else if eltType == uint(64) then return CHPL_COMM_REDUCE_UINT64;
+    else if eltType == real(32) then return CHPL_COMM_REDUCE_REAL32;
+    else if eltType == real(64) then return CHPL_COMM_REDUCE_REAL64;
+    else return CHPL_COMM_REDUCE_BOOL;
+  }
+
+  private proc chpl__commReduceOp(param opName) {
+    use SysCTypes;
+    extern const CHPL_COMM_REDUCE_SUM: c_int;
+    extern const CHPL_COMM_REDUCE_MIN: c_int;
+    extern const CHPL_COMM_REDUCE_MAX: c_int;
+    extern const CHPL_COMM_REDUCE_LAND: c_int;
+    extern const CHPL_COMM_REDUCE_LOR: c_int;
+
+    if opName == "sum" then return CHPL_COMM_REDUCE_SUM;
+    else if opName == "min" then return CHPL_COMM_REDUCE_MIN;
+    else if opName == "max" then return CHPL_COMM_REDUCE_MAX;
+    else if opName == "land" then return CHPL_COMM_REDUCE_LAND;
+    else return CHPL_COMM_REDUCE_LOR;
+  }
+
   // Return true for simple cases where x.type == (x+x).type.
   // This should be true for the great majority of cases in practice.
   // This proc helps us avoid run-time computations upon chpl__sumType().
@@ -29,6 +29,14 @@ module ChapelSerializedBroadcast {
 
   extern proc chpl_get_global_serialize_table(idx : int) : c_void_ptr;
 
+  //
+  // Serialized globals go out from the root locale down a tree, the
+  // same shape as the runtime's broadcast trees: locales are ranked
+  // relative to the root, and the children of rank r are ranks
+  // r*fanout+1 through r*fanout+fanout.  Each locale rebuilds its copy
+  // from its parent's and then serializes that copy for its own
+  // children, so no one locale is the source for all the others.
+  //
   proc chpl__broadcastGlobal(ref localeZeroGlobal : ?T, id : int)
   where chpl__enableSerializedGlobals {
     //
@@ -49,27 +57,56 @@ module ChapelSerializedBroadcast {
     } else {
       const data = localeZeroGlobal.chpl__serialize();
       const root = here.id;
-      coforall loc in Locales do on loc {
-        if here.id != root {
-          pragma "no copy"
-          pragma "no auto destroy"
-          var temp = localeZeroGlobal.type.chpl__deserialize(data);
+      const fanout = chpl_comm_bcast_fanout() : int;
+      chpl__broadcastGlobalToChildren(localeZeroGlobal.type, data, id,
+                                      root, 0, fanout);
+    }
+  }
+
+  private proc chpl__broadcastGlobalToChildren(type globalType, data,
+                                               id : int, root : int,
+                                               rank : int,
+                                               fanout : int) : void {
+    const firstChild = rank * fanout + 1;
+    const lastChild = min(firstChild + fanout, numLocales) - 1;
+    coforall childRank in firstChild..lastChild do
+      on Locales[(root + childRank) % numLocales] {
+        pragma "no copy"
+        pragma "no auto destroy"
+        var temp = globalType.chpl__deserialize(data);
+
+        const destVoidPtr = chpl_get_global_serialize_table(id);
+        const dest = destVoidPtr:c_ptr(globalType);
 
-          const destVoidPtr = chpl_get_global_serialize_table(id);
-          const dest = destVoidPtr:c_ptr(localeZeroGlobal.type);
+        __primitive("=", dest.deref(), temp);
 
-          __primitive("=", dest.deref(), temp);
+        if childRank * fanout + 1 < numLocales {
+          const myData = dest.deref().chpl__serialize();
+          chpl__broadcastGlobalToChildren(globalType, myData, id,
+                                          root, childRank, fanout);
         }
       }
-    }
   }
 
   proc chpl__destroyBroadcastedGlobal(ref localeZeroGlobal, id : int)
   where chpl__enableSerializedGlobals {
     type globalType = localeZeroGlobal.type;
     const root = here.id;
-    coforall loc in Locales do on loc {
-      if here.id != root {
+    const fanout = chpl_comm_bcast_fanout() : int;
+    chpl__destroyGlobalInChildren(globalType, id, root, 0, fanout);
+  }
+
+  private proc chpl__destroyGlobalInChildren(type globalType, id : int,
+                                             root : int, rank : int,
+                                             fanout : int) : void {
+    const firstChild = rank * fanout + 1;
+    const lastChild = min(firstChild + fanout, numLocales) - 1;
+    coforall childRank in firstChild..lastChild do
+      on Locales[(root + childRank) % numLocales] {
+        if childRank * fanout + 1 < numLocales then
+          chpl__destroyGlobalInChildren(globalType, id, root, childRank,
+                                        fanout);
+
         const voidPtr = chpl_get_global_serialize_table(id);
         var ptr = voidPtr:c_ptr(globalType);
 
@@ -79,6 +116,5 @@ module ChapelSerializedBroadcast {
 
         chpl__autoDestroy(temp);
       }
-    }
   }
 }
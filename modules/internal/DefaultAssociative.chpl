@@ -61,15 +61,26 @@ module DefaultAssociative {
     // We explicitly use processor atomics here since this is not
     // by design a distributed data structure
     var numEntries: chpl__processorAtomicType(int);
-    var tableLock: if parSafe then chpl_LocalSpinlock else nothing;
-    var table: chpl__hashtable(idxType, nothing);
+    // When parSafe, the table does its own lock striping: operations on a
+    // single index only lock that index's segment of the table.
+    var table: chpl__hashtable(idxType, nothing, parSafe);
 
+    // lock/unlock the whole table
     inline proc lockTable() {
-      if parSafe then tableLock.lock();
+      if parSafe then table.lockAll();
     }
 
     inline proc unlockTable() {
-      if parSafe then tableLock.unlock();
+      if parSafe then table.unlockAll();
+    }
+
+    // lock/unlock the part of the table that 'idx' belongs to
+    inline proc lockIdx(idx: idxType) {
+      if parSafe then table.lockKey(idx);
+    }
+
+    inline proc unlockIdx(idx: idxType) {
+      if parSafe then table.unlockKey(idx);
     }
 
     override proc linksDistribution() param return false;
@@ -85,7 +96,7 @@ module DefaultAssociative {
       this.idxType = idxType;
       this.parSafe = parSafe;
       this.dist = dist;
-      this.table = new chpl__hashtable(idxType, nothing);
+      this.table = new chpl__hashtable(idxType, nothing, parSafe);
       this.complete();
 
       // set the rehash helpers
@@ -203,14 +214,13 @@ module DefaultAssociative {
     }
 
     inline proc _isSlotFull(slot: int): bool {
-      return table.table[slot].isFull();
+      return table.isSlotFull(slot);
     }
 
     iter these() {
       for slot in table.allSlots() {
-        ref aSlot = table.table[slot];
-        if aSlot.status == chpl__hash_status.full {
-          yield aSlot.key;
+        if table.isSlotFull(slot) {
+          yield table.table[slot].key;
         }
       }
     }
@@ -221,9 +231,8 @@ module DefaultAssociative {
       }
 
       for slot in table.allSlots(tag=tag) {
-        ref aSlot = table.table[slot];
-        if aSlot.status == chpl__hash_status.full {
-          yield aSlot.key;
+        if table.isSlotFull(slot) {
+          yield table.table[slot].key;
         }
       }
     }
@@ -248,13 +257,12 @@ module DefaultAssociative {
         if followThisDom.dsiNumIndices != this.dsiNumIndices then
           halt("zippered associative domains do not match");
 
-      const otherTable = followThisDom.table.table;
+      const ref otherTable = followThisDom.table;
       for slot in chunk {
-        const ref aSlot = otherTable[slot];
-        if aSlot.isFull() {
+        if otherTable.isSlotFull(slot) {
           var idx = slot;
           if !sameDom {
-            const (match, loc) = table.findFullSlot(aSlot.key);
+            const (match, loc) = table.findFullSlot(otherTable.table[slot].key);
             if !match then halt("zippered associative domains do not match");
             idx = loc;
           }
@@ -274,18 +282,17 @@ module DefaultAssociative {
       on this {
         lockTable();
         for slot in table.allSlots() {
-          ref aSlot = table.table[slot];
-          if aSlot.isFull() {
+          if table.isSlotFull(slot) {
             var tmpKey: idxType;
             var tmpVal: nothing;
-            table.clearSlot(aSlot, tmpKey, tmpVal);
+            table.clearSlot(slot, tmpKey, tmpVal);
             // deinit any array entries
             for arr in _arrs {
               arr._deinitSlot(slot);
             }
           }
-          table.table[slot].status = chpl__hash_status.empty;
         }
+        table.forgetDeletedSlots();
         numEntries.write(0);
         table.maybeShrinkAfterRemove();
         unlockTable();
@@ -293,7 +300,7 @@ module DefaultAssociative {
     }
 
     proc dsiMember(idx: idxType): bool {
-      lockTable(); defer { unlockTable(); }
+      lockIdx(idx); defer { unlockIdx(idx); }
       var (foundFullSlot, slotNum) = table.findFullSlot(idx);
       return foundFullSlot;
     }
@@ -322,12 +329,12 @@ module DefaultAssociative {
       var retVal = 0;
 
       on this {
-        lockTable();
-        defer {
-          unlockTable();
-        }
+        lockIdx(idx);
 
+        // idx may have been moved into the table, so unlock by slot
         (slotNum, retVal) = _add(idx);
+
+        if parSafe then table.unlockSlot(slotNum);
       }
 
       return (slotNum, retVal);
@@ -358,10 +365,7 @@ module DefaultAssociative {
       var retval: int;
 
       on this {
-        lockTable();
-        defer {
-          unlockTable();
-        }
+        lockIdx(idx);
 
         const (foundSlot, slotNum) = table.findFullSlot(idx);
         if foundSlot {
@@ -378,7 +382,13 @@ module DefaultAssociative {
         } else {
           retval = 0;
         }
-        table.maybeShrinkAfterRemove();
+
+        if parSafe {
+          unlockIdx(idx);
+          table.maybeShrinkAfterRemoveConcurrent();
+        } else {
+          table.maybeShrinkAfterRemove();
+        }
       }
       return retval;
     }
@@ -611,13 +621,12 @@ module DefaultAssociative {
         if followThisDom.dsiNumIndices != this.dom.dsiNumIndices then
           halt("zippered associative array does not match the iterated domain");
 
-      const otherTable = followThisDom.table.table;
+      const ref otherTable = followThisDom.table;
       for slot in chunk {
-        const ref aSlot = otherTable[slot];
-        if aSlot.isFull() {
+        if otherTable.isSlotFull(slot) {
           var idx = slot;
           if !sameDom {
-            const (match, loc) = dom.table.findFullSlot(aSlot.key);
+            const (match, loc) = dom.table.findFullSlot(otherTable.table[slot].key);
             if !match then halt("zippered associative array does not match the iterated domain");
             idx = loc;
           }
@@ -54,9 +54,19 @@ module MemTracking
   config const
     memLeaksByDesc: string;
 
-  // Safely cast to size_t instances of memMax and memThreshold.
+  config const
+    memSampleInterval: uint = 0,
+    memSamplePeriod: real = 0.0;
+
+  pragma "no auto destroy"
+  config const
+    memSampleLog: string;
+
+  // Safely cast to size_t instances of memMax, memThreshold, and
+  // memSampleInterval.
   const cMemMax = memMax.safeCast(size_t),
-    cMemThreshold = memThreshold.safeCast(size_t);
+    cMemThreshold = memThreshold.safeCast(size_t),
+    cMemSampleInterval = memSampleInterval.safeCast(size_t);
 
   //
   // This communicates the settings of the various memory tracking
@@ -79,13 +89,18 @@ module MemTracking
                                          ref ret_memMax: size_t,
                                          ref ret_memThreshold: size_t,
                                          ref ret_memLog: c_string,
-                                         ref ret_memLeaksLog: c_string) {
+                                         ref ret_memLeaksLog: c_string,
+                                         ref ret_memSampleInterval: size_t,
+                                         ref ret_memSamplePeriod: real,
+                                         ref ret_memSampleLog: c_string) {
     ret_memTrack = memTrack;
     ret_memStats = memStats;
     ret_memLeaksByType = memLeaksByType;
     ret_memLeaks = memLeaks;
     ret_memMax = cMemMax;
     ret_memThreshold = cMemThreshold;
+    ret_memSampleInterval = cMemSampleInterval;
+    ret_memSamplePeriod = memSamplePeriod;
 
     if (here.id != 0) {
       if memLeaksByDesc.size != 0 {
@@ -115,10 +130,20 @@ module MemTracking
         ret_memLeaksLog = nil;
       }
 
+      if memSampleLog.size != 0 {
+        var local_memSampleLog = memSampleLog;
+        // Intentionally leak the string to persist the underlying buffer
+        local_memSampleLog.isOwned = false;
+        ret_memSampleLog = local_memSampleLog.c_str();
+      } else {
+        ret_memSampleLog = nil;
+      }
+
      } else {
       ret_memLeaksByDesc = memLeaksByDesc.c_str();
       ret_memLog = memLog.c_str();
       ret_memLeaksLog = memLeaksLog.c_str();
+      ret_memSampleLog = memSampleLog.c_str();
     }
   }
 }
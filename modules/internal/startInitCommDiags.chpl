@@ -34,5 +34,9 @@ module startInitCommDiags {
   if printInitCommCounts {
     startCommDiagnostics();
   }
+
+  if printInitCommProfile {
+    startCommProfile();
+  }
 }
 
@@ -36,4 +36,12 @@ module stopInitCommDiags {
     writeln(getCommDiagnostics());
     resetCommDiagnostics();
   }
+
+  if printInitCommProfile {
+    stopCommProfile();
+    printCommProfile();
+    if commProfileFile != "" then
+      try! writeCommProfile(commProfileFile);
+    resetCommProfile();
+  }
 }
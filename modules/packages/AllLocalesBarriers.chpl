@@ -63,32 +63,215 @@
    The implementation is dependent on the communication layer and the
    underlying hardware, but typically some sort of tree or dissemination based
    barrier that's optimized for the network will be used.
+
+   :var:`allLocalesBarrier` can also be used as a split-phase barrier, via
+   its :proc:`~Barriers.Barrier.notify()`, :proc:`~Barriers.Barrier.wait()`,
+   and :proc:`~Barriers.Barrier.check()` methods.  This lets a task start the
+   barrier, do local work that doesn't depend on the other locales, and then
+   wait for the barrier to finish.  The split-phase barrier is a
+   dissemination barrier built on remote atomic operations, so on networks
+   that support atomics it makes progress without involving the tasks on the
+   other locales.  Each call to :proc:`~Barriers.Barrier.check()` advances
+   the barrier as far as it can without blocking, so calling it now and then
+   during the local work can hide more of the barrier latency.  As with the
+   :proc:`~Barriers.Barrier.barrier()` method, every participating task on
+   each locale must call :proc:`~Barriers.Barrier.notify()` and then
+   :proc:`~Barriers.Barrier.wait()`.
+
+   .. code-block:: chapel
+
+     use AllLocalesBarriers;
+
+     coforall loc in Locales do on loc {
+       for step in 1..numSteps {
+         exchangeHalos();
+         allLocalesBarrier.notify();
+         computeInterior();
+         allLocalesBarrier.wait();
+         computeBoundary();
+       }
+     }
 */
 module AllLocalesBarriers {
   use BlockDist, Barriers;
+  import HaltWrappers;
 
   pragma "no doc"
   class AllLocalesBarrier: BarrierBaseType {
 
     const BarrierSpace = LocaleSpace dmapped Block(LocaleSpace);
     var globalBarrier: [BarrierSpace] unmanaged aBarrier(reusable=true, procAtomics=true, hackIntoCommBarrier=true);
+    var splitBarrier: [BarrierSpace] unmanaged DisseminationBarrier;
 
     proc init(numTasksPerLocale: int) {
       globalBarrier = [b in BarrierSpace] new unmanaged aBarrier(numTasksPerLocale, reusable=true, procAtomics=true, hackIntoCommBarrier=true);
+      splitBarrier = [b in BarrierSpace] new unmanaged DisseminationBarrier(numTasksPerLocale);
+      this.complete();
+      forall b in splitBarrier do
+        b.connect(splitBarrier);
     }
 
     proc deinit() {
       [b in globalBarrier] delete b;
+      [b in splitBarrier] delete b;
     }
 
     override proc barrier() {
       globalBarrier.localAccess[here.id].barrier();
     }
 
+    override proc notify() {
+      splitBarrier.localAccess[here.id].notify();
+    }
+
+    override proc wait() {
+      splitBarrier.localAccess[here.id].wait();
+    }
+
+    override proc check(): bool {
+      return splitBarrier.localAccess[here.id].check();
+    }
+
     proc reset(numTasksPerLocale: int) {
       [b in globalBarrier] b.reset(numTasksPerLocale);
+      [b in splitBarrier] b.reset(numTasksPerLocale);
     }
   }
 
+  // One per round of the dissemination barrier on each locale.  The locale
+  // that signals us in that round does a remote add on it.
+  pragma "no doc"
+  class DisseminationFlag {
+    var count: atomic int;
+  }
+
+  /* The per-locale part of the split-phase barrier.
+
+     In round k of a barrier, locale i signals locale (i + 2**k) % numLocales
+     and then waits to be signaled by locale (i - 2**k) % numLocales.  After
+     ceil(log2(numLocales)) rounds every locale has heard, directly or
+     indirectly, from every other one.  The flags count signals over the life
+     of the barrier rather than being cleared, so in barrier number e a
+     locale is waiting for its round k flag to reach e.  A locale can be at
+     most one barrier ahead of the ones signaling it, so this is never
+     ambiguous.
+
+     Local tasks join the way they do in a reusable aBarrier: the last one to
+     notify starts the barrier across locales, and no task leaves wait()
+     until all of them have gotten there.  Whichever waiting (or checking)
+     task holds `progressLock` advances the rounds.
+   */
+  pragma "no doc"
+  class DisseminationBarrier {
+    const numRounds = if numLocales > 1 then log2(numLocales-1) + 1 else 0;
+
+    var n: int;
+    var notified: chpl__processorAtomicType(int);
+    var leaving: chpl__processorAtomicType(int);
+
+    // Barriers this locale has started, finished, and that all local tasks
+    // have left the wait() for.
+    var started: int;
+    var finished: chpl__processorAtomicType(int);
+    var released: chpl__processorAtomicType(int);
+
+    // The round we have signaled and are waiting to be signaled in.
+    var round: int;
+    var progressLock: chpl__processorAtomicType(bool);
+
+    var inFlags: [0..#numRounds] unmanaged DisseminationFlag;
+    var outFlags: [0..#numRounds] unmanaged DisseminationFlag?;
+
+    proc init(n: int) {
+      this.n = n;
+      this.inFlags = [0..#numRounds] new unmanaged DisseminationFlag();
+    }
+
+    proc deinit() {
+      for f in inFlags do
+        delete f;
+    }
+
+    proc connect(ref bars) {
+      for k in 0..#numRounds {
+        const partner = (here.id + 2**k) % numLocales;
+        outFlags[k] = bars[partner].inFlags[k];
+      }
+    }
+
+    proc reset(nTasks: int) {
+      n = nTasks;
+      notified.write(0);
+      leaving.write(0);
+    }
+
+    proc notify() {
+      const myc = notified.fetchAdd(1);
+      if boundsChecking && myc >= n {
+        HaltWrappers.boundsCheckHalt("Too many callers to notify()");
+      }
+      if myc == n-1 {
+        notified.write(0);
+        lock();
+        started += 1;
+        if numRounds == 0 {
+          finished.write(started);
+        } else {
+          round = 0;
+          outFlags[0]!.count.add(1);
+        }
+        unlock();
+      }
+    }
+
+    proc wait() {
+      const myBarrier = released.read() + 1;
+      while !progress(myBarrier) do
+        chpl_task_yield();
+      const myc = leaving.fetchAdd(1);
+      if myc == n-1 {
+        leaving.write(0);
+        released.write(myBarrier);
+      } else {
+        released.waitFor(myBarrier);
+      }
+    }
+
+    proc check(): bool {
+      return progress(released.read() + 1);
+    }
+
+    // Advance the rounds of the current barrier as far as we can without
+    // blocking, and return whether barrier number `b` has finished.
+    proc progress(b: int): bool {
+      if finished.read() >= b then
+        return true;
+      if progressLock.testAndSet() then
+        return false;
+      if finished.read() < started {
+        while round < numRounds && inFlags[round].count.read() >= started {
+          round += 1;
+          if round < numRounds then
+            outFlags[round]!.count.add(1);
+        }
+        if round == numRounds then
+          finished.write(started);
+      }
+      unlock();
+      return finished.read() >= b;
+    }
+
+    inline proc lock() {
+      while progressLock.testAndSet() do
+        chpl_task_yield();
+    }
+
+    inline proc unlock() {
+      progressLock.clear();
+    }
+  }
+
+  private extern proc chpl_task_yield();
+
   const allLocalesBarrier: AllLocalesBarrier = new AllLocalesBarrier(1);
 }
@@ -0,0 +1,357 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+   .. warning::
+     This module represents work in progress. The API is unstable and likely to
+     change over time.
+
+   This module provides aggregated copies for trivially copyable types, for
+   loops that copy many elements to or from scattered remote locations.
+   Rather than doing one fine-grained PUT or GET per element, an aggregator
+   buffers copies by locale and does them in bulk: a full buffer is moved to
+   the remote locale with a single PUT and applied there by one ``on``
+   statement. This works the same way under every ``CHPL_COMM`` setting.
+
+   :record:`DstAggregator` aggregates copies to remote destinations (a
+   scatter), and :record:`SrcAggregator` aggregates copies from remote
+   sources (a gather). Aggregators are meant to be used as task-private
+   variables in a ``forall``, so each task buffers on its own and flushes
+   what it has left when it finishes:
+
+   .. code-block:: chapel
+
+     use BlockDist, CopyAggregation;
+
+     const size = 10000;
+     const space = {0..#size};
+     const D = space dmapped Block(space);
+     var A, reversedA: [D] int = D;
+
+     // reversedA[size-1-i] = A[i], with remote writes aggregated
+     forall i in D with (var agg = new DstAggregator(int)) do
+       agg.copy(reversedA[size-1-i], A[i]);
+
+     // A[i] = reversedA[size-1-i], with remote reads aggregated
+     forall i in D with (var agg = new SrcAggregator(int)) do
+       agg.copy(A[i], reversedA[size-1-i]);
+
+   Copies are not ordered with respect to other operations. They are only
+   guaranteed to be done when the aggregator is flushed, either explicitly
+   with ``flush()`` or when it is deinitialized, which for a task-private
+   aggregator is at the end of its task.
+
+   For a :record:`SrcAggregator` the destination must be local to the task
+   doing the copy, as it is in the gather above where each iteration writes
+   ``A[i]`` from the locale that owns it. Copies to remote destinations are
+   done immediately instead.
+ */
+module CopyAggregation {
+  private use CPtr;
+  private use SysCTypes;
+
+  /* The number of copies an aggregator buffers for each locale. */
+  config const copyAggregationBufferSize = 4096;
+
+  /* The number of copies after which an aggregator yields, giving other
+     tasks on its locale (including ones applying remote flushes) a
+     chance to run. */
+  config const copyAggregationYieldFrequency = 1024;
+
+  pragma "no doc"
+  private inline proc getAddr(const ref p): c_ptr(p.type) {
+    return __primitive("_wide_get_addr", p): c_ptr(p.type);
+  }
+
+  /*
+    Aggregates copies to remote destinations. Copies to a destination on
+    the current locale are done immediately.
+   */
+  record DstAggregator {
+    /* The type of the elements being copied */
+    type elemType;
+    pragma "no doc"
+    type aggType = (c_ptr(elemType), elemType);
+    pragma "no doc"
+    const bufferSize = copyAggregationBufferSize;
+    pragma "no doc"
+    const myLocaleSpace = 0..#numLocales;
+    pragma "no doc"
+    var opsUntilYield = copyAggregationYieldFrequency;
+    // local buffers, allocated the first time we copy to a locale
+    pragma "no doc"
+    var lBuffers: [myLocaleSpace] c_ptr(aggType);
+    // remote buffers, each allocated on the locale it is for
+    pragma "no doc"
+    var rBuffers: [myLocaleSpace] c_ptr(aggType);
+    pragma "no doc"
+    var bufferIdxs: [myLocaleSpace] int;
+
+    pragma "no doc"
+    proc init(type elemType) {
+      if !isPODType(elemType) then
+        compilerError("DstAggregator is only supported for trivially copyable types");
+      this.elemType = elemType;
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      flush(freeBuffers=true);
+    }
+
+    /*
+      Do all of the buffered copies.
+     */
+    proc flush() {
+      flush(freeBuffers=false);
+    }
+
+    pragma "no doc"
+    proc flush(param freeBuffers: bool) {
+      for loc in myLocaleSpace {
+        _flushBuffer(loc, freeBuffers);
+        if freeBuffers && lBuffers[loc] != nil {
+          c_free(lBuffers[loc]);
+          lBuffers[loc] = nil;
+        }
+      }
+    }
+
+    /*
+      Copy ``srcVal`` to ``dst``. The copy is buffered if ``dst`` is remote.
+     */
+    inline proc copy(ref dst: elemType, const in srcVal: elemType) {
+      const loc = dst.locale.id;
+      if loc == here.id {
+        dst = srcVal;
+        return;
+      }
+
+      if lBuffers[loc] == nil then
+        lBuffers[loc] = c_malloc(aggType, bufferSize);
+
+      ref bufferIdx = bufferIdxs[loc];
+      lBuffers[loc][bufferIdx] = (getAddr(dst), srcVal);
+      bufferIdx += 1;
+
+      // Flush a full buffer. If it has been a while since we let other
+      // tasks run, yield so that we don't hold up remote flushes.
+      if bufferIdx == bufferSize {
+        _flushBuffer(loc, freeBuffers=false);
+        opsUntilYield = copyAggregationYieldFrequency;
+      } else if opsUntilYield == 0 {
+        chpl_task_yield();
+        opsUntilYield = copyAggregationYieldFrequency;
+      } else {
+        opsUntilYield -= 1;
+      }
+    }
+
+    pragma "no doc"
+    proc _flushBuffer(loc: int, param freeBuffers: bool) {
+      const myBufferIdx = bufferIdxs[loc];
+      if myBufferIdx == 0 {
+        if freeBuffers && rBuffers[loc] != nil {
+          const rBuffer = rBuffers[loc];
+          on Locales[loc] do c_free(rBuffer);
+          rBuffers[loc] = nil;
+        }
+        return;
+      }
+
+      if rBuffers[loc] == nil {
+        const size = bufferSize;
+        var rBuffer: c_ptr(aggType);
+        on Locales[loc] do rBuffer = c_malloc(aggType, size);
+        rBuffers[loc] = rBuffer;
+      }
+
+      // Move the buffered copies to the remote locale and do them there
+      const rBuffer = rBuffers[loc];
+      __primitive("chpl_comm_array_put", lBuffers[loc][0], loc, rBuffer[0],
+                  myBufferIdx);
+      on Locales[loc] {
+        for i in 0..#myBufferIdx {
+          const (dstAddr, srcVal) = rBuffer[i];
+          dstAddr.deref() = srcVal;
+        }
+        if freeBuffers then
+          c_free(rBuffer);
+      }
+      if freeBuffers then
+        rBuffers[loc] = nil;
+      bufferIdxs[loc] = 0;
+    }
+  }
+
+  /*
+    Aggregates copies from remote sources. The destination must be local;
+    copies from a source on the current locale, and copies to a remote
+    destination, are done immediately.
+   */
+  record SrcAggregator {
+    /* The type of the elements being copied */
+    type elemType;
+    pragma "no doc"
+    const bufferSize = copyAggregationBufferSize;
+    pragma "no doc"
+    const myLocaleSpace = 0..#numLocales;
+    pragma "no doc"
+    var opsUntilYield = copyAggregationYieldFrequency;
+    // where the copies go, and where they come from
+    pragma "no doc"
+    var dstAddrs: [myLocaleSpace] c_ptr(c_ptr(elemType));
+    pragma "no doc"
+    var lSrcAddrs: [myLocaleSpace] c_ptr(c_ptr(elemType));
+    // the remote locale's copy of the source addresses and values
+    pragma "no doc"
+    var rSrcAddrs: [myLocaleSpace] c_ptr(c_ptr(elemType));
+    pragma "no doc"
+    var rSrcVals: [myLocaleSpace] c_ptr(elemType);
+    // the values, once they come back
+    pragma "no doc"
+    var lSrcVals: [myLocaleSpace] c_ptr(elemType);
+    pragma "no doc"
+    var bufferIdxs: [myLocaleSpace] int;
+
+    pragma "no doc"
+    proc init(type elemType) {
+      if !isPODType(elemType) then
+        compilerError("SrcAggregator is only supported for trivially copyable types");
+      this.elemType = elemType;
+    }
+
+    pragma "no doc"
+    proc deinit() {
+      flush(freeBuffers=true);
+    }
+
+    /*
+      Do all of the buffered copies.
+     */
+    proc flush() {
+      flush(freeBuffers=false);
+    }
+
+    pragma "no doc"
+    proc flush(param freeBuffers: bool) {
+      for loc in myLocaleSpace {
+        _flushBuffer(loc, freeBuffers);
+        if freeBuffers && dstAddrs[loc] != nil {
+          c_free(dstAddrs[loc]);
+          c_free(lSrcAddrs[loc]);
+          c_free(lSrcVals[loc]);
+          dstAddrs[loc] = nil;
+          lSrcAddrs[loc] = nil;
+          lSrcVals[loc] = nil;
+        }
+      }
+    }
+
+    /*
+      Copy ``src`` to ``dst``. The copy is buffered if ``src`` is remote
+      and ``dst`` is local.
+     */
+    inline proc copy(ref dst: elemType, const ref src: elemType) {
+      const loc = src.locale.id;
+      if loc == here.id || dst.locale.id != here.id {
+        dst = src;
+        return;
+      }
+
+      if dstAddrs[loc] == nil {
+        dstAddrs[loc] = c_malloc(c_ptr(elemType), bufferSize);
+        lSrcAddrs[loc] = c_malloc(c_ptr(elemType), bufferSize);
+        lSrcVals[loc] = c_malloc(elemType, bufferSize);
+      }
+
+      ref bufferIdx = bufferIdxs[loc];
+      dstAddrs[loc][bufferIdx] = getAddr(dst);
+      lSrcAddrs[loc][bufferIdx] = getAddr(src);
+      bufferIdx += 1;
+
+      if bufferIdx == bufferSize {
+        _flushBuffer(loc, freeBuffers=false);
+        opsUntilYield = copyAggregationYieldFrequency;
+      } else if opsUntilYield == 0 {
+        chpl_task_yield();
+        opsUntilYield = copyAggregationYieldFrequency;
+      } else {
+        opsUntilYield -= 1;
+      }
+    }
+
+    pragma "no doc"
+    proc _flushBuffer(loc: int, param freeBuffers: bool) {
+      const myBufferIdx = bufferIdxs[loc];
+      if myBufferIdx == 0 {
+        if freeBuffers && rSrcAddrs[loc] != nil {
+          const (rAddrs, rVals) = (rSrcAddrs[loc], rSrcVals[loc]);
+          on Locales[loc] {
+            c_free(rAddrs);
+            c_free(rVals);
+          }
+          rSrcAddrs[loc] = nil;
+          rSrcVals[loc] = nil;
+        }
+        return;
+      }
+
+      if rSrcAddrs[loc] == nil {
+        const size = bufferSize;
+        var rAddrs: c_ptr(c_ptr(elemType));
+        var rVals: c_ptr(elemType);
+        on Locales[loc] {
+          rAddrs = c_malloc(c_ptr(elemType), size);
+          rVals = c_malloc(elemType, size);
+        }
+        rSrcAddrs[loc] = rAddrs;
+        rSrcVals[loc] = rVals;
+      }
+
+      // Send the source addresses, read the values on the remote locale,
+      // and bring them back. The comm primitives take a c_ptr argument as
+      // the address of the data rather than as an element, so the address
+      // buffers are passed as themselves.
+      const (rAddrs, rVals) = (rSrcAddrs[loc], rSrcVals[loc]);
+      __primitive("chpl_comm_array_put", lSrcAddrs[loc], loc, rAddrs,
+                  myBufferIdx);
+      on Locales[loc] {
+        for i in 0..#myBufferIdx do
+          rVals[i] = rAddrs[i].deref();
+      }
+      __primitive("chpl_comm_array_get", lSrcVals[loc][0], loc, rVals[0],
+                  myBufferIdx);
+
+      const (dsts, vals) = (dstAddrs[loc], lSrcVals[loc]);
+      for i in 0..#myBufferIdx do
+        dsts[i].deref() = vals[i];
+
+      if freeBuffers {
+        on Locales[loc] {
+          c_free(rAddrs);
+          c_free(rVals);
+        }
+        rSrcAddrs[loc] = nil;
+        rSrcVals[loc] = nil;
+      }
+      bufferIdxs[loc] = 0;
+    }
+  }
+}
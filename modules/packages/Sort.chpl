@@ -458,7 +458,10 @@ proc sort(Data: [?Dom] ?eltType, comparator:?rec=defaultComparator) {
   if Dom.low >= Dom.high then
     return;
 
-  if radixSortOk(Data, comparator) {
+  if DistributedSampleSort.distributedSampleSortOk(Data) &&
+     Data.targetLocales().size > 1 {
+    DistributedSampleSort.distributedSampleSort(Data, comparator=comparator);
+  } else if radixSortOk(Data, comparator) {
     MSBRadixSort.msbRadixSort(Data, comparator=comparator);
   } else {
     QuickSort.quickSort(Data, comparator=comparator);
@@ -2792,6 +2795,281 @@ module TwoArraySampleSort {
   }
 }
 
+pragma "no doc"
+module DistributedSampleSort {
+  import Sort.{defaultComparator, chpl_compare, sort, ShallowCopy};
+  private use BlockDist;
+  private use SysCTypes;
+  private use CPtr;
+
+  private param debug = false;
+
+  // Each locale contributes this many regular samples (or numLocales,
+  // whichever is larger) to the splitter selection.
+  private const minSamplesPerLocale = 64;
+
+  extern type chpl_comm_nb_handle_t = c_void_ptr;
+  private extern proc chpl_comm_put_nb(addr: c_void_ptr, node: int(32),
+                                       raddr: c_void_ptr, size: size_t,
+                                       commID: int(32), ln: c_int,
+                                       fn: int(32)): chpl_comm_nb_handle_t;
+  private extern proc chpl_comm_wait_nb_some(h: c_ptr(chpl_comm_nb_handle_t),
+                                             nhandles: size_t);
+
+  // The data one locale holds while the sort is in progress.
+  class DistributedSampleSortLocaleState {
+    type eltType;
+    const numLocales: int;
+
+    // This locale's part of the input, sorted locally
+    var localDom: domain(1);
+    var LocalData: [localDom] eltType;
+    // LocalData[bucketStarts[d]..<bucketStarts[d+1]] goes to locale d
+    var bucketStarts: [0..numLocales] int;
+
+    // The runs received from every locale, and where each one starts
+    var recvDom: domain(1);
+    var Recv: [recvDom] eltType;
+    var runStarts: [0..numLocales] int;
+    var recvPtr: c_void_ptr;
+    var node: int(32);
+
+    proc init(type eltType, numLocales: int) {
+      this.eltType = eltType;
+      this.numLocales = numLocales;
+    }
+  }
+
+  // Block arrays of POD elements can be sorted without moving single
+  // elements between locales.
+  proc distributedSampleSortOk(Data:[]) param {
+    return isSubtype(Data._value.type, BlockArr) &&
+           !Data.domain.stridable &&
+           isPODType(Data.eltType);
+  }
+
+  /*
+    Sort a Block-distributed 1-D array with a single all-to-all exchange:
+
+      1. every locale sorts its own elements (radix sort where possible)
+      2. regular samples of the sorted runs choose numLocales-1 splitters
+      3. every locale sends each of its buckets to the locale that owns
+         it with one nonblocking put
+      4. every locale merges the sorted runs it received and copies the
+         result into its place in Data
+
+    Elements are moved as raw bytes, so eltType must be a POD type.
+   */
+  proc distributedSampleSort(Data:[], comparator:?rec=defaultComparator) {
+    type eltType = Data.eltType;
+
+    if !isPODType(eltType) then
+      compilerError("distributedSampleSort requires a POD element type");
+    if !Data.hasSingleLocalSubdomain() then
+      compilerError("distributedSampleSort needs single local subdomain");
+
+    const targetLocs = Data.targetLocales();
+    const numLocales = targetLocs.size;
+    const LocaleSpace = {0..#numLocales};
+    const locs: [LocaleSpace] locale = for l in targetLocs do l;
+
+    const samplesPerLocale = max(numLocales, minSamplesPerLocale);
+    var Samples: [0..#numLocales*samplesPerLocale] eltType;
+    var numSamples: [LocaleSpace] int;
+    var Counts: [0..#numLocales*numLocales] int;
+    var states: [LocaleSpace] unmanaged DistributedSampleSortLocaleState(eltType)?;
+
+    // 1. sort locally and take regular samples
+    coforall (loc, lid) in zip(locs, LocaleSpace) with (ref states) do on loc {
+      const ls = Data.localSubdomain();
+      const n = ls.size;
+      const s = new unmanaged DistributedSampleSortLocaleState(eltType,
+                                                               numLocales);
+      s.localDom = {0..#n};
+      if n > 0 {
+        ShallowCopy.shallowCopy(s.LocalData, 0, Data, ls.low, n);
+        sort(s.LocalData, comparator);
+
+        var MySamples: [0..#samplesPerLocale] eltType;
+        for i in 0..#samplesPerLocale do
+          MySamples[i] = s.LocalData[(i*n) / samplesPerLocale];
+        Samples[lid*samplesPerLocale..#samplesPerLocale] = MySamples;
+        numSamples[lid] = samplesPerLocale;
+      }
+      states[lid] = s;
+    }
+
+    // 2. choose the splitters
+    const totalSamples = + reduce numSamples;
+    var AllSamples: [0..#totalSamples] eltType;
+    {
+      var next = 0;
+      for lid in LocaleSpace {
+        const k = numSamples[lid];
+        if k > 0 {
+          AllSamples[next..#k] = Samples[lid*samplesPerLocale..#k];
+          next += k;
+        }
+      }
+    }
+    sort(AllSamples, comparator);
+    var Splitters: [0..#numLocales-1] eltType;
+    for i in Splitters.domain do
+      Splitters[i] = AllSamples[((i+1)*totalSamples) / numLocales];
+
+    if debug then
+      writeln("distributedSampleSort splitters ", Splitters);
+
+    // 3a. find the bucket boundaries in each locally sorted run
+    coforall (loc, lid) in zip(locs, LocaleSpace) do on loc {
+      const s = states[lid]!;
+      const MySplitters = Splitters;
+      const n = s.localDom.size;
+      var lo = 0;
+      s.bucketStarts[0] = 0;
+      for d in 0..#numLocales-1 {
+        // find the first element > MySplitters[d]
+        var hi = n;
+        while lo < hi {
+          const mid = lo + (hi - lo) / 2;
+          if chpl_compare(s.LocalData[mid], MySplitters[d], comparator) <= 0 then
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+        s.bucketStarts[d+1] = lo;
+      }
+      s.bucketStarts[numLocales] = n;
+
+      var MyCounts: [LocaleSpace] int;
+      for d in LocaleSpace do
+        MyCounts[d] = s.bucketStarts[d+1] - s.bucketStarts[d];
+      Counts[lid*numLocales..#numLocales] = MyCounts;
+    }
+
+    // 3b. allocate the receive buffers
+    coforall (loc, lid) in zip(locs, LocaleSpace) do on loc {
+      const s = states[lid]!;
+      const AllCounts = Counts;
+      s.runStarts[0] = 0;
+      for src in LocaleSpace do
+        s.runStarts[src+1] = s.runStarts[src] + AllCounts[src*numLocales+lid];
+      const recvSize = s.runStarts[numLocales];
+      s.recvDom = {0..#recvSize};
+      s.recvPtr = if recvSize > 0 then c_ptrTo(s.Recv[0]):c_void_ptr
+                                  else c_nil;
+      s.node = chpl_nodeID;
+    }
+
+    // 3c. the exchange: one put per (source, destination) pair
+    coforall (loc, lid) in zip(locs, LocaleSpace) do on loc {
+      const s = states[lid]!;
+      const AllCounts = Counts;
+      var handles: [LocaleSpace] chpl_comm_nb_handle_t;
+      var numHandles = 0;
+      // start with a different destination on every locale
+      for i in LocaleSpace {
+        const d = (lid + i) % numLocales;
+        const count = s.bucketStarts[d+1] - s.bucketStarts[d];
+        if count == 0 then continue;
+
+        // my run goes after the runs from lower-numbered locales
+        var offset = 0;
+        for src in 0..#lid do
+          offset += AllCounts[src*numLocales+d];
+
+        const dst = states[d]!;
+        const (recvPtr, node) = (dst.recvPtr, dst.node);
+        handles[numHandles] =
+          chpl_comm_put_nb(c_ptrTo(s.LocalData[s.bucketStarts[d]]):c_void_ptr,
+                           node,
+                           (recvPtr:c_ptr(eltType) + offset):c_void_ptr,
+                           count:size_t * c_sizeof(eltType),
+                           -1, 0, 0);
+        numHandles += 1;
+      }
+      chpl_comm_wait_nb_some(c_ptrTo(handles[0]), numHandles:size_t);
+    }
+
+    // 4. merge the received runs and put the result in place
+    coforall (loc, lid) in zip(locs, LocaleSpace) do on loc {
+      const s = states[lid]!;
+      const AllCounts = Counts;
+      s.localDom = {0..-1}; // no longer needed
+
+      var offset = 0;
+      for d in 0..#lid do
+        for src in LocaleSpace do
+          offset += AllCounts[src*numLocales+d];
+
+      const n = s.recvDom.size;
+      if n > 0 {
+        var Scratch: [s.recvDom] eltType;
+        const inRecv = mergeRuns(s.Recv, Scratch, s.runStarts, comparator);
+        if inRecv then
+          ShallowCopy.shallowCopy(Data, Data.domain.low + offset, s.Recv, 0, n);
+        else
+          ShallowCopy.shallowCopy(Data, Data.domain.low + offset, Scratch, 0, n);
+      }
+      delete s;
+    }
+  }
+
+  // Merges the sorted runs A[runStarts[i]..<runStarts[i+1]] pairwise,
+  // alternating between A and Scratch. Returns true if the result ended
+  // up in A.
+  private proc mergeRuns(ref A:[], ref Scratch:[], runStarts:[], comparator) {
+    var numRuns = runStarts.size - 1;
+    var boundsDom = {0..numRuns};
+    var bounds: [boundsDom] int = runStarts;
+    var inA = true;
+    while numRuns > 1 {
+      const newNumRuns = (numRuns + 1) / 2;
+      forall r in 0..#newNumRuns {
+        const lo = bounds[2*r];
+        const mid = bounds[min(2*r+1, numRuns)];
+        const hi = bounds[min(2*r+2, numRuns)];
+        if inA then
+          mergeTwo(Scratch, A, lo, mid, hi, comparator);
+        else
+          mergeTwo(A, Scratch, lo, mid, hi, comparator);
+      }
+      const newBounds = [r in 0..newNumRuns] bounds[min(2*r, numRuns)];
+      boundsDom = {0..newNumRuns};
+      bounds = newBounds;
+      numRuns = newNumRuns;
+      inA = !inA;
+    }
+    return inA;
+  }
+
+  // Merges Src[lo..<mid] and Src[mid..<hi] into Dst[lo..<hi]
+  private proc mergeTwo(ref Dst:[], const ref Src:[], lo:int, mid:int, hi:int,
+                        comparator) {
+    var i = lo, j = mid, k = lo;
+    while i < mid && j < hi {
+      if chpl_compare(Src[j], Src[i], comparator) < 0 {
+        Dst[k] = Src[j];
+        j += 1;
+      } else {
+        Dst[k] = Src[i];
+        i += 1;
+      }
+      k += 1;
+    }
+    while i < mid {
+      Dst[k] = Src[i];
+      i += 1;
+      k += 1;
+    }
+    while j < hi {
+      Dst[k] = Src[j];
+      j += 1;
+      k += 1;
+    }
+  }
+}
+
 pragma "no doc"
 module InPlacePartitioning {
   // TODO -- based on ips4o
@@ -138,6 +138,34 @@
   was executed on locale 0, and a remote get and a remote put were
   executed on locale 1.
 
+  **Profiling Communication by Callsite**
+
+  On-the-fly reporting says exactly where each operation came from, but
+  in a big program it produces far too much output to read, and counting
+  says how many operations there were but not where they came from.  A
+  communication profile falls in between: it counts operations, and the
+  bytes they moved, separately for each combination of source location,
+  kind of operation, and peer locale.  The result shows which few lines
+  of a program account for most of its communication::
+
+    startCommProfile();
+    // between start/stop calls, profile comm ops initiated on any locale
+    stopCommProfile();
+    // print the busiest callsites, most operations first
+    printCommProfile();
+    // and/or write all of them to a file for further processing
+    writeCommProfile("comm-profile.csv");
+
+  Passing ``time=true`` to :proc:`startCommProfile` also records the
+  time tasks spent in blocking GETs, PUTs, and remote executions.  This
+  adds a clock read on each side of those operations.  At present it is
+  only done by the ``gasnet`` and ``ofi`` communication layers.
+
+  Counting is done in per-thread tables, so profiling has much less
+  overhead than on-the-fly reporting, but it is still more than just
+  counting.  The :param:`printInitCommProfile` config param profiles the
+  whole run, the way :param:`printInitCommCounts` counts it.
+
   **Studying Communication During Module Initialization**
 
   It is hard for a programmer to determine exactly what happens during
@@ -168,6 +196,8 @@
  */
 module CommDiagnostics
 {
+  private use SysCTypes;
+
   /*
     Print out stack traces for comm events printed after startVerboseComm
    */
@@ -179,12 +209,19 @@ module CommDiagnostics
     fields are those expected to have unpredictable values for multiple
     executions of the same code sequence.  Setting this to `true` causes
     such fields, if non-zero, to be included when a `commDiagnostics`
-    value is written.  At present the only unstable field is the `amo`
+    value is written.  At present the unstable fields are the `amo`
     counter, whose instability is due to the use of atomic reads in spin
-    loops that wait for parallelism and on-statements to complete.
+    loops that wait for parallelism and on-statements to complete, and
+    the `unordered_flush_*` counters, which depend on how the work was
+    divided among tasks.
    */
   config param commDiagsPrintUnstable = false;
 
+  private proc isUnstableField(param name: string) param {
+    return name == 'amo' || name == 'unordered_flush_full' ||
+           name == 'unordered_flush_fence';
+  }
+
   /* Aggregated communication operation counts.  This record type is
      defined in the same way by both the underlying comm layer(s) and
      this module, because we don't have a good way to inherit types back
@@ -237,6 +274,48 @@ module CommDiagnostics
       non-blocking remote executions
      */
     var execute_on_nb: uint(64);
+    /*
+      remote cache GETs satisfied by data that a different thread
+      brought into the cache (only with
+      ``CHPL_RT_CACHE_REMOTE_SHARED=true``)
+     */
+    var cache_shared_hit: uint(64);
+    /*
+      remote cache GETs satisfied entirely from the cache
+     */
+    var cache_get_hits: uint(64);
+    /*
+      remote cache GETs that had to fetch at least part of a page
+     */
+    var cache_get_misses: uint(64);
+    /*
+      remote cache PUTs to a page that was already in the cache
+     */
+    var cache_put_hits: uint(64);
+    /*
+      remote cache PUTs to a page that was not in the cache
+     */
+    var cache_put_misses: uint(64);
+    /*
+      pages evicted from the remote cache
+     */
+    var cache_evictions: uint(64);
+    /*
+      cache lines that were fetched into the remote cache (by a miss
+      or by readahead) but evicted without ever being read
+     */
+    var cache_lines_unused: uint(64);
+    /*
+      flushes of a task's buffered unordered operations that happened
+      because the buffer was full (only with ``CHPL_COMM=ofi``)
+     */
+    var unordered_flush_full: uint(64);
+    /*
+      flushes of a task's buffered unordered operations that happened
+      because of a fence, including the one at task end (only with
+      ``CHPL_COMM=ofi``)
+     */
+    var unordered_flush_fence: uint(64);
 
     proc writeThis(c) throws {
       use Reflection;
@@ -247,7 +326,7 @@ module CommDiagnostics
         param name = getFieldName(chpl_commDiagnostics, i);
         const val = getField(this, i);
         if val != 0 {
-          if commDiagsPrintUnstable || name != 'amo' {
+          if commDiagsPrintUnstable || !isUnstableField(name) {
             if first then first = false; else c <~> ", ";
             c <~> name <~> " = " <~> val;
           }
@@ -285,6 +364,36 @@ module CommDiagnostics
 
   private extern proc chpl_comm_getDiagnosticsHere(out cd: commDiagnostics);
 
+  /*
+    The parameters the remote cache (``--cache-remote``) is currently
+    using on a locale.  Unless ``CHPL_RT_CACHE_REMOTE_ADAPT=false``, the
+    cache adjusts the queue sizes and readahead limits as the program
+    runs, based on how much of the data it fetches goes unused.  All
+    fields are zero if the remote cache is not enabled.
+   */
+  extern record chpl_cacheParameters {
+    /* size of a cache page in bytes */
+    var page_size: int(64);
+    /* size of a cache line in bytes */
+    var line_size: int(64);
+    /* capacity of the cache in pages (see ``CHPL_RT_CACHE_REMOTE_SIZE``) */
+    var cache_pages: int(64);
+    /* current limit on pages that have been read only once */
+    var ain_pages: int(64);
+    /* limit on remembered pages that have already been evicted */
+    var aout_pages: int(64);
+    /* current limit on sequential readahead, in bytes */
+    var readahead_bytes: int(64);
+    /* whether a miss next to valid lines fetches the rest of the page */
+    var within_page_readahead: int(64);
+  }
+
+  private extern proc chpl_comm_getCacheParametersHere(out cp: chpl_cacheParameters);
+
+  private extern proc chpl_comm_getNumAmHandlersHere(): c_int;
+
+  private extern proc chpl_comm_getAmHandlerRequestsHere(i: c_int): uint(64);
+
   /*
     Start on-the-fly reporting of communication initiated on any locale.
    */
@@ -378,6 +487,262 @@ module CommDiagnostics
     return cd;
   }
 
+  /*
+    Retrieve the current remote cache parameters for this locale.
+
+    :returns: the parameters in use by the remote cache on this locale
+    :rtype: `chpl_cacheParameters`
+   */
+  proc getRemoteCacheParametersHere() {
+    var cp: chpl_cacheParameters;
+    chpl_comm_getCacheParametersHere(cp);
+    return cp;
+  }
+
+  /*
+    Retrieve the number of active message requests (remote ``on``
+    statements, and AMOs and RMA the network can't do directly) that
+    each active message handler thread on this locale has processed
+    while communication diagnostics were on.  With the ofi comm layer
+    the number of handler threads is set by
+    ``CHPL_RT_COMM_OFI_NUM_AM_HANDLERS``.  Comm layers that don't
+    report per-handler counts return an empty array.
+
+    :returns: counts of AM requests processed, one per handler thread
+    :rtype: `[] uint(64)`
+   */
+  proc getAMHandlerLoadHere() {
+    const numHandlers = chpl_comm_getNumAmHandlersHere(): int;
+    var A: [0..#numHandlers] uint(64);
+    for i in A.domain do
+      A[i] = chpl_comm_getAmHandlerRequestsHere(i: c_int);
+    return A;
+  }
+
+
+  private extern proc chpl_comm_startProfile(time: bool);
+
+  private extern proc chpl_comm_stopProfile();
+
+  private extern proc chpl_comm_startProfileHere(time: bool);
+
+  private extern proc chpl_comm_stopProfileHere();
+
+  private extern proc chpl_comm_resetProfileHere();
+
+  private extern proc chpl_comm_mergeProfileHere(): size_t;
+
+  extern record chpl_commProfileEntry {
+    var op: c_string;
+    var fn: int(32);
+    var ln: int(32);
+    var node: int(32);
+    var count: uint(64);
+    var nbytes: uint(64);
+    var nsec: uint(64);
+  }
+
+  private extern proc chpl_comm_getProfileEntryHere(i: size_t,
+                                                    out e: chpl_commProfileEntry);
+
+  private extern proc chpl_lookupFilename(idx: int(32)): c_string;
+
+  private extern proc chpl_comm_writeProfileFile(filename: c_string,
+                                                 text: c_string): c_int;
+
+  /*
+    The communication done by one callsite on one locale, in a
+    communication profile.
+   */
+  record commProfileEntry {
+    /* the locale that initiated the operations */
+    var locId: int;
+    /* the source file of the callsite */
+    var file: string;
+    /* the source line of the callsite */
+    var line: int;
+    /* the kind of operation, such as ``get`` or ``fast executeOn`` */
+    var op: string;
+    /* the locale the operations targeted */
+    var peer: int;
+    /* how many operations there were */
+    var count: uint;
+    /* how many bytes they moved, for GETs and PUTs */
+    var numBytes: uint;
+    /* how much time, in seconds, tasks spent in them, if timed */
+    var time: real;
+  }
+
+  /*
+    Start profiling communication operations across the whole program.
+
+    :arg time: Also record the time spent in blocking operations?
+   */
+  proc startCommProfile(time: bool = false) {
+    chpl_comm_startProfile(time);
+  }
+
+  /*
+    Stop profiling communication operations across the whole program.
+   */
+  proc stopCommProfile() {
+    chpl_comm_stopProfile();
+  }
+
+  /*
+    Start profiling communication operations initiated on this locale.
+
+    :arg time: Also record the time spent in blocking operations?
+   */
+  proc startCommProfileHere(time: bool = false) {
+    chpl_comm_startProfileHere(time);
+  }
+
+  /*
+    Stop profiling communication operations initiated on this locale.
+   */
+  proc stopCommProfileHere() {
+    chpl_comm_stopProfileHere();
+  }
+
+  /*
+    Clear the communication profile across the whole program.
+   */
+  proc resetCommProfile() {
+    for loc in Locales do on loc do
+      resetCommProfileHere();
+  }
+
+  /*
+    Clear the communication profile on the calling locale.
+   */
+  proc resetCommProfileHere() {
+    chpl_comm_resetProfileHere();
+  }
+
+  /*
+    Retrieve the communication profile for this locale.
+
+    :returns: an entry per callsite, most operations first
+    :rtype: `[] commProfileEntry`
+   */
+  proc getCommProfileHere() {
+    const n = chpl_comm_mergeProfileHere(): int;
+    var P: [0..#n] commProfileEntry;
+    for i in P.domain {
+      var e: chpl_commProfileEntry;
+      chpl_comm_getProfileEntryHere(i: size_t, e);
+      const fileCS = chpl_lookupFilename(e.fn), opCS = e.op;
+      const file = try! createStringWithNewBuffer(fileCS, fileCS.size),
+            op = try! createStringWithNewBuffer(opCS, opCS.size);
+      P[i] = new commProfileEntry(locId=here.id,
+                                  file=file,
+                                  line=e.ln,
+                                  op=op,
+                                  peer=e.node,
+                                  count=e.count,
+                                  numBytes=e.nbytes,
+                                  time=e.nsec / 1e9);
+    }
+    return P;
+  }
+
+  /*
+    Retrieve the communication profile for the whole program.
+
+    :returns: an entry per callsite per locale, most operations first
+    :rtype: `[] commProfileEntry`
+   */
+  proc getCommProfile() {
+    var PD = {0..#0};
+    var P: [PD] commProfileEntry;
+    for loc in Locales {
+      var LD = {0..#0};
+      var L: [LD] commProfileEntry;
+      on loc {
+        const LHere = getCommProfileHere();
+        LD = {0..#LHere.size};
+        L = LHere;
+      }
+      const M = mergeCommProfiles(P, L);
+      PD = M.domain;
+      P = M;
+    }
+    return P;
+  }
+
+  // Merge two profiles that are each sorted most operations first.
+  private proc mergeCommProfiles(A: [] commProfileEntry,
+                                 B: [] commProfileEntry) {
+    var M: [0..#(A.size + B.size)] commProfileEntry;
+    var (a, b) = (0, 0);
+    for m in M {
+      if b >= B.size || (a < A.size && A[a].count >= B[b].count) {
+        m = A[a];
+        a += 1;
+      } else {
+        m = B[b];
+        b += 1;
+      }
+    }
+    return M;
+  }
+
+  /*
+    Print the communication profile for the whole program, a row per
+    callsite per locale, most operations first.
+
+    :arg maxEntries: Print at most this many rows (all of them if
+                     negative)
+    :type maxEntries: `int`
+   */
+  proc printCommProfile(maxEntries: int = 20) {
+    const P = getCommProfile();
+    const n = if maxEntries < 0 then P.size else min(maxEntries, P.size);
+    const timed = || reduce [e in P] e.time != 0.0;
+
+    var total: uint;
+    for e in P do total += e.count;
+
+    writeln("communication profile: ", total, " operations at ",
+            P.size, " callsites", if n < P.size
+                                  then ", top " + n:string + " shown"
+                                  else "");
+    writef("| %12s | %6s | %14s |", "count", "%", "bytes");
+    if timed then writef(" %10s |", "time (s)");
+    writeln(" locale | peer | operation | callsite");
+    for e in P[0..#n] {
+      writef("| %12u | %6.2dr | %14u |", e.count,
+             if total == 0 then 0.0 else 100.0 * e.count / total, e.numBytes);
+      if timed then writef(" %10.4dr |", e.time);
+      writeln(" ", e.locId, " | ", e.peer, " | ", e.op, " | ",
+              e.file, ":", e.line);
+    }
+  }
+
+  /*
+    Write the communication profile for the whole program to a file, as
+    comma-separated values with a header line.  There is a row per
+    callsite per locale, most operations first, with the columns
+    ``locale,file,line,op,peer,count,bytes,time``.
+
+    :arg filename: The file to write.
+    :type filename: `string`
+   */
+  proc writeCommProfile(filename: string) throws {
+    use SysError;
+    const P = getCommProfile();
+    var text = "locale,file,line,op,peer,count,bytes,time\n";
+    for e in P do
+      text += "%i,\"%s\",%i,%s,%i,%u,%u,%r\n".format(e.locId, e.file,
+                                                   e.line, e.op, e.peer,
+                                                   e.count, e.numBytes,
+                                                   e.time);
+    const err = chpl_comm_writeProfileFile(filename.c_str(), text.c_str());
+    if err != 0 then
+      throw SystemError.fromSyserr(err, "in writeCommProfile(\"" +
+                                        filename + "\")");
+  }
 
   /*
     Print the current communication counts in a markdown table using a
@@ -420,8 +785,9 @@ module CommDiagnostics
         maxval = max(maxval, getField(CommDiags[locID], fieldID).safeCast(int));
 
       if printEmptyColumns || maxval != 0 {
-        const width = if commDiagsPrintUnstable == false && name == "amo"
-                        then -unstable.size
+        const width = if commDiagsPrintUnstable == false &&
+                         isUnstableField(name)
+                        then -max(name.size, unstable.size)
                         else max(name.size, ceil(log10(maxval+1)):int);
         fieldWidth[fieldID] = width;
 
@@ -434,7 +800,7 @@ module CommDiagnostics
     for param fieldID in 0..<nFields {
       const width = abs(fieldWidth[fieldID]);
       if width != 0 {
-        writef("| %.*s: ", width-1, "------------------");
+        writef("| %.*s: ", width-1, "------------------------");
       }
     }
     writeln("|");
@@ -472,4 +838,21 @@ module CommDiagnostics
    */
   config param printInitCommCounts = false;
 
+  /*
+    If this is set, communication operations are profiled from before
+    any module initialization begins until after all module teardown
+    ends, and then the busiest callsites are printed.  If
+    :param:`commProfileFile` is also set, the whole profile is written
+    to that file.  See procedures :proc:`startCommProfile`,
+    :proc:`printCommProfile`, and :proc:`writeCommProfile` for more
+    information.
+   */
+  config param printInitCommProfile = false;
+
+  /*
+    The file :param:`printInitCommProfile` writes the whole profile to,
+    if it isn't empty.
+   */
+  config param commProfileFile = "";
+
 }
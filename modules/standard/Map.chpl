@@ -28,28 +28,9 @@
   mode of its originating map.
 */
 module Map {
-  import ChapelLocks;
   private use HaltWrappers;
   private use ChapelHashtable;
 
-  // Lock code lifted from modules/standard/Lists.chpl.
-  // Maybe they should be combined into a Locks module.
-  pragma "no doc"
-  type _lockType = ChapelLocks.chpl_LocalSpinlock;
-
-  pragma "no doc"
-  class _LockWrapper {
-    var lock$ = new _lockType();
-
-    inline proc lock() {
-      lock$.lock();
-    }
-
-    inline proc unlock() {
-      lock$.unlock();
-    }
-  }
-
   private use IO;
 
   pragma "no doc"
@@ -70,22 +51,51 @@ module Map {
     /* If `true`, this map will perform parallel safe operations. */
     param parSafe = false;
 
+    // When parSafe, the table stripes its locks so that operations on
+    // different keys can usually proceed in parallel.
     pragma "no doc"
-    var table: chpl__hashtable(keyType, valType);
-
-    pragma "no doc"
-    var _lock$ = if parSafe then new _LockWrapper() else none;
+    var table: chpl__hashtable(keyType, valType, parSafe);
 
+    // lock/unlock the whole map
     pragma "no doc"
     inline proc _enter() {
       if parSafe then
-        _lock$.lock();
+        table.lockAll();
     }
 
     pragma "no doc"
     inline proc _leave() {
       if parSafe then
-        _lock$.unlock();
+        table.unlockAll();
+    }
+
+    // lock/unlock the part of the map that 'k' belongs to
+    pragma "no doc"
+    inline proc _enter(const ref k: keyType) {
+      if parSafe then
+        table.lockKey(k);
+    }
+
+    pragma "no doc"
+    inline proc _leave(const ref k: keyType) {
+      if parSafe then
+        table.unlockKey(k);
+    }
+
+    // like _leave(k), for when 'k' has been moved into 'slot'
+    pragma "no doc"
+    inline proc _leaveSlot(slot: int) {
+      if parSafe then
+        table.unlockSlot(slot);
+    }
+
+    // call after removing a key, with no locks held
+    pragma "no doc"
+    inline proc _maybeShrink() {
+      if parSafe then
+        table.maybeShrinkAfterRemoveConcurrent();
+      else
+        table.maybeShrinkAfterRemove();
     }
 
     /*
@@ -168,9 +178,8 @@ module Map {
       this.complete();
 
       for key in other.keys() {
-        const (_, slot) = table.findAvailableSlot(key);
         const (_, slot2) = other.table.findFullSlot(key);
-        table.fillSlot(slot, key, other.table.table[slot2].val);
+        addOrSet(key, other.table.table[slot2].val);
       }
     }
 
@@ -191,6 +200,7 @@ module Map {
           table.clearSlot(slot, key, val);
         }
       }
+      table.forgetDeletedSlots();
       table.maybeShrinkAfterRemove();
     }
 
@@ -198,8 +208,9 @@ module Map {
       The current number of keys contained in this map.
     */
     inline proc const size {
-      _enter(); defer _leave();
-      var result = table.tableNumFullSlots;
+      // For a parSafe map this doesn't lock, so it is only a snapshot
+      // if the map is being modified concurrently.
+      var result = table.numFullSlots();
       return result;
     }
 
@@ -224,7 +235,7 @@ module Map {
       :rtype: `bool`
     */
     proc const contains(const k: keyType): bool {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (result, _) = table.findFullSlot(k);
       return result;
     }
@@ -238,15 +249,13 @@ module Map {
     */
     proc update(pragma "intent ref maybe const formal"
                 m: map(keyType, valType, parSafe)) {
-      _enter(); defer _leave();
-
       if !isCopyableType(keyType) || !isCopyableType(valType) then
         compilerError("updating map with non-copyable type");
 
+      // addOrSet does the locking, one key at a time
       for key in m.keys() {
-        var (_, slot) = table.findAvailableSlot(key);
-        var (_, slot2) = m.table.findAvailableSlot(key);
-        table.fillSlot(slot, key, m.table.table[slot2].val);
+        var (_, slot2) = m.table.findFullSlot(key);
+        addOrSet(key, m.table.table[slot2].val);
       }
     }
 
@@ -260,7 +269,7 @@ module Map {
       :returns: Reference to the value mapped to the given key.
     */
     proc ref this(k: keyType) ref where isDefaultInitializable(valType) {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
 
       var (_, slot) = table.findAvailableSlot(k);
       if !table.isSlotFull(slot) {
@@ -273,7 +282,7 @@ module Map {
     pragma "no doc"
     proc const this(k: keyType) const
     where shouldReturnRvalueByValue(valType) && !isNonNilableClass(valType) {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (found, slot) = table.findFullSlot(k);
       if !found then
         boundsCheckHalt("map index " + k:string + " out of bounds");
@@ -284,7 +293,7 @@ module Map {
     pragma "no doc"
     proc const this(k: keyType) const ref
     where shouldReturnRvalueByConstRef(valType) && !isNonNilableClass(valType) {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (found, slot) = table.findFullSlot(k);
       if !found then
         halt("map index ", k, " out of bounds");
@@ -302,7 +311,7 @@ module Map {
     /* Get a borrowed reference to the element at position `k`.
      */
     proc getBorrowed(k: keyType) where isClass(valType) {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (found, slot) = table.findFullSlot(k);
       if !found then
         boundsCheckHalt("map index " + k:string + " out of bounds");
@@ -321,7 +330,7 @@ module Map {
      */
     proc getReference(k: keyType) ref
     where !isNonNilableClass(valType) {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (found, slot) = table.findFullSlot(k);
       if !found then
         boundsCheckHalt("map index " + k:string + " out of bounds");
@@ -341,7 +350,7 @@ module Map {
         compilerError('getValue cannot be called when a map value type ',
                       'is an owned class, use getBorrowed instead');
 
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (found, slot) = table.findFullSlot(k);
       if !found then
         boundsCheckHalt("map index " + k:string + " out of bounds");
@@ -354,14 +363,17 @@ module Map {
     /* Remove the element at position `k` from the map and return its value
      */
     proc getAndRemove(k: keyType) {
-      _enter(); defer _leave();
+      _enter(k);
       var (found, slot) = table.findFullSlot(k);
-      if !found then
+      if !found {
+        _leave(k);
         boundsCheckHalt("map index " + k:string + " out of bounds");
+      }
       try! {
         var result: valType, key: keyType;
         table.clearSlot(slot, key, result);
-        table.maybeShrinkAfterRemove();
+        _leave(k);
+        _maybeShrink();
         return result: valType;
       }
     }
@@ -481,13 +493,15 @@ module Map {
      :rtype: bool
     */
     proc add(in k: keyType, in v: valType): bool lifetime this < v {
-      _enter(); defer _leave();
+      _enter(k);
       var (found, slot) = table.findAvailableSlot(k);
       if found {
+        _leave(k);
         return false;
       }
 
       table.fillSlot(slot, k, v);
+      _leaveSlot(slot);
 
       return true;
     }
@@ -508,7 +522,7 @@ module Map {
      :rtype: bool
     */
     proc set(k: keyType, in v: valType): bool {
-      _enter(); defer _leave();
+      _enter(k); defer _leave(k);
       var (found, slot) = table.findAvailableSlot(k);
       if !found {
         return false;
@@ -524,9 +538,10 @@ module Map {
        `k`, update it to the value `v`.
      */
     proc addOrSet(in k: keyType, in v: valType) {
-      _enter(); defer _leave();
-      var (found, slot) = findAvailableSlot(k);
+      _enter(k);
+      var (found, slot) = table.findAvailableSlot(k);
       table.fillSlot(slot, k, v);
+      _leaveSlot(slot);
     }
 
     /*
@@ -538,14 +553,16 @@ module Map {
      :rtype: bool
     */
     proc remove(k: keyType): bool {
-      _enter(); defer _leave();
+      _enter(k);
       var (found, slot) = table.findFullSlot(k);
       if !found {
+        _leave(k);
         return false;
       }
       var outKey: keyType, outVal: valType;
       table.clearSlot(slot, outKey, outVal);
-      table.maybeShrinkAfterRemove();
+      _leave(k);
+      _maybeShrink();
       return true;
     }
 
@@ -89,6 +89,31 @@
     In multilocale executions each top-level locale produces output
     to its own file, with a dot ('.') and the locale ID appended to
     this path.
+
+  The following config variables control sampled heap profiling.  This
+  is much cheaper than full memory tracking and is intended to be left
+  on in long-running programs, to find which source lines are
+  responsible for memory growth.
+
+  ``memSampleInterval``: `uint`:
+    If the value is greater than 0 (zero), sample roughly one
+    allocation per this many bytes allocated, and write heap profiles
+    giving the estimated number of bytes in use per allocating source
+    line and allocation type.  Each profile is written in the "folded
+    stacks" format used by flame graph tools such as ``flamegraph.pl``
+    and speedscope.  A profile is written at normal program
+    termination.  If full memory tracking is also enabled, the
+    profiles are exact, based on all tracked allocations.
+
+  ``memSamplePeriod``: `real`:
+    If this is greater than 0 (zero), also write a heap profile about
+    every this many seconds during execution.
+
+  ``memSampleLog``: `string`:
+    Heap profiles are written to files whose names are this path
+    (``memProfile`` by default) followed by a dot ('.') and a profile
+    sequence number, starting at 0.  In multilocale executions the
+    locale ID and another dot come before the sequence number.
  */
 module Memory {
 
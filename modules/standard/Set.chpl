@@ -42,7 +42,6 @@ module Set {
   // Use this to restrict our secondary initializer to only resolve when the
   // "iterable" argument has a method named "these".
   //
-  import ChapelLocks;
   private use IO;
   private use Reflection;
   private use ChapelHashtable;
@@ -59,31 +58,6 @@ module Set {
       assert(expr);
   }
 
-  //
-  // We can change the lock type later. Use a spinlock for now, even if it
-  // is suboptimal in cases where long critical sections have high
-  // contention.
-  //
-  pragma "no doc"
-  type _lockType = ChapelLocks.chpl_LocalSpinlock;
-
-  //
-  // Use a wrapper class to let set methods have a const ref receiver even
-  // when `parSafe` is `true` and the set lock is used.
-  //
-  pragma "no doc"
-  class _LockWrapper {
-    var lock$ = new _lockType();
-
-    inline proc lock() {
-      lock$.lock();
-    }
-
-    inline proc unlock() {
-      lock$.unlock();
-    }
-  }
-
   pragma "no doc"
   proc _checkElementType(type t) {
     // In the future we might support it if the set is not default-inited.
@@ -123,11 +97,10 @@ module Set {
     /* If `true`, this set will perform parallel safe operations. */
     param parSafe = false;
 
+    // When parSafe, the table stripes its locks so that operations on
+    // different elements can usually proceed in parallel.
     pragma "no doc"
-    var _lock$ = if parSafe then new _LockWrapper() else none;
-
-    pragma "no doc"
-    var _htb: chpl__hashtable(eltType, nothing);
+    var _htb: chpl__hashtable(eltType, nothing, parSafe);
 
     /*
       Initializes an empty set containing elements of the given type.
@@ -144,10 +117,16 @@ module Set {
     // Returns true if the key was added to the hashtable.
     pragma "no doc"
     proc _addElem(in elem: eltType): bool {
+      _enter(elem);
       var (isFullSlot, idx) = _htb.findAvailableSlot(elem);
 
-      if isFullSlot then return false;
+      if isFullSlot {
+        _leave(elem);
+        return false;
+      }
       _htb.fillSlot(idx, elem, none);
+      // elem was moved into the table, so unlock by slot
+      if parSafe then _htb.unlockSlot(idx);
       return true;
     }
 
@@ -191,11 +170,12 @@ module Set {
       for elem in other do _addElem(elem);
     }
 
+    // lock/unlock the whole set
     pragma "no doc"
     inline proc _enter() {
       if parSafe then
         on this {
-          _lock$.lock();
+          _htb.lockAll();
         }
     }
 
@@ -203,10 +183,23 @@ module Set {
     inline proc _leave() {
       if parSafe then
         on this {
-          _lock$.unlock();
+          _htb.unlockAll();
         }
     }
 
+    // lock/unlock the part of the set that 'x' belongs to
+    pragma "no doc"
+    inline proc _enter(const ref x: eltType) {
+      if parSafe then
+        _htb.lockKey(x);
+    }
+
+    pragma "no doc"
+    inline proc _leave(const ref x: eltType) {
+      if parSafe then
+        _htb.unlockKey(x);
+    }
+
     /*
       Add a copy of the element `x` to this set. Does nothing if this set
       already contains an element equal to the value of `x`.
@@ -216,8 +209,7 @@ module Set {
     proc ref add(in x: eltType) lifetime this < x {
 
       // Remove `on this` block because it prevents copy elision of `x` when
-      // passed to `_addElem`. See #15808.
-      _enter(); defer _leave();
+      // passed to `_addElem`. See #15808. _addElem does the locking.
       _addElem(x);
     }
 
@@ -233,7 +225,7 @@ module Set {
       var result = false;
 
       on this {
-        _enter(); defer _leave();
+        _enter(x); defer _leave(x);
         var (hasFoundSlot, _) = _htb.findFullSlot(x);
         result = hasFoundSlot;
       }
@@ -255,14 +247,16 @@ module Set {
       on this {
         _enter(); defer _leave();
 
-        if !(size == 0 || other.size == 0) {
+        if !(_htb.numFullSlots() == 0 || other.size == 0) {
 
           // TODO: Take locks on other?
-          for x in other do
-            if this.contains(x) {
+          for x in other {
+            var (hasFoundSlot, _) = _htb.findFullSlot(x);
+            if hasFoundSlot {
               result = false;
               break;
             }
+          }
         }
       }
 
@@ -299,7 +293,7 @@ module Set {
       var result = false;
 
       on this {
-        _enter(); defer _leave();
+        _enter(x);
 
         var (hasFoundSlot, idx) = _htb.findFullSlot(x);
 
@@ -309,9 +303,14 @@ module Set {
           var val: nothing;
 
           _htb.clearSlot(idx, key, val);
-          _htb.maybeShrinkAfterRemove();
           result = true;
         }
+
+        _leave(x);
+        if parSafe then
+          _htb.maybeShrinkAfterRemoveConcurrent();
+        else if hasFoundSlot then
+          _htb.maybeShrinkAfterRemove();
       }
 
       return result;
@@ -337,6 +336,7 @@ module Set {
           }
         }
 
+        _htb.forgetDeletedSlots();
         _htb.maybeShrinkAfterRemove();
       }
     }
@@ -393,7 +393,7 @@ module Set {
         ch <~> "{";
 
         for x in this {
-          if count <= (_htb.tableNumFullSlots - 1) {
+          if count <= (_htb.numFullSlots() - 1) {
             count += 1;
             ch <~> x <~> ", ";
           } else {
@@ -416,7 +416,7 @@ module Set {
 
       on this {
         _enter(); defer _leave();
-        result = _htb.tableNumFullSlots == 0;
+        result = _htb.numFullSlots() == 0;
       }
 
       return result;
@@ -429,8 +429,9 @@ module Set {
       var result = 0;
 
       on this {
-        _enter(); defer _leave();
-        result = _htb.tableNumFullSlots;
+        // For a parSafe set this doesn't lock, so it is only a snapshot
+        // if the set is being modified concurrently.
+        result = _htb.numFullSlots();
       }
 
       return result;
@@ -448,16 +449,16 @@ module Set {
       // May take locks non-locally...
       _enter(); defer _leave();
 
-      var result: [0..#_htb.tableNumFullSlots] eltType;
+      var result: [0..#_htb.numFullSlots()] eltType;
 
       if !isCopyableType(eltType) then
         compilerError('Cannot create array because set element type ' +
                       eltType:string + ' is not copyable');
 
       on this {
-        if _htb.tableNumFullSlots != 0 {
+        if _htb.numFullSlots() != 0 {
           var count = 0;
-          var array: [0..#_htb.tableNumFullSlots] eltType;
+          var array: [0..#_htb.numFullSlots()] eltType;
 
           for x in this {
             array[count] = x;
@@ -24,6 +24,7 @@
 #include "chpltypes.h"
 #include "chpl-atomics.h"
 #include "chpl-comm.h" // to get HAS_CHPL_CACHE_FNS via chpl-comm-task-decls.h
+#include "chpl-comm-diags.h" // chpl_cacheParameters
 #include "chpl-tasks.h"
 
 #ifdef HAS_CHPL_CACHE_FNS
@@ -90,6 +91,9 @@ void chpl_cache_comm_getput_unordered(c_nodeid_t dstnode, void* dstaddr,
                                       int ln, int32_t fn);
 void chpl_cache_comm_getput_unordered_task_fence(void);
 
+// Report the current cache parameters (for CommDiagnostics).
+void chpl_cache_get_parameters(chpl_cacheParameters* cp);
+
 // For debugging.
 void chpl_cache_print(void);
 void chpl_cache_assert_released(void);
@@ -23,6 +23,7 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "chpl-atomics.h"
 #include "chpl-comm.h"
@@ -50,7 +51,16 @@ extern int chpl_comm_diags_print_unstable;
   MACRO(amo) \
   MACRO(execute_on) \
   MACRO(execute_on_fast) \
-  MACRO(execute_on_nb)
+  MACRO(execute_on_nb) \
+  MACRO(cache_shared_hit) \
+  MACRO(cache_get_hits) \
+  MACRO(cache_get_misses) \
+  MACRO(cache_put_hits) \
+  MACRO(cache_put_misses) \
+  MACRO(cache_evictions) \
+  MACRO(cache_lines_unused) \
+  MACRO(unordered_flush_full) \
+  MACRO(unordered_flush_fence)
 
 typedef struct _chpl_commDiagnostics {
 #define _COMM_DIAGS_DECL(cdv) uint64_t cdv;
@@ -70,6 +80,66 @@ void chpl_comm_stopDiagnosticsHere(void);
 void chpl_comm_resetDiagnosticsHere(void);
 void chpl_comm_getDiagnosticsHere(chpl_commDiagnostics *cd);
 
+//
+// The current (possibly adapted) parameters of the remote data cache
+// on this locale.  All zero if the cache is not enabled.
+//
+typedef struct _chpl_cacheParameters {
+  int64_t page_size;
+  int64_t line_size;
+  int64_t cache_pages;
+  int64_t ain_pages;
+  int64_t aout_pages;
+  int64_t readahead_bytes;
+  int64_t within_page_readahead;
+} chpl_cacheParameters;
+
+void chpl_comm_getCacheParametersHere(chpl_cacheParameters *cp);
+
+//
+// The number of active message requests each AM handler thread on this
+// locale has processed while diagnostics were on.  Comm layers that do
+// not report these have no AM handlers, as far as this is concerned.
+//
+#define CHPL_COMM_DIAGS_MAX_AM_HANDLERS 64
+
+int chpl_comm_getNumAmHandlersHere(void);
+uint64_t chpl_comm_getAmHandlerRequestsHere(int i);
+
+//
+// Per-callsite communication profile.  While profiling is on, each
+// comm op initiated here is counted under its source location, kind,
+// and peer locale, along with the bytes it moved and, if asked for,
+// the time the initiating task spent in it.  The counts are kept in
+// per-thread tables.  chpl_comm_mergeProfileHere() combines those and
+// returns the number of distinct callsites, which can then be fetched,
+// most frequent first, with chpl_comm_getProfileEntryHere().  The
+// CommDiagnostics module writes profiles to files through
+// chpl_comm_writeProfileFile(), because it is initialized too early to
+// use the IO module.
+//
+extern int chpl_comm_profile;      // set via startCommProfile
+extern int chpl_comm_profile_time;
+
+typedef struct _chpl_commProfileEntry {
+  const char* op;
+  int32_t fn;
+  int32_t ln;
+  int32_t node;
+  uint64_t count;
+  uint64_t nbytes;
+  uint64_t nsec;
+} chpl_commProfileEntry;
+
+void chpl_comm_startProfile(chpl_bool time);
+void chpl_comm_stopProfile(void);
+void chpl_comm_startProfileHere(chpl_bool time);
+void chpl_comm_stopProfileHere(void);
+void chpl_comm_resetProfileHere(void);
+size_t chpl_comm_mergeProfileHere(void);
+void chpl_comm_getProfileEntryHere(size_t i, chpl_commProfileEntry* e);
+int chpl_comm_writeProfileFile(const char* filename, const char* text);
+
 
 ////////////////////
 //
@@ -84,6 +154,15 @@ typedef struct _chpl_atomic_commDiagnostics {
 extern chpl_atomic_commDiagnostics chpl_comm_diags_counters;
 extern atomic_int_least16_t chpl_comm_diags_disable_flag;
 
+extern int chpl_comm_diags_num_am_handlers;
+extern atomic_uint_least64_t
+       chpl_comm_diags_am_handler_reqs[CHPL_COMM_DIAGS_MAX_AM_HANDLERS];
+
+void chpl_comm_diags_profile_init(void);
+void chpl_comm_diags_profile_add(const char* op, c_nodeid_t node,
+                                 size_t size, int ln, int32_t fn,
+                                 uint64_t count, uint64_t nsec);
+
 static inline
 void chpl_comm_diags_init(void) {
 #define _COMM_DIAGS_INIT(cdv) \
@@ -91,6 +170,10 @@ void chpl_comm_diags_init(void) {
   CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_INIT);
 #undef _COMM_DIAGS_INIT
   atomic_init_int_least16_t(&chpl_comm_diags_disable_flag, 0);
+  for (int i = 0; i < CHPL_COMM_DIAGS_MAX_AM_HANDLERS; i++) {
+    atomic_init_uint_least64_t(&chpl_comm_diags_am_handler_reqs[i], 0);
+  }
+  chpl_comm_diags_profile_init();
 }
 
 static inline
@@ -99,8 +182,31 @@ void chpl_comm_diags_reset(void) {
         atomic_store_uint_least64_t(&chpl_comm_diags_counters.cdv, 0);
  CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_RESET);
 #undef _COMM_DIAGS_RESET
+  for (int i = 0; i < chpl_comm_diags_num_am_handlers; i++) {
+    atomic_store_uint_least64_t(&chpl_comm_diags_am_handler_reqs[i], 0);
+  }
 }
 
+//
+// Comm layers with AM handler threads call this once they know how
+// many they have, and then count the requests each one processes.
+//
+static inline
+void chpl_comm_diags_set_num_am_handlers(int n) {
+  if (n > CHPL_COMM_DIAGS_MAX_AM_HANDLERS) {
+    n = CHPL_COMM_DIAGS_MAX_AM_HANDLERS;
+  }
+  chpl_comm_diags_num_am_handlers = n;
+}
+
+#define chpl_comm_diags_incr_am_handler(_i)                             \
+  do {                                                                  \
+    if (chpl_comm_diagnostics) {                                        \
+      (void) atomic_fetch_add_uint_least64_t(                           \
+               &chpl_comm_diags_am_handler_reqs[(_i)], 1);              \
+    }                                                                   \
+  } while(0)
+
 static inline
 void chpl_comm_diags_copy(chpl_commDiagnostics* cd) {
 #define _COMM_DIAGS_COPY(cdv) \
@@ -142,33 +248,86 @@ int chpl_comm_diags_is_enabled(void) {
     }                                                              \
   } while(0)
 
+#define chpl_comm_diags_profile(op, node, size, ln, fn)                 \
+  do {                                                                  \
+    if (chpl_comm_profile && chpl_comm_diags_is_enabled()) {            \
+      chpl_comm_diags_profile_add(op, node, size, ln, fn, 1, 0);        \
+    }                                                                   \
+  } while(0)
+
+//
+// Ops whose time is profiled are bracketed by these.  The start value
+// is 0 unless timing is on.
+//
+static inline
+uint64_t chpl_comm_diags_profile_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline
+uint64_t chpl_comm_diags_profile_start(void) {
+  return (chpl_comm_profile && chpl_comm_profile_time
+          && chpl_comm_diags_is_enabled())
+         ? chpl_comm_diags_profile_now()
+         : 0;
+}
+
+#define chpl_comm_diags_profile_time(op, node, ln, fn, t0)              \
+  do {                                                                  \
+    if ((t0) != 0) {                                                    \
+      chpl_comm_diags_profile_add(op, node, 0, ln, fn, 0,               \
+                                  chpl_comm_diags_profile_now() - (t0)); \
+    }                                                                   \
+  } while(0)
+
+//
+// Besides reporting on-the-fly, these feed the per-callsite profile.
+//
 #define chpl_comm_diags_verbose_rdma(op, node, size, ln, fn, commid)     \
-  chpl_comm_diags_verbose_printf(false,                                  \
-                                 "%s:%d: remote %s, node %d, %zu bytes, " \
-                                 "commid %d",                            \
-                                 chpl_lookupFilename(fn), ln, op,        \
-                                 (int) node, size, (int) commid)
+  do {                                                                   \
+    chpl_comm_diags_verbose_printf(false,                                \
+                                   "%s:%d: remote %s, node %d, %zu bytes, " \
+                                   "commid %d",                          \
+                                   chpl_lookupFilename(fn), ln, op,      \
+                                   (int) node, size, (int) commid);      \
+    chpl_comm_diags_profile(op, node, size, ln, fn);                     \
+  } while(0)
 
 #define chpl_comm_diags_verbose_rdmaStrd(op, node, ln, fn, commid)      \
-  chpl_comm_diags_verbose_printf(false,                                 \
-                                 "%s:%d: remote strided %s, node %d, "  \
-                                 "commid %d",                           \
-                                 chpl_lookupFilename(fn), ln, op,       \
-                                 (int) node, (int) commid)
+  do {                                                                  \
+    chpl_comm_diags_verbose_printf(false,                               \
+                                   "%s:%d: remote strided %s, node %d, " \
+                                   "commid %d",                         \
+                                   chpl_lookupFilename(fn), ln, op,     \
+                                   (int) node, (int) commid);           \
+    chpl_comm_diags_profile("strided " op, node, 0, ln, fn);            \
+  } while(0)
 
 #define chpl_comm_diags_verbose_amo(op, node, ln, fn)                   \
-  chpl_comm_diags_verbose_printf(true,                                  \
-                                 "%s:%d: remote %s, node %d",           \
-                                 chpl_lookupFilename(fn), ln, op,       \
-                                 (int) node)
+  do {                                                                  \
+    chpl_comm_diags_verbose_printf(true,                                \
+                                   "%s:%d: remote %s, node %d",         \
+                                   chpl_lookupFilename(fn), ln, op,     \
+                                   (int) node);                         \
+    chpl_comm_diags_profile(op, node, 0, ln, fn);                       \
+  } while(0)
 
 #define chpl_comm_diags_verbose_executeOn(kind, node, ln, fn)           \
-  chpl_comm_diags_verbose_printf(false,                                 \
-                                 "%s:%d: remote %-*sexecuteOn, node %d", \
-                                 chpl_lookupFilename(fn), ln,           \
-                                 ((int) strlen(kind)                    \
-                                  + ((strlen(kind) == 0) ? 0 : 1)),     \
-                                 kind, (int) node)
+  do {                                                                  \
+    chpl_comm_diags_verbose_printf(false,                               \
+                                   "%s:%d: remote %-*sexecuteOn, node %d", \
+                                   chpl_lookupFilename(fn), ln,         \
+                                   ((int) strlen(kind)                  \
+                                    + ((strlen(kind) == 0) ? 0 : 1)),   \
+                                   kind, (int) node);                   \
+    chpl_comm_diags_profile(chpl_comm_diags_executeOn_op(kind),         \
+                            node, 0, ln, fn);                           \
+  } while(0)
+
+#define chpl_comm_diags_executeOn_op(kind)                              \
+  ((strlen(kind) == 0) ? "executeOn" : kind " executeOn")
 
 #define chpl_comm_diags_incr(_ctr)                                      \
   do {                                                                  \
@@ -178,4 +337,12 @@ int chpl_comm_diags_is_enabled(void) {
     }                                                                   \
   } while(0)
 
+#define chpl_comm_diags_add(_ctr, _n)                                   \
+  do {                                                                  \
+    if (chpl_comm_diagnostics && chpl_comm_diags_is_enabled()) {        \
+      atomic_uint_least64_t* ctrAddr = &chpl_comm_diags_counters._ctr;  \
+      (void) atomic_fetch_add_uint_least64_t(ctrAddr, (_n));            \
+    }                                                                   \
+  } while(0)
+
 #endif
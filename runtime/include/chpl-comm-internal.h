@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include "chpltypes.h"
+#include "chpl-comm.h"
 #include "chpl-mem-desc.h"
 
 //
@@ -50,6 +51,8 @@ extern size_t chpl_rt_priv_bcast_lens[];
   MACRO(chpl_comm_diagnostics)               \
   MACRO(chpl_comm_diags_print_unstable)      \
   MACRO(chpl_verbose_comm_stacktrace)        \
+  MACRO(chpl_comm_profile)                   \
+  MACRO(chpl_comm_profile_time)              \
   MACRO(chpl_verbose_mem)
 
 #define _RT_PRV_BCAST_M(sym)  chpl_rt_prv_tab_ ## sym ## _idx,
@@ -76,4 +79,71 @@ void chpl_comm_really_bcast_rt_private(int id) {
                               chpl_rt_priv_bcast_lens[id]);
 }
 
+//
+// Broadcast trees.  A broadcast from a root node goes down a tree of
+// the nodes numbered by their rank relative to the root, in which the
+// children of rank r are ranks r*k+1 through r*k+k, k being the
+// fanout (see chpl_comm_bcast_fanout()).  No node sends more than k
+// times, and the data reaches every node in about log_k(numNodes)
+// steps rather than numNodes-1.
+//
+static inline
+c_nodeid_t chpl_comm_bcast_tree_rank(c_nodeid_t root, c_nodeid_t node) {
+  return (node - root + chpl_numNodes) % chpl_numNodes;
+}
+
+static inline
+c_nodeid_t chpl_comm_bcast_tree_node(c_nodeid_t root, c_nodeid_t rank) {
+  return (root + rank) % chpl_numNodes;
+}
+
+static inline
+c_nodeid_t chpl_comm_bcast_tree_parent(c_nodeid_t root, int fanout,
+                                       c_nodeid_t node) {
+  const c_nodeid_t rank = chpl_comm_bcast_tree_rank(root, node);
+  return chpl_comm_bcast_tree_node(root, (rank - 1) / fanout);
+}
+
+//
+// Returns the number of children the given node has in the tree, and
+// the rank of the first one.  The others have the following ranks.
+//
+static inline
+int chpl_comm_bcast_tree_children(c_nodeid_t root, int fanout,
+                                  c_nodeid_t node, c_nodeid_t* pFirstRank) {
+  const int64_t first =
+    (int64_t) chpl_comm_bcast_tree_rank(root, node) * fanout + 1;
+  *pFirstRank = (c_nodeid_t) first;
+  if (first >= chpl_numNodes) {
+    return 0;
+  }
+  return (first + fanout <= chpl_numNodes)
+         ? fanout
+         : (int) (chpl_numNodes - first);
+}
+
+//
+// Support for chpl_comm_allreduce() by recursive doubling.  Comm
+// layers that implement it supply a way to send a message carrying
+// partial results to another node, and call
+// chpl_comm_allreduce_arrive() on the target node with the message
+// contents.  chpl_comm_allreduce_rd() does the rest.  Each message is
+// at most CHPL_COMM_ALLREDUCE_MAX_MSG bytes.  If 'poll' is not NULL,
+// it is called to make progress while waiting for messages.
+//
+#define CHPL_COMM_ALLREDUCE_MAX_MSG 256
+
+typedef void (*chpl_comm_allreduce_send_t)(c_nodeid_t node, uint64_t id,
+                                           int step, const void* data,
+                                           size_t size);
+
+void chpl_comm_allreduce_rd(uint64_t id, void* buf, size_t count,
+                            chpl_comm_reduce_type_t type,
+                            chpl_comm_reduce_op_t op,
+                            chpl_comm_allreduce_send_t send,
+                            void (*poll)(void));
+
+void chpl_comm_allreduce_arrive(uint64_t id, int step,
+                                const void* data, size_t size);
+
 #endif
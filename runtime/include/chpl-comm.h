@@ -367,6 +367,57 @@ void chpl_comm_broadcast_global_vars(int numGlobals);
 //
 void chpl_comm_broadcast_private(int id, size_t size);
 
+//
+// The fanout of the trees down which broadcasts from one node to all
+// the others go, in comm layers that use them and in module code that
+// broadcasts serialized globals.  It comes from the environment
+// variable CHPL_RT_COMM_BCAST_FANOUT.  If that is less than 1, every
+// other node is a child of the root, for a flat broadcast.  The value
+// returned is always at least 1.
+//
+int chpl_comm_bcast_fanout(void);
+
+//
+// Collective reductions.
+//
+// chpl_comm_allreduce() combines the 'count' values of the given type
+// at 'buf' on every node using the given operation, and leaves the
+// result in 'buf' on every node.  It is collective: exactly one task
+// on each node must call it with the same 'id', 'count', 'type', and
+// 'op', and it returns on a node once that node has the result.  The
+// id distinguishes concurrent reductions from each other.  One of the
+// participants gets it from chpl_comm_allreduce_new_id() and passes it
+// to the others.
+//
+// The logical operations are only for CHPL_COMM_REDUCE_BOOL, and the
+// others only for the numeric types.  Not all comm layers implement
+// this.  Module code should only call it when CHPL_COMM is gasnet,
+// ofi, or none.
+//
+typedef enum {
+  CHPL_COMM_REDUCE_INT32,
+  CHPL_COMM_REDUCE_INT64,
+  CHPL_COMM_REDUCE_UINT32,
+  CHPL_COMM_REDUCE_UINT64,
+  CHPL_COMM_REDUCE_REAL32,
+  CHPL_COMM_REDUCE_REAL64,
+  CHPL_COMM_REDUCE_BOOL
+} chpl_comm_reduce_type_t;
+
+typedef enum {
+  CHPL_COMM_REDUCE_SUM,
+  CHPL_COMM_REDUCE_MIN,
+  CHPL_COMM_REDUCE_MAX,
+  CHPL_COMM_REDUCE_LAND,
+  CHPL_COMM_REDUCE_LOR
+} chpl_comm_reduce_op_t;
+
+uint64_t chpl_comm_allreduce_new_id(void);
+
+void chpl_comm_allreduce(uint64_t id, void* buf, size_t count,
+                         chpl_comm_reduce_type_t type,
+                         chpl_comm_reduce_op_t op);
+
 //
 // Barrier for synchronization between all top-level locales; currently
 // only used for startup and teardown.  msg is a string that can be used
@@ -36,6 +36,8 @@ extern "C" {
 
 // Memory tracking activated?
 extern int chpl_memTrack;
+// Allocation sampling (for heap profiles) activated?
+extern int chpl_memSample;
 extern int chpl_verbose_mem;      // set via startVerboseMem
 
 ///// These entry points support the memory tracking functions provided by
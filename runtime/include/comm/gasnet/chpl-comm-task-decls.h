@@ -41,4 +41,8 @@ typedef struct {
 // The type of the communication handle.
 typedef void* chpl_comm_nb_handle_t;
 
+// GASNet explicit handles may only be synced by the pthread that
+// initiated the operation.
+#define CHPL_COMM_NB_HANDLES_THREAD_BOUND
+
 #endif
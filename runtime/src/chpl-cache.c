@@ -255,6 +255,84 @@ would be to only move tasks between threads in situations that create full
 barriers anyway; notably a full barrier occurs on task start and sync variable
 use.
 
+== Sharing the Cache Between Threads ==
+
+A cache per pthread means that on a node with many cores, read-mostly
+programs can fetch the same remote pages once per pthread, and the memory
+used for buffering grows with the number of pthreads. Setting
+CHPL_RT_CACHE_REMOTE_SHARED=true at execution time selects a different
+arrangement in which all pthreads on a locale share a set of caches. Each
+of these 'shards' is an ordinary 2Q cache as described above, and a
+(node, remote address) pair always maps to the same shard. The mapping works
+on CACHE_SHARD_REGION_SIZE-aligned regions of remote memory, so sequential
+access and readahead stay within one shard until they cross into the next
+region. The number of shards is set by CHPL_RT_CACHE_REMOTE_SHARDS (rounded
+up to a power of 2).
+
+In the shared mode each shard is protected by a spinlock instead of the
+cacheInUse flag, and all shards draw sequence numbers from a single
+locale-wide counter. The locale-wide counter keeps the acquire/release
+semantics described above: a task's last acquire fence can be compared
+against the sequence number of an entry in any shard. Since a GET started by
+one pthread can race with an acquire fence run by another, the minimum
+sequence number recorded for an entry is the one that was current when the
+GET was started rather than when it was recorded. A release fence flushes
+and waits for pending operations in every shard.
+
+The shared mode requires that nonblocking handles can be waited on from any
+pthread, which is not the case for GASNet's explicit handles. For comm
+layers like that (see CHPL_COMM_NB_HANDLES_THREAD_BOUND), the cache falls
+back to one cache per pthread with a warning.
+
+When comm diagnostics are on, GETs satisfied by data that a different
+pthread brought into a shared cache are counted in 'cache_shared_hit'.
+
+== Strided Access ==
+
+Sequential readahead only helps when consecutive GETs are adjacent. To also
+cover constant-stride access (e.g. walking a column of a remote row-major
+array, or loading a strided halo) each pthread keeps a small table of
+'streams'. Every GET made through the cache is matched against the streams
+for the same node: a GET that lands exactly one stride past the last access
+of a stream confirms that stream, and one that lands near it starts a new
+stride. Tracking several streams lets a task walk a few arrays at once
+(positive or negative strides) without the streams disturbing each other.
+Once a stride has repeated STRIDE_CONFIRM times, the cache starts prefetching
+that many strides ahead of the access, growing the distance up to
+STRIDE_MAX_DEPTH as the stream continues. Strides of a single cache line are
+left to the sequential readahead. As for readahead, prefetches are only
+started for addresses that chpl_comm_addr_gettable() allows, and not while
+the pending operation queue is congested.
+
+Setting CHPL_RT_CACHE_REMOTE_STRIDE_PREFETCH=false disables it.
+
+== Adapting to the Access Pattern ==
+
+The cache page and line sizes are fixed at compile time (the valid and dirty
+bitmasks depend on them), but how much of that geometry is actually fetched
+and how the 2Q queues are divided is adjusted while the program runs. Each
+cache keeps counts for an 'epoch' of CACHE_ADAPT_EPOCH GET misses and then:
+
+  - compares the number of lines that were fetched but never read before
+    their page was evicted with the number of lines evicted. Mostly-wasted
+    lines (sparse or random access) shrink the readahead window and turn
+    off extending a miss to the rest of its page. Mostly-used lines
+    (streaming access) turn that back on and grow the readahead window up
+    to MAX_ADAPTIVE_READAHEAD_PAGES pages.
+  - compares the number of misses that found their page in Aout with the
+    total number of misses. Frequent Aout hits mean that pages are re-used
+    but fall out of Ain too soon, so Kin (ain_max) grows, up to half of
+    the cache. Rare Aout hits let it shrink again, down to 10%.
+
+The capacity of each cache can be set with CHPL_RT_CACHE_REMOTE_SIZE (in
+bytes, with the usual size suffixes); otherwise it is sized from the
+number of locales. CHPL_RT_CACHE_REMOTE_ADAPT=false keeps the
+initial parameters for the whole run.
+
+The hits, misses and evictions, as well as the number of lines that were
+fetched but never used, are counted in comm diagnostics, and
+chpl_comm_getCacheParametersHere() reports the current parameters.
+
  */
 
 // ASSUMES THAT TASKS DO NOT MIGRATE BETWEEN PTHREADS
@@ -279,6 +357,7 @@ use.
 #include "chpl-atomics.h"
 #include "chpl-thread-local-storage.h" // CHPL_TLS_DECL etc
 #include "chpl-cache.h"
+#include "chpl-env.h" // chpl_env_rt_get_bool etc
 #include "chpl-linefile-support.h"
 #include "sys.h" // sys_page_size()
 #include "chpl-comm-compiler-macros.h"
@@ -300,6 +379,15 @@ use.
 #define MIN_CACHE_DATA_SIZE (1024*1024)
 #define MAX_CACHE_DATA_SIZE (256*1024*1024)
 
+// In the shared mode, remote memory is assigned to shards in regions of
+// this many bytes. It needs to be a multiple of CACHEPAGE_SIZE.
+#define CACHE_SHARD_REGION_BITS 16
+#define CACHE_SHARD_REGION_SIZE (1 << CACHE_SHARD_REGION_BITS)
+#define CACHE_SHARD_REGION_MASK (CACHE_SHARD_REGION_SIZE-1)
+// Default and maximum number of shards in the shared mode.
+#define DEFAULT_CACHE_SHARDS 8
+#define MAX_CACHE_SHARDS 256
+
 // How many pending operations can we have at once?
 #define MAX_PENDING 32
 
@@ -342,6 +430,24 @@ typedef int16_t readahead_distance_t;
 #define ENABLE_READAHEAD_TRIGGER_SEQUENTIAL 0
 #define MAX_SEQUENTIAL_READAHEAD_BYTES (MAX_PAGES_PER_PREFETCH*CACHEPAGE_SIZE)
 
+// Adaptive tuning; see "Adapting to the Access Pattern" above.
+// How many GET misses between adjustments?
+#define CACHE_ADAPT_EPOCH 1024
+// The largest readahead window adaptation can choose. Note that readahead
+// distances are stored in a readahead_distance_t.
+#define MAX_ADAPTIVE_READAHEAD_PAGES 16
+#define MAX_ADAPTIVE_READAHEAD_BYTES (MAX_ADAPTIVE_READAHEAD_PAGES*CACHEPAGE_SIZE)
+
+// Stride prefetching; see "Strided Access" above.
+// How many access streams do we track per pthread?
+#define STRIDE_STREAMS 8
+// How far apart can two accesses be and still belong to one stream?
+#define STRIDE_MAX_DISTANCE (1024*1024)
+// How many times must a stride repeat before we prefetch?
+#define STRIDE_CONFIRM 2
+// At most how many strides ahead of the access stream do we prefetch?
+#define STRIDE_MAX_DEPTH 8
+
 //#define TIME
 //#define TRACE
 //#define DEBUG
@@ -526,6 +632,11 @@ struct cache_entry_s {
   // If there are dirty bits in this page, what sequence number did
   // we promise to use in order to complete them?
   //cache_seqn_t dirty_sequence_number;
+  // Which pthread last brought data into this page? Only used to count
+  // cross-thread hits in the shared mode.
+  int32_t fill_thread;
+  // Which of the valid cache lines has a GET actually read from?
+  uint64_t used_lines[CACHE_LINES_PER_PAGE_BITMASK_WORDS];
 };
 
 // Note skip/len are in line numbers, NOT byte offsets!
@@ -589,6 +700,13 @@ struct rdcache_s {
   // to switch tasks, only allow one task at a time to manipulate the cache.
   int cacheInUse;
 
+  // In the shared mode, protects the cache from other pthreads (and is
+  // used instead of cacheInUse), and points to the locale-wide sequence
+  // number counter that replaces next_request_number.
+  // NULL for a cache per pthread.
+  atomic_spinlock_t sharedLock;
+  atomic_int_least64_t* shared_next_request_number;
+
   // The variable names Ain Aout and Am come from the 2Q paper
 
   // Ain is a FIFO queue storing entries initially as they go into
@@ -627,6 +745,21 @@ struct rdcache_s {
   int max_entries;
   int max_top_nodes;
 
+  // Adaptive tuning; see "Adapting to the Access Pattern" above.
+  int adapt;
+  // Upper limit for readahead and prefetch sizes
+  int max_readahead_bytes;
+  // Should a miss next to valid lines read the rest of the page?
+  int within_page_readahead;
+  // Bounds for ain_max
+  unsigned int ain_min;
+  unsigned int ain_limit;
+  // Counts for the current epoch
+  unsigned int epoch_misses;
+  unsigned int epoch_aout_hits;
+  uint64_t epoch_evicted_lines;
+  uint64_t epoch_unused_lines;
+
   // Free pages
   struct page_list_s* free_pages_head; // singly-linked list
   // Free page list entries (all page pointers should be NULL)
@@ -676,6 +809,9 @@ struct rdcache_s {
 
 static void validate_cache(struct rdcache_s* tree);
 
+// Settings from the environment, read in chpl_cache_do_init().
+static size_t cache_config_size = 0;
+static int cache_config_adapt = 1;
 
 static
 struct rdcache_s* cache_create(void) {
@@ -703,6 +839,12 @@ struct rdcache_s* cache_create(void) {
     cache_pages = MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
   if( cache_pages > MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
     cache_pages = MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
+  // An explicitly requested size only has to meet the minimum.
+  if( cache_config_size != 0 ) {
+    cache_pages = cache_config_size / CACHEPAGE_SIZE;
+    if( cache_pages < MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
+      cache_pages = MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
+  }
 
   ain_pages = cache_pages / 4; // 2Q: "Kin should be 25% of page slots"
   aout_pages = cache_pages / 2; // 2Q: "Kout should hold identifiers for as
@@ -773,10 +915,23 @@ struct rdcache_s* cache_create(void) {
 
   c->cacheInUse = 0;
 
+  atomic_init_spinlock_t(&c->sharedLock);
+  c->shared_next_request_number = NULL;
+
   c->max_pages = cache_pages;
   c->max_entries = n_entries;
   c->max_top_nodes = top_entries;
 
+  c->adapt = cache_config_adapt;
+  c->max_readahead_bytes = MAX_SEQUENTIAL_READAHEAD_BYTES;
+  c->within_page_readahead = ENABLE_READAHEAD_TRIGGER_WITHIN_PAGE;
+  c->ain_min = cache_pages / 10;
+  c->ain_limit = cache_pages / 2;
+  c->epoch_misses = 0;
+  c->epoch_aout_hits = 0;
+  c->epoch_evicted_lines = 0;
+  c->epoch_unused_lines = 0;
+
   // Set up free_pages as a linked list of page list entries
   // pointing to the free pages.
   c->free_pages_head = &page_list_entries[0];
@@ -799,6 +954,7 @@ struct rdcache_s* cache_create(void) {
     else next = NULL;
     entries[i].base.next = next;
     entries[i].queue = QUEUE_FREE;
+    entries[i].fill_thread = 0;
   }
 
 
@@ -1383,6 +1539,33 @@ void wait_for(struct rdcache_s* cache, cache_seqn_t sn)
   do_wait_for(cache, sn);
 }
 
+static inline
+int cache_is_shared(struct rdcache_s* cache)
+{
+  return cache->shared_next_request_number != NULL;
+}
+
+// Returns the sequence number for a new request and advances the counter.
+static inline
+cache_seqn_t take_sequence_number(struct rdcache_s* cache)
+{
+  if( cache_is_shared(cache) )
+    return atomic_fetch_add_int_least64_t(cache->shared_next_request_number, 1);
+  return cache->next_request_number++;
+}
+
+// Returns the sequence number that the next request will get,
+// without advancing the counter.
+static inline
+cache_seqn_t peek_sequence_number(struct rdcache_s* cache)
+{
+  if( cache_is_shared(cache) )
+    return atomic_load_int_least64_t(cache->shared_next_request_number);
+  return cache->next_request_number;
+}
+
+static int32_t cache_thread_id(void);
+
 static
 cache_seqn_t pending_push(struct rdcache_s* cache, chpl_comm_nb_handle_t handle)
 {
@@ -1402,8 +1585,7 @@ cache_seqn_t pending_push(struct rdcache_s* cache, chpl_comm_nb_handle_t handle)
     assert( cache->pending[index] == NULL );
   }
 
-  sn = cache->next_request_number;
-  cache->next_request_number++;
+  sn = take_sequence_number(cache);
 
   fifo_circleb_push(&cache->pending_first_entry, &cache->pending_last_entry, cache->pending_len);
   index = cache->pending_last_entry;
@@ -1697,6 +1879,8 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
   uintptr_t num_lines, skip_lines;
   chpl_comm_nb_handle_t handle;
   uintptr_t got_skip, got_len;
+  uint64_t fetched_lines = 0, unused_lines = 0;
+  int i;
   
   DEBUG_PRINT(("flush_entry(%p, %i, %p, %i)\n",
                entry, op, (void*) raddr, (int) len));
@@ -1794,6 +1978,17 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
 
   // If evicting, remove the page from the cache and put it on a free list.
   if( op & FLUSH_DO_EVICT ) {
+    // Count the lines we fetched but never read, to tune readahead.
+    for( i = 0; i < CACHE_LINES_PER_PAGE_BITMASK_WORDS; i++ ) {
+      fetched_lines += chpl_bitops_popcount_64(entry->valid_lines[i]);
+      unused_lines += chpl_bitops_popcount_64(entry->valid_lines[i] &
+                                              ~entry->used_lines[i]);
+    }
+    cache->epoch_evicted_lines += fetched_lines;
+    cache->epoch_unused_lines += unused_lines;
+    chpl_comm_diags_incr(cache_evictions);
+    chpl_comm_diags_add(cache_lines_unused, unused_lines);
+
     // But, our entry no longer can have a page associated with it.
     page = entry->page;
     entry->page = NULL;
@@ -1876,6 +2071,7 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     assert(bottom_match->queue == QUEUE_AOUT);
 
     DEBUG_PRINT(("%d: Found %p in Aout\n", chpl_nodeID, (void*) raddr));
+    tree->epoch_aout_hits++;
     // add X to the head of Am
     DOUBLE_REMOVE(tree, bottom_match, aout);
     tree->aout_current--;
@@ -1887,8 +2083,9 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     bottom_match->readahead_len = 0;
     // Set the page to the one the caller already allocated
     bottom_match->page = page;
-    // Clear the valid lines
+    // Clear the valid and used lines
     memset(&bottom_match->valid_lines, 0, sizeof(uint64_t)*CACHE_LINES_PER_PAGE_BITMASK_WORDS);
+    memset(&bottom_match->used_lines, 0, sizeof(uint64_t)*CACHE_LINES_PER_PAGE_BITMASK_WORDS);
     // Clear the dirty pointer and sequence numbers.
     bottom_match->dirty = NULL;
     bottom_match->min_sequence_number = NO_SEQUENCE_NUMBER;
@@ -1916,6 +2113,7 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     bottom_tmp->prev = NULL;
     bottom_tmp->page = page;
     memset(&bottom_tmp->valid_lines, 0, sizeof(uint64_t)*CACHE_LINES_PER_PAGE_BITMASK_WORDS);
+    memset(&bottom_tmp->used_lines, 0, sizeof(uint64_t)*CACHE_LINES_PER_PAGE_BITMASK_WORDS);
     bottom_tmp->dirty = NULL;
     bottom_tmp->min_sequence_number = NO_SEQUENCE_NUMBER;
     bottom_tmp->max_put_sequence_number = NO_SEQUENCE_NUMBER;
@@ -1990,6 +2188,9 @@ void cache_put(struct rdcache_s* cache,
     // Ignore entries in Aout for now.
     if( entry && ! entry->page ) entry = NULL;
 
+    if( entry ) chpl_comm_diags_incr(cache_put_hits);
+    else chpl_comm_diags_incr(cache_put_misses);
+
     if( entry ) {
       // Is this cache line available for use, based on when we
       // last ran an acquire fence?
@@ -2031,11 +2232,11 @@ void cache_put(struct rdcache_s* cache,
     // Op will be started for this in flush_entry for a dirty page.
 
     // This will increment next request number so cache events are recorded.
-    sn = cache->next_request_number;
-    cache->next_request_number++;
+    sn = take_sequence_number(cache);
     // Set the minimum sequence number so an acquire fence before
     // the next read will cause this write to be disregarded.
     entry->min_sequence_number = seqn_min(entry->min_sequence_number, sn);
+    if( cache_is_shared(cache) ) entry->fill_thread = cache_thread_id();
 
     assert(page != NULL);
 
@@ -2101,6 +2302,59 @@ void cache_get(struct rdcache_s* cache,
                 int sequential_readahead_length,
                 int32_t commID, int ln, int32_t fn);
 
+// Record that a GET read start..end-1 (within the page at ra_page).
+static inline
+void mark_used_lines(struct cache_entry_s* entry, raddr_t ra_page,
+                     raddr_t start, raddr_t end)
+{
+  uintptr_t first = (start - ra_page) >> CACHELINE_BITS;
+  uintptr_t last = (end - 1 - ra_page) >> CACHELINE_BITS;
+  set_valid_lines(entry->used_lines, first, last - first + 1);
+}
+
+// Adjust the readahead window and the 2Q queue sizes based on what
+// happened in the last epoch. See "Adapting to the Access Pattern" above.
+static
+void cache_adapt(struct rdcache_s* cache)
+{
+  unsigned int step;
+
+  if( cache->epoch_evicted_lines > 0 ) {
+    if( 2 * cache->epoch_unused_lines > cache->epoch_evicted_lines ) {
+      // More than half of what we fetched was never read.
+      if( cache->max_readahead_bytes > CACHEPAGE_SIZE )
+        cache->max_readahead_bytes /= 2;
+      if( 4 * cache->epoch_unused_lines > 3 * cache->epoch_evicted_lines )
+        cache->within_page_readahead = 0;
+    } else if( 8 * cache->epoch_unused_lines < cache->epoch_evicted_lines ) {
+      // Nearly everything we fetched was read.
+      cache->within_page_readahead = ENABLE_READAHEAD_TRIGGER_WITHIN_PAGE;
+      if( cache->max_readahead_bytes < MAX_ADAPTIVE_READAHEAD_BYTES )
+        cache->max_readahead_bytes *= 2;
+    }
+  }
+
+  step = cache->max_pages / 32;
+  if( step == 0 ) step = 1;
+  if( 10 * cache->epoch_aout_hits > cache->epoch_misses ) {
+    // Pages are re-used, but fall out of Ain before they get to Am.
+    cache->ain_max += step;
+    if( cache->ain_max > cache->ain_limit ) cache->ain_max = cache->ain_limit;
+  } else if( 50 * cache->epoch_aout_hits < cache->epoch_misses ) {
+    if( cache->ain_max > cache->ain_min + step ) cache->ain_max -= step;
+    else cache->ain_max = cache->ain_min;
+  }
+
+  INFO_PRINT(("%i cache adapt: readahead %i within-page %i ain_max %i\n",
+              (int) chpl_nodeID, cache->max_readahead_bytes,
+              cache->within_page_readahead, (int) cache->ain_max));
+
+  cache->epoch_misses = 0;
+  cache->epoch_aout_hits = 0;
+  cache->epoch_evicted_lines = 0;
+  cache->epoch_unused_lines = 0;
+}
+
 static
 void cache_get_trigger_readahead(struct rdcache_s* cache,
                                  c_nodeid_t node,
@@ -2132,8 +2386,8 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
   if( ENABLE_READAHEAD && skip && ! is_congested(cache) ) {
     next_ra_length = 2 * len;
 
-    if( next_ra_length > MAX_SEQUENTIAL_READAHEAD_BYTES )
-      next_ra_length = MAX_SEQUENTIAL_READAHEAD_BYTES;
+    if( next_ra_length > cache->max_readahead_bytes )
+      next_ra_length = cache->max_readahead_bytes;
 
     if( skip < 0 )
       next_ra_length = - next_ra_length;
@@ -2185,6 +2439,14 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
     //printf("C ok %i prefetch_start %p prefetch_end %p\n",
     //       ok, (void*) prefetch_start, (void*) prefetch_end);
 
+    // In the shared mode, the readahead has to stay in the same shard,
+    // that is, within the shard region containing page_raddr.
+    if( ok && cache_is_shared(cache) ) {
+      raddr_t region = round_down_to_mask(page_raddr, CACHE_SHARD_REGION_MASK);
+      prefetch_start = raddr_max(prefetch_start, region);
+      prefetch_end = raddr_min(prefetch_end, region + CACHE_SHARD_REGION_SIZE);
+    }
+
     if( ok && prefetch_start < prefetch_end ) {
       INFO_PRINT(("%i starting readahead from %p to %p\n",
                   (int) chpl_nodeID, (void*) (prefetch_start), (void*) (prefetch_end)));
@@ -2257,6 +2519,7 @@ void cache_get(struct rdcache_s* cache,
   int has_data;
   unsigned char* page;
   cache_seqn_t sn = NO_SEQUENCE_NUMBER;
+  cache_seqn_t start_sn;
   int isprefetch = (addr == NULL);
   int entry_after_acquire;
   chpl_comm_nb_handle_t handle;
@@ -2288,8 +2551,8 @@ void cache_get(struct rdcache_s* cache,
 
   // If the request is too large to reasonably fit in the cache, limit
   // the amount of data prefetched. (or do nothing?)
-  if( isprefetch && (ra_last_page-ra_first_page)/CACHEPAGE_SIZE+1 > MAX_PAGES_PER_PREFETCH ) {
-    ra_last_page = ra_first_page + CACHEPAGE_SIZE*MAX_PAGES_PER_PREFETCH;
+  if( isprefetch && (ra_last_page-ra_first_page)/CACHEPAGE_SIZE+1 > cache->max_readahead_bytes/CACHEPAGE_SIZE ) {
+    ra_last_page = ra_first_page + cache->max_readahead_bytes;
   }
 
   // Try to find it in the cache. Go through one page at a time.
@@ -2340,7 +2603,8 @@ void cache_get(struct rdcache_s* cache,
       
       ra = 0;
 
-      if( ENABLE_READAHEAD_TRIGGER_WITHIN_PAGE && entry ) {
+      if( ENABLE_READAHEAD_TRIGGER_WITHIN_PAGE &&
+          cache->within_page_readahead && entry ) {
         ra = should_readahead_extend(entry->valid_lines,
                                  (ra_line - ra_page) >> CACHELINE_BITS,
                                  (ra_line_end - ra_line) >> CACHELINE_BITS);
@@ -2415,6 +2679,12 @@ void cache_get(struct rdcache_s* cache,
         // If the cache line is in Am, move it to the front of Am.
         use_entry(cache, entry);
         if( ! isprefetch ) {
+          chpl_comm_diags_incr(cache_get_hits);
+          mark_used_lines(entry, ra_page, requested_start, requested_end);
+          if( cache_is_shared(cache) &&
+              entry->fill_thread != cache_thread_id() ) {
+            chpl_comm_diags_incr(cache_shared_hit);
+          }
       
           //printf("cache hit on page %i:%p %p ra_len %i\n", 
           //       node, (void*) ra_page, (void*) requested_start,
@@ -2482,6 +2752,11 @@ void cache_get(struct rdcache_s* cache,
 #ifdef TIME
     clock_gettime(CLOCK_REALTIME, &start_get1);
 #endif
+    // In the shared mode, another pthread could run an acquire fence
+    // while the get is in flight, so the data is only as new as the
+    // sequence number current when the get started.
+    start_sn = peek_sequence_number(cache);
+
     // Note: chpl_comm_get_nb could cause a different task body to run.
     handle = 
       chpl_comm_get_nb(page+(ra_line-ra_page), /*local addr*/
@@ -2507,8 +2782,7 @@ void cache_get(struct rdcache_s* cache,
 
     if( ! isprefetch ) {
       // This will increment next request number so cache events are recorded.
-      sn = cache->next_request_number;
-      cache->next_request_number++;
+      sn = take_sequence_number(cache);
     } else {
       // For a prefetch, store sequence number and record operation handle.
 
@@ -2518,7 +2792,9 @@ void cache_get(struct rdcache_s* cache,
     }
 
     // Set the minimum sequence number
-    entry->min_sequence_number = seqn_min(entry->min_sequence_number, sn);
+    entry->min_sequence_number = seqn_min(entry->min_sequence_number,
+                                          start_sn);
+    if( cache_is_shared(cache) ) entry->fill_thread = cache_thread_id();
 
     // Decide what to store in the readahead trigger for this page
     // if we are currently doing a readahead.
@@ -2584,7 +2860,12 @@ void cache_get(struct rdcache_s* cache,
       chpl_memcpy(addr+(requested_start-raddr),
                   page+(requested_start-ra_page),
                   requested_size);
-  
+
+      mark_used_lines(entry, ra_page, requested_start, requested_end);
+
+      chpl_comm_diags_incr(cache_get_misses);
+      if( cache->adapt && ++cache->epoch_misses >= CACHE_ADAPT_EPOCH )
+        cache_adapt(cache);
     }
   }
 
@@ -2682,6 +2963,45 @@ static struct rdcache_s* cache_create(void);
 CHPL_TLS_DECL(struct rdcache_s*,cache_remote_data);
 static pthread_key_t pthread_cache_info_key; // stores struct rdcache_s*
 
+// The shared mode; see "Sharing the Cache Between Threads" above.
+static chpl_bool cache_shared = false;
+static int cache_num_shards = 0;
+static struct rdcache_s** cache_shards = NULL;
+static atomic_int_least64_t cache_shared_next_request_number;
+
+// A small per-pthread number used to notice cross-thread hits.
+CHPL_TLS_DECL(intptr_t,cache_thread_id_tls);
+static atomic_int_least32_t cache_next_thread_id;
+
+static
+int32_t cache_thread_id(void) {
+  intptr_t id = (intptr_t) CHPL_TLS_GET(cache_thread_id_tls);
+  if( id == 0 ) {
+    id = 1 + atomic_fetch_add_int_least32_t(&cache_next_thread_id, 1);
+    CHPL_TLS_SET(cache_thread_id_tls, id);
+  }
+  return (int32_t) id;
+}
+
+// One access stream being tracked for stride prefetching.
+struct stride_stream_s {
+  c_nodeid_t node;        // -1 if this stream is unused
+  raddr_t last_line;      // start of the line of the last access
+  intptr_t stride;        // in bytes; 0 if not yet known
+  int confidence;         // how many times has the stride repeated?
+  raddr_t prefetched_to;  // line of the furthest prefetch along the stride
+  unsigned int last_use;  // for replacing the least recently used stream
+};
+
+struct stride_detector_s {
+  unsigned int clock;
+  struct stride_stream_s streams[STRIDE_STREAMS];
+};
+
+static chpl_bool stride_prefetch_enabled = false;
+CHPL_TLS_DECL(struct stride_detector_s*,cache_stride_detector);
+static pthread_key_t pthread_stride_detector_key; // for the destructor
+
 static
 struct rdcache_s* tls_cache_remote_data(void) {
   struct rdcache_s *cache = CHPL_TLS_GET(cache_remote_data);
@@ -2693,12 +3013,45 @@ struct rdcache_s* tls_cache_remote_data(void) {
   return cache;
 }
 
+// Which shard handles node:raddr in the shared mode?
+static inline
+struct rdcache_s* shard_for(c_nodeid_t node, raddr_t raddr) {
+  uint64_t h = ((uint64_t) (raddr >> CACHE_SHARD_REGION_BITS)) ^
+               (((uint64_t) node) << 40);
+  h *= UINT64_C(0x9E3779B97F4A7C15); // Fibonacci hashing
+  return cache_shards[(h >> 32) & (cache_num_shards - 1)];
+}
+
+// Returns the cache that handles node:raddr for the calling pthread.
+static inline
+struct rdcache_s* cache_for(c_nodeid_t node, raddr_t raddr) {
+  if( cache_shared ) return shard_for(node, raddr);
+  return tls_cache_remote_data();
+}
+
+// How much of raddr..raddr+size-1 can be handled by cache_for(node, raddr)?
+// In the shared mode, requests are split at shard region boundaries.
+static inline
+size_t cache_piece_size(raddr_t raddr, size_t size) {
+  raddr_t region_end;
+  if( ! cache_shared ) return size;
+  region_end = round_down_to_mask(raddr, CACHE_SHARD_REGION_MASK) +
+               CACHE_SHARD_REGION_SIZE;
+  return (raddr + size > region_end) ? (size_t) (region_end - raddr) : size;
+}
+
 // cache_lock and cache_unlock implement a "lock"
 // it's not a traditional lock because it only handles
 // the case of multiple tasks being multiplexed on one thread
 // (vs handling separate threads accessing the same data structure).
+// In the shared mode it is a real spinlock, since shards are used
+// by all of the pthreads.
 static
 void cache_lock(struct rdcache_s* cache) {
+  if( cache_is_shared(cache) ) {
+    atomic_lock_spinlock_t(&cache->sharedLock);
+    return;
+  }
   while (cache->cacheInUse != 0) {
     chpl_task_yield();
   }
@@ -2707,6 +3060,10 @@ void cache_lock(struct rdcache_s* cache) {
 
 static
 void cache_unlock(struct rdcache_s* cache) {
+  if( cache_is_shared(cache) ) {
+    atomic_unlock_spinlock_t(&cache->sharedLock);
+    return;
+  }
   cache->cacheInUse = 0;
 }
 
@@ -2725,6 +3082,54 @@ void destroy_pthread_local_cache(void* arg)
   cache_destroy(s);
 }
 
+static
+void destroy_pthread_stride_detector(void* arg)
+{
+  chpl_free(arg);
+}
+
+static
+struct stride_detector_s* tls_stride_detector(void) {
+  struct stride_detector_s* sd = CHPL_TLS_GET(cache_stride_detector);
+  int i;
+  if( ! sd ) {
+    sd = chpl_malloc(sizeof(struct stride_detector_s));
+    sd->clock = 0;
+    for( i = 0; i < STRIDE_STREAMS; i++ ) {
+      sd->streams[i].node = -1;
+      sd->streams[i].stride = 0;
+      sd->streams[i].confidence = 0;
+      sd->streams[i].last_use = 0;
+    }
+    CHPL_TLS_SET(cache_stride_detector, sd);
+    pthread_setspecific(pthread_stride_detector_key, sd);
+  }
+  return sd;
+}
+
+static
+void create_shared_caches(void)
+{
+  int64_t n;
+  int i;
+
+  n = chpl_env_rt_get_int("CACHE_REMOTE_SHARDS", DEFAULT_CACHE_SHARDS);
+  if( n < 1 ) n = 1;
+  if( n > MAX_CACHE_SHARDS ) n = MAX_CACHE_SHARDS;
+  // shard_for() needs a power of 2.
+  cache_num_shards = 1;
+  while( cache_num_shards < n ) cache_num_shards *= 2;
+
+  atomic_init_int_least64_t(&cache_shared_next_request_number, 1);
+
+  cache_shards = chpl_malloc(sizeof(struct rdcache_s*) * cache_num_shards);
+  for( i = 0; i < cache_num_shards; i++ ) {
+    cache_shards[i] = cache_create();
+    cache_shards[i]->shared_next_request_number =
+      &cache_shared_next_request_number;
+  }
+}
+
 static
 void chpl_cache_do_init(void)
 {
@@ -2734,6 +3139,7 @@ void chpl_cache_do_init(void)
     // Quick configuration check...
     assert(OTHER_BITS+TOP_BITS+OTHER_BITS+BOTTOM_BITS+CACHEPAGE_BITS == 64);
     assert(HALF_BITS + HALF_BITS + CACHEPAGE_BITS == 64);
+    assert(CACHE_SHARD_REGION_SIZE % CACHEPAGE_SIZE == 0);
 
     // Otherwise, we will need some thread-local storage.
     // We create two versions: cache_remote_data stores
@@ -2744,10 +3150,161 @@ void chpl_cache_do_init(void)
     // The second key we never read but create so that we
     // can free the cache when the thread exits.
     pthread_key_create(&pthread_cache_info_key, &destroy_pthread_local_cache);
+
+    CHPL_TLS_INIT(cache_thread_id_tls);
+    atomic_init_int_least32_t(&cache_next_thread_id, 0);
+
+    stride_prefetch_enabled =
+      chpl_env_rt_get_bool("CACHE_REMOTE_STRIDE_PREFETCH", true);
+    cache_config_size = chpl_env_rt_get_size("CACHE_REMOTE_SIZE", 0);
+    cache_config_adapt = chpl_env_rt_get_bool("CACHE_REMOTE_ADAPT", true);
+    CHPL_TLS_INIT(cache_stride_detector);
+    pthread_key_create(&pthread_stride_detector_key,
+                       &destroy_pthread_stride_detector);
+
+    cache_shared = chpl_env_rt_get_bool("CACHE_REMOTE_SHARED", false);
+#ifdef CHPL_COMM_NB_HANDLES_THREAD_BOUND
+    if( cache_shared ) {
+      if( chpl_nodeID == 0 ) {
+        chpl_warning("CHPL_RT_CACHE_REMOTE_SHARED is not supported by this "
+                     "comm layer; using a remote cache per pthread", 0, 0);
+      }
+      cache_shared = false;
+    }
+#endif
+    if( cache_shared ) create_shared_caches();
+
     inited = 1;
   }
 }
 
+// Invalidate node:raddr..raddr+size-1 in whichever cache handles it
+// for the calling pthread.
+static
+void invalidate_any(c_nodeid_t node, raddr_t raddr, size_t size)
+{
+  struct rdcache_s* cache;
+  size_t piece;
+
+  if( chpl_nodeID == node ) return;
+
+  while( size > 0 ) {
+    piece = cache_piece_size(raddr, size);
+    cache = cache_for(node, raddr);
+    cache_lock(cache);
+    cache_invalidate(cache, node, raddr, piece);
+    cache_unlock(cache);
+    raddr += piece;
+    size -= piece;
+  }
+}
+
+// Is line on the far side of 'to' when going in the stride's direction?
+static inline
+int stride_beyond(intptr_t stride, raddr_t line, raddr_t to)
+{
+  return (stride > 0) ? (line > to) : (line < to);
+}
+
+// Record a GET of node:raddr..raddr+size-1 with the calling pthread's stride
+// detector and start prefetches ahead of a confirmed stride.
+// Must be called without holding any cache lock.
+static
+void stride_observe(c_nodeid_t node, raddr_t raddr, size_t size,
+                    int32_t commID, int ln, int32_t fn)
+{
+  struct stride_detector_s* sd = tls_stride_detector();
+  struct stride_stream_s* s;
+  struct stride_stream_s* match = NULL;
+  struct stride_stream_s* nearest = NULL;
+  struct stride_stream_s* victim = NULL;
+  struct rdcache_s* cache;
+  raddr_t line = round_down_to_mask(raddr, CACHELINE_MASK);
+  raddr_t target;
+  uintptr_t dist, nearest_dist = STRIDE_MAX_DISTANCE + 1;
+  int depth, k, i;
+
+  sd->clock++;
+
+  for( i = 0; i < STRIDE_STREAMS; i++ ) {
+    s = &sd->streams[i];
+    if( s->node == node ) {
+      if( line == s->last_line ) {
+        // Another access to the same line tells us nothing new.
+        s->last_use = sd->clock;
+        return;
+      }
+      if( s->stride != 0 && line == s->last_line + s->stride ) {
+        match = s;
+        break;
+      }
+      dist = (line > s->last_line) ? line - s->last_line : s->last_line - line;
+      if( dist < nearest_dist ) {
+        nearest = s;
+        nearest_dist = dist;
+      }
+    }
+    if( ! victim || s->node == -1 ||
+        (victim->node != -1 && s->last_use < victim->last_use) )
+      victim = s;
+  }
+
+  if( match ) {
+    s = match;
+    if( s->confidence < STRIDE_MAX_DEPTH + STRIDE_CONFIRM ) s->confidence++;
+  } else if( nearest ) {
+    // Start (or restart) a stride from the nearest stream.
+    s = nearest;
+    s->stride = (intptr_t) line - (intptr_t) s->last_line;
+    s->confidence = 0;
+    s->prefetched_to = line;
+  } else {
+    s = victim;
+    s->node = node;
+    s->stride = 0;
+    s->confidence = 0;
+    s->prefetched_to = line;
+  }
+  s->last_line = line;
+  s->last_use = sd->clock;
+
+  // Sequential access is handled by readahead.
+  if( s->confidence < STRIDE_CONFIRM ||
+      s->stride == CACHELINE_SIZE || s->stride == -CACHELINE_SIZE )
+    return;
+
+  depth = s->confidence - STRIDE_CONFIRM + 1;
+  if( depth > STRIDE_MAX_DEPTH ) depth = STRIDE_MAX_DEPTH;
+
+  for( k = 1; k <= depth; k++ ) {
+    target = line + k * s->stride;
+    if( ! stride_beyond(s->stride, target, s->prefetched_to) ) continue;
+    if( chpl_task_guardPagesInUse() ||
+        ! chpl_comm_addr_gettable(node, (void*) (target + (raddr - line)),
+                                  size) )
+      break;
+
+    cache = cache_for(node, target);
+    cache_lock(cache);
+    if( is_congested(cache) ) {
+      cache_unlock(cache);
+      break;
+    }
+
+    INFO_PRINT(("%i stride prefetch %i:%p stride %i\n",
+                (int) chpl_nodeID, (int) node, (void*) target,
+                (int) s->stride));
+
+    cache_get(cache, NULL /* prefetch */, node,
+              target + (raddr - line),
+              cache_piece_size(target + (raddr - line), size),
+              task_private_cache_data()->last_acquire,
+              0, commID, ln, fn);
+    cache_unlock(cache);
+    s->prefetched_to = target;
+  }
+}
+
 // The implementation of functions in chpl-cache.h
 
 void chpl_cache_init(void) {
@@ -2766,10 +3323,39 @@ void chpl_cache_exit(void)
 }
 
 
+static
+void shared_cache_fence(int acquire, int release, int ln, int32_t fn)
+{
+  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  struct rdcache_s* cache;
+  int i;
+
+  INFO_PRINT(("%i shared fence acquire %i release %i %s:%i\n", chpl_nodeID, acquire, release, fn, ln));
+
+  if( acquire ) {
+    // Entries filled by GETs that were started before now have
+    // a smaller sequence number than this.
+    task_local->last_acquire =
+      1 + atomic_fetch_add_int_least64_t(&cache_shared_next_request_number, 1);
+  }
+
+  if( release ) {
+    for( i = 0; i < cache_num_shards; i++ ) {
+      cache = cache_shards[i];
+      cache_lock(cache);
+      cache_clean_dirty(cache);
+      wait_all(cache);
+      cache_unlock(cache);
+    }
+  }
+}
+
 void chpl_cache_fence(int acquire, int release, int ln, int32_t fn)
 {
   if( acquire == 0 && release == 0 ) return;
-  if( chpl_cache_enabled() ) {
+  if( chpl_cache_enabled() && cache_shared ) {
+    shared_cache_fence(acquire, release, ln, fn);
+  } else if( chpl_cache_enabled() ) {
     struct rdcache_s* cache = tls_cache_remote_data();
     cache_lock(cache);
     chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
@@ -2816,79 +3402,113 @@ void chpl_cache_comm_put(void* addr, c_nodeid_t node, void* raddr,
                          size_t size, int32_t commID, int ln, int32_t fn)
 {
   //printf("put len %d node %d raddr %p\n", (int) len * elemSize, node, raddr);
-  struct rdcache_s* cache = tls_cache_remote_data();
-  if (size_merits_direct_comm(cache, size)) {
-    cache_lock(cache);
-    cache_invalidate(cache, node, (raddr_t)raddr, size);
-    cache_unlock(cache);
+  struct rdcache_s* cache;
+  raddr_t ra = (raddr_t) raddr;
+  unsigned char* a = (unsigned char*) addr;
+  size_t piece;
+
+  if (size_merits_direct_comm(cache_for(node, ra), size)) {
+    invalidate_any(node, ra, size);
     chpl_comm_put(addr, node, raddr, size, commID, ln, fn);
     return;
   }
-  cache_lock(cache);
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
   TRACE_PRINT(("%d: task %d in chpl_cache_comm_put %s:%d put %d bytes to %d:%p "
                "from %p\n",
                chpl_nodeID, (int)chpl_task_getId(), chpl_lookupFilename(fn), ln,
                (int)size, node, raddr, addr));
   chpl_comm_diags_verbose_rdma("put", node, size, ln, fn, commID);
 
+  // This is one piece unless in the shared mode the put spans two shards.
+  do {
+    piece = cache_piece_size(ra, size);
+    cache = cache_for(node, ra);
+    cache_lock(cache);
+    chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+
 #ifdef DUMP
-  chpl_cache_print();
+    chpl_cache_print();
 #endif
 
-  //saturating_increment(&info->put_since_release);
-  //task_local->last_op = seqn_max(cache, addr, node, raddr, size);
-  cache_put(cache, addr, node, (raddr_t)raddr, size, task_local->last_acquire,
-            commID, ln, fn);
-  cache_unlock(cache);
-  return;
+    //saturating_increment(&info->put_since_release);
+    //task_local->last_op = seqn_max(cache, addr, node, raddr, size);
+    cache_put(cache, a, node, ra, piece, task_local->last_acquire,
+              commID, ln, fn);
+    cache_unlock(cache);
+    a += piece;
+    ra += piece;
+    size -= piece;
+  } while( size > 0 );
 }
 
 void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
                          size_t size, int32_t commID, int ln, int32_t fn)
 {
   //printf("get len %d node %d raddr %p\n", (int) len * elemSize, node, raddr);
-  struct rdcache_s* cache = tls_cache_remote_data();
-  if (size_merits_direct_comm(cache, size)) {
-    cache_lock(cache);
-    cache_invalidate(cache, node, (raddr_t)raddr, size);
-    cache_unlock(cache);
+  struct rdcache_s* cache;
+  raddr_t ra = (raddr_t) raddr;
+  unsigned char* a = (unsigned char*) addr;
+  size_t piece;
+
+  if (size_merits_direct_comm(cache_for(node, ra), size)) {
+    invalidate_any(node, ra, size);
     chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
     return;
   }
-  cache_lock(cache);
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
   TRACE_PRINT(("%d: task %d in chpl_cache_comm_get %s:%d get %d bytes from "
                "%d:%p to %p\n",
                chpl_nodeID, (int)chpl_task_getId(), chpl_lookupFilename(fn), ln,
                (int)size, node, raddr, addr));
   chpl_comm_diags_verbose_rdma("get", node, size, ln, fn, commID);
 
+  // This is one piece unless in the shared mode the get spans two shards.
+  do {
+    piece = cache_piece_size(ra, size);
+    cache = cache_for(node, ra);
+    cache_lock(cache);
+    chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+
 #ifdef DUMP
-  chpl_cache_print();
+    chpl_cache_print();
 #endif
 
-  //saturating_increment(&info->get_since_acquire);
-  cache_get(cache, addr, node, (raddr_t)raddr, size, task_local->last_acquire,
-            0, commID, ln, fn);
+    //saturating_increment(&info->get_since_acquire);
+    cache_get(cache, a, node, ra, piece, task_local->last_acquire,
+              0, commID, ln, fn);
 
-  cache_unlock(cache);
-  return;
+    cache_unlock(cache);
+    a += piece;
+    ra += piece;
+    size -= piece;
+  } while( size > 0 );
+
+  if( stride_prefetch_enabled ) {
+    stride_observe(node, (raddr_t) raddr, ra - (raddr_t) raddr,
+                   commID, ln, fn);
+  }
 }
 
 void chpl_cache_comm_prefetch(c_nodeid_t node, void* raddr,
                               size_t size, int32_t commID, int ln, int32_t fn)
 {
-  struct rdcache_s* cache = tls_cache_remote_data();
-  cache_lock(cache);
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  struct rdcache_s* cache;
+  raddr_t ra = (raddr_t) raddr;
+  size_t piece;
+
   TRACE_PRINT(("%d: in chpl_cache_comm_prefetch\n", chpl_nodeID));
   chpl_comm_diags_verbose_rdma("prefetch", node, size, ln, fn, commID);
   // Always use the cache for prefetches.
   //saturating_increment(&info->prefetch_since_acquire);
-  cache_get(cache, NULL, node, (raddr_t)raddr, size, task_local->last_acquire,
-            0, CHPL_COMM_UNKNOWN_ID, ln, fn);
-  cache_unlock(cache);
+  do {
+    piece = cache_piece_size(ra, size);
+    cache = cache_for(node, ra);
+    cache_lock(cache);
+    chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+    cache_get(cache, NULL, node, ra, piece, task_local->last_acquire,
+              0, CHPL_COMM_UNKNOWN_ID, ln, fn);
+    cache_unlock(cache);
+    ra += piece;
+    size -= piece;
+  } while( size > 0 );
 }
 void chpl_cache_comm_get_strd(void *addr, void *dststr, c_nodeid_t node,
                               void *raddr, void *srcstr, void *count,
@@ -2932,20 +3552,14 @@ void chpl_cache_comm_put_strd(void *addr, void *dststr, c_nodeid_t node,
 void chpl_cache_comm_put_unordered(void* addr, c_nodeid_t node, void* raddr,
                                    size_t size, int32_t commID, int ln, int32_t fn)
 {
-  struct rdcache_s* cache = tls_cache_remote_data();
-  cache_lock(cache);
-  cache_invalidate(cache, node, (raddr_t)raddr, size);
-  cache_unlock(cache);
+  invalidate_any(node, (raddr_t)raddr, size);
   chpl_comm_put_unordered(addr, node, raddr, size, commID, ln, fn);
 }
 
 void chpl_cache_comm_get_unordered(void *addr, c_nodeid_t node, void* raddr,
                                    size_t size, int32_t commID, int ln, int32_t fn)
 {
-  struct rdcache_s* cache = tls_cache_remote_data();
-  cache_lock(cache);
-  cache_invalidate(cache, node, (raddr_t)raddr, size);
-  cache_unlock(cache);
+  invalidate_any(node, (raddr_t)raddr, size);
   chpl_comm_get_unordered(addr, node, raddr, size, commID, ln, fn);
 }
 
@@ -2955,11 +3569,8 @@ void chpl_cache_comm_getput_unordered(c_nodeid_t dstnode, void* dstaddr,
                                       size_t size, int32_t commID,
                                       int ln, int32_t fn)
 {
-  struct rdcache_s* cache = tls_cache_remote_data();
-  cache_lock(cache);
-  cache_invalidate(cache, srcnode, (raddr_t)srcaddr, size);
-  cache_invalidate(cache, dstnode, (raddr_t)dstaddr, size);
-  cache_unlock(cache);
+  invalidate_any(srcnode, (raddr_t)srcaddr, size);
+  invalidate_any(dstnode, (raddr_t)dstaddr, size);
   chpl_comm_getput_unordered(dstnode, dstaddr, srcnode, srcaddr, size, commID, ln, fn);
 }
 
@@ -2969,18 +3580,40 @@ void chpl_cache_comm_getput_unordered_task_fence(void)
 }
 
 // This is for debugging.
+void chpl_cache_get_parameters(chpl_cacheParameters* cp)
+{
+  // With shared caches, all of the shards adapt the same way to
+  // (statistically) the same traffic, so report the first one.
+  struct rdcache_s* cache = cache_shared ? cache_shards[0]
+                                         : tls_cache_remote_data();
+
+  cp->page_size = CACHEPAGE_SIZE;
+  cp->line_size = CACHELINE_SIZE;
+  cp->cache_pages = cache->max_pages;
+  cp->ain_pages = cache->ain_max;
+  cp->aout_pages = cache->aout_max;
+  cp->readahead_bytes = cache->max_readahead_bytes;
+  cp->within_page_readahead = cache->within_page_readahead;
+}
+
 void chpl_cache_print(void)
 {
-  struct rdcache_s* cache = tls_cache_remote_data();
   chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  int i;
   printf("%d: cache dump last acquire %i\n", chpl_nodeID, (int) task_local->last_acquire);
-  rdcache_print(cache);
+  if( cache_shared ) {
+    for( i = 0; i < cache_num_shards; i++ ) {
+      printf("%d: shard %i\n", chpl_nodeID, i);
+      rdcache_print(cache_shards[i]);
+    }
+  } else {
+    rdcache_print(tls_cache_remote_data());
+  }
 }
 
-// This is for debugging.
-void chpl_cache_assert_released(void)
+static
+void cache_assert_released(struct rdcache_s* cache)
 {
-  struct rdcache_s* cache = tls_cache_remote_data();
   struct dirty_entry_s* cur;
   cache_seqn_t sn;
   int index;
@@ -2998,6 +3631,18 @@ void chpl_cache_assert_released(void)
   }
 }
 
+// This is for debugging.
+void chpl_cache_assert_released(void)
+{
+  int i;
+  if( cache_shared ) {
+    for( i = 0; i < cache_num_shards; i++ )
+      cache_assert_released(cache_shards[i]);
+  } else {
+    cache_assert_released(tls_cache_remote_data());
+  }
+}
+
 /*
 // Turn the cache on or off for debug purposes.
 void chpl_cache_set_enabled(int enabled)
@@ -25,24 +25,37 @@
 #include "chplrt.h"
 #include "chpl-env-gen.h"
 
+#include "chpl-cache.h"
 #include "chpl-comm.h"
 #include "chpl-comm-diags.h"
 #include "chpl-comm-internal.h"
+#include "chpl-mem.h"
 #include "chpl-mem-consistency.h"
+#include "chpl-thread-local-storage.h"
 #include "error.h"
 
+#include <errno.h>
+#include <pthread.h>
+
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 int chpl_verbose_comm = 0;
 int chpl_verbose_comm_stacktrace = 0;
 int chpl_comm_diagnostics = 0;
 int chpl_comm_diags_print_unstable = 0;
+int chpl_comm_profile = 0;
+int chpl_comm_profile_time = 0;
 
 atomic_int_least16_t chpl_comm_diags_disable_flag;
 chpl_atomic_commDiagnostics chpl_comm_diags_counters;
 
+int chpl_comm_diags_num_am_handlers = 0;
+atomic_uint_least64_t
+  chpl_comm_diags_am_handler_reqs[CHPL_COMM_DIAGS_MAX_AM_HANDLERS];
+
 static pthread_once_t bcastPrintUnstable_once = PTHREAD_ONCE_INIT;
 
 
@@ -143,3 +156,288 @@ void chpl_comm_resetDiagnosticsHere() {
 void chpl_comm_getDiagnosticsHere(chpl_commDiagnostics *cd) {
   chpl_comm_diags_copy(cd);
 }
+
+
+void chpl_comm_getCacheParametersHere(chpl_cacheParameters *cp) {
+  memset(cp, 0, sizeof(*cp));
+#ifdef HAS_CHPL_CACHE_FNS
+  if (chpl_cache_enabled())
+    chpl_cache_get_parameters(cp);
+#endif
+}
+
+
+int chpl_comm_getNumAmHandlersHere(void) {
+  return chpl_comm_diags_num_am_handlers;
+}
+
+
+uint64_t chpl_comm_getAmHandlerRequestsHere(int i) {
+  if (i < 0 || i >= chpl_comm_diags_num_am_handlers)
+    return 0;
+  return atomic_load_uint_least64_t(&chpl_comm_diags_am_handler_reqs[i]);
+}
+
+
+////////////////////
+//
+// Per-callsite profile
+//
+
+//
+// Each thread that initiates comm while profiling is on gets its own
+// open-addressed hash table of callsites, so that counting doesn't
+// contend.  The tables are linked together so they can be merged.
+// The lock on a table is only ever contended while it's being merged
+// or reset.
+//
+typedef struct profTable {
+  struct profTable* next;
+  pthread_mutex_t lock;
+  size_t size;                  // a power of 2
+  size_t used;
+  chpl_commProfileEntry* ents;
+} profTable_t;
+
+static pthread_mutex_t profTables_lock = PTHREAD_MUTEX_INITIALIZER;
+static profTable_t* profTables;
+
+static CHPL_TLS_DECL(profTable_t*, profTableMine);
+
+// The merged table, sorted, as of the last chpl_comm_mergeProfileHere().
+static chpl_commProfileEntry* profMerged;
+static size_t profMergedLen;
+
+
+void chpl_comm_diags_profile_init(void) {
+  CHPL_TLS_INIT(profTableMine);
+}
+
+
+static inline
+size_t profHash(const char* op, int32_t fn, int32_t ln, int32_t node) {
+  uint64_t h = ((uint64_t) (uint32_t) fn << 32 | (uint32_t) ln)
+               ^ ((uint64_t) node << 16);
+  for (const char* p = op; *p != '\0'; p++) {
+    h = h * 31 + *p;
+  }
+  h ^= h >> 29;
+  h *= UINT64_C(0xbf58476d1ce4e5b9);
+  h ^= h >> 32;
+  return (size_t) h;
+}
+
+
+static inline
+int profSameKey(const chpl_commProfileEntry* e,
+                const char* op, int32_t fn, int32_t ln, int32_t node) {
+  return e->fn == fn && e->ln == ln && e->node == node
+         && (e->op == op || strcmp(e->op, op) == 0);
+}
+
+
+//
+// Find or add the entry for a key.  The caller holds the table lock.
+//
+static
+chpl_commProfileEntry* profLookup(profTable_t* t, const char* op,
+                                  int32_t fn, int32_t ln, int32_t node) {
+  if (2 * (t->used + 1) > t->size) {
+    const size_t oldSize = t->size;
+    chpl_commProfileEntry* oldEnts = t->ents;
+    t->size = (oldSize == 0) ? 64 : 2 * oldSize;
+    t->ents = chpl_mem_calloc(t->size, sizeof(t->ents[0]),
+                              CHPL_RT_MD_COMM_UTIL, 0, 0);
+    for (size_t i = 0; i < oldSize; i++) {
+      if (oldEnts[i].op != NULL) {
+        size_t j = profHash(oldEnts[i].op, oldEnts[i].fn,
+                            oldEnts[i].ln, oldEnts[i].node) & (t->size - 1);
+        while (t->ents[j].op != NULL) {
+          j = (j + 1) & (t->size - 1);
+        }
+        t->ents[j] = oldEnts[i];
+      }
+    }
+    if (oldEnts != NULL) {
+      chpl_mem_free(oldEnts, 0, 0);
+    }
+  }
+
+  size_t j = profHash(op, fn, ln, node) & (t->size - 1);
+  while (t->ents[j].op != NULL) {
+    if (profSameKey(&t->ents[j], op, fn, ln, node)) {
+      return &t->ents[j];
+    }
+    j = (j + 1) & (t->size - 1);
+  }
+
+  t->ents[j] = (chpl_commProfileEntry) { .op = op, .fn = fn, .ln = ln,
+                                         .node = node };
+  t->used++;
+  return &t->ents[j];
+}
+
+
+void chpl_comm_diags_profile_add(const char* op, c_nodeid_t node,
+                                 size_t size, int ln, int32_t fn,
+                                 uint64_t count, uint64_t nsec) {
+  profTable_t* t = CHPL_TLS_GET(profTableMine);
+  if (t == NULL) {
+    t = chpl_mem_calloc(1, sizeof(*t), CHPL_RT_MD_COMM_UTIL, 0, 0);
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_mutex_lock(&profTables_lock);
+    t->next = profTables;
+    profTables = t;
+    pthread_mutex_unlock(&profTables_lock);
+    CHPL_TLS_SET(profTableMine, t);
+  }
+
+  pthread_mutex_lock(&t->lock);
+  chpl_commProfileEntry* e = profLookup(t, op, fn, ln, node);
+  e->count += count;
+  e->nbytes += count * size;
+  e->nsec += nsec;
+  pthread_mutex_unlock(&t->lock);
+}
+
+
+void chpl_comm_startProfile(chpl_bool time) {
+  // Make sure that there are no pending communication operations.
+  chpl_rmem_consist_release(0, 0);
+
+  chpl_comm_profile_time = (time == true);
+  chpl_comm_profile = 1;
+  chpl_comm_diags_disable();
+  chpl_comm_bcast_rt_private(chpl_comm_profile_time);
+  chpl_comm_bcast_rt_private(chpl_comm_profile);
+  chpl_comm_diags_enable();
+}
+
+
+void chpl_comm_stopProfile(void) {
+  // Make sure that there are no pending communication operations.
+  chpl_rmem_consist_release(0, 0);
+
+  chpl_comm_profile = 0;
+  chpl_comm_diags_disable();
+  chpl_comm_bcast_rt_private(chpl_comm_profile);
+  chpl_comm_diags_enable();
+}
+
+
+void chpl_comm_startProfileHere(chpl_bool time) {
+  // Make sure that there are no pending communication operations.
+  chpl_rmem_consist_release(0, 0);
+
+  chpl_comm_profile_time = (time == true);
+  chpl_comm_profile = 1;
+}
+
+
+void chpl_comm_stopProfileHere(void) {
+  // Make sure that there are no pending communication operations.
+  chpl_rmem_consist_release(0, 0);
+
+  chpl_comm_profile = 0;
+}
+
+
+void chpl_comm_resetProfileHere(void) {
+  pthread_mutex_lock(&profTables_lock);
+  for (profTable_t* t = profTables; t != NULL; t = t->next) {
+    pthread_mutex_lock(&t->lock);
+    memset(t->ents, 0, t->size * sizeof(t->ents[0]));
+    t->used = 0;
+    pthread_mutex_unlock(&t->lock);
+  }
+  pthread_mutex_unlock(&profTables_lock);
+
+  if (profMerged != NULL) {
+    chpl_mem_free(profMerged, 0, 0);
+    profMerged = NULL;
+  }
+  profMergedLen = 0;
+}
+
+
+static
+int profCmp(const void* v1, const void* v2) {
+  const chpl_commProfileEntry* e1 = (const chpl_commProfileEntry*) v1;
+  const chpl_commProfileEntry* e2 = (const chpl_commProfileEntry*) v2;
+  if (e1->count != e2->count)
+    return (e1->count > e2->count) ? -1 : 1;
+  if (e1->nbytes != e2->nbytes)
+    return (e1->nbytes > e2->nbytes) ? -1 : 1;
+  if (e1->fn != e2->fn)
+    return (e1->fn < e2->fn) ? -1 : 1;
+  if (e1->ln != e2->ln)
+    return (e1->ln < e2->ln) ? -1 : 1;
+  if (e1->node != e2->node)
+    return (e1->node < e2->node) ? -1 : 1;
+  return strcmp(e1->op, e2->op);
+}
+
+
+size_t chpl_comm_mergeProfileHere(void) {
+  profTable_t merged = { .size = 0, .used = 0, .ents = NULL };
+
+  pthread_mutex_lock(&profTables_lock);
+  for (profTable_t* t = profTables; t != NULL; t = t->next) {
+    pthread_mutex_lock(&t->lock);
+    for (size_t i = 0; i < t->size; i++) {
+      const chpl_commProfileEntry* te = &t->ents[i];
+      if (te->op != NULL) {
+        chpl_commProfileEntry* e = profLookup(&merged, te->op, te->fn,
+                                              te->ln, te->node);
+        e->count += te->count;
+        e->nbytes += te->nbytes;
+        e->nsec += te->nsec;
+      }
+    }
+    pthread_mutex_unlock(&t->lock);
+  }
+  pthread_mutex_unlock(&profTables_lock);
+
+  //
+  // Squeeze out the empty slots and sort, most frequent first.
+  //
+  size_t n = 0;
+  for (size_t i = 0; i < merged.size; i++) {
+    if (merged.ents[i].op != NULL) {
+      merged.ents[n++] = merged.ents[i];
+    }
+  }
+  if (n > 0) {
+    qsort(merged.ents, n, sizeof(merged.ents[0]), profCmp);
+  }
+
+  if (profMerged != NULL) {
+    chpl_mem_free(profMerged, 0, 0);
+  }
+  profMerged = merged.ents;
+  profMergedLen = n;
+  return n;
+}
+
+
+void chpl_comm_getProfileEntryHere(size_t i, chpl_commProfileEntry* e) {
+  if (i >= profMergedLen) {
+    memset(e, 0, sizeof(*e));
+    return;
+  }
+  *e = profMerged[i];
+}
+
+
+int chpl_comm_writeProfileFile(const char* filename, const char* text) {
+  FILE* f;
+  int err = 0;
+
+  if ((f = fopen(filename, "w")) == NULL)
+    return errno;
+  if (fputs(text, f) == EOF)
+    err = errno;
+  if (fclose(f) != 0 && err == 0)
+    err = errno;
+  return err;
+}
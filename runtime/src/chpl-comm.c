@@ -29,6 +29,7 @@
 #include "chpl-comm-internal.h"
 #include "chpl-env.h"
 #include "chpl-mem.h"
+#include "chpl-tasks.h"
 
 // Don't get warning macros for chpl_comm_get etc.
 #include "chpl-comm-no-warning-macros.h"
@@ -126,6 +127,267 @@ void chpl_comm_init_prv_bcast_tab(void) {
 }
 
 
+#define BCAST_FANOUT_DFLT 8
+
+static pthread_once_t bcastFanout_once = PTHREAD_ONCE_INIT;
+static int bcastFanout;
+
+static
+void set_bcastFanout(void)
+{
+  int64_t fanout = chpl_env_rt_get_int("COMM_BCAST_FANOUT",
+                                       BCAST_FANOUT_DFLT);
+  if (fanout < 1 || fanout >= chpl_numNodes) {
+    fanout = (chpl_numNodes > 1) ? chpl_numNodes - 1 : 1;
+  }
+  bcastFanout = (int) fanout;
+}
+
+int chpl_comm_bcast_fanout(void)
+{
+  if (pthread_once(&bcastFanout_once, set_bcastFanout) != 0) {
+    chpl_internal_error("pthread_once(&bcastFanout_once) failed");
+  }
+
+  return bcastFanout;
+}
+
+
+//
+// Allreduce support.
+//
+// Messages that have arrived for allreduces in progress here wait on
+// a list until the participating task looks for them.  They are
+// identified by the reduction id and the step of the algorithm they
+// are for.  The list is short: each reduction has at most one message
+// waiting per step.
+//
+typedef struct allreduce_msg_t {
+  struct allreduce_msg_t* next;
+  uint64_t id;
+  int step;
+  size_t size;
+  char data[];
+} allreduce_msg_t;
+
+static allreduce_msg_t* allreduceMsgs;
+static pthread_mutex_t allreduceMsgs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t allreduceNextId;
+
+uint64_t chpl_comm_allreduce_new_id(void)
+{
+  pthread_mutex_lock(&allreduceMsgs_mutex);
+  const uint64_t seq = allreduceNextId++;
+  pthread_mutex_unlock(&allreduceMsgs_mutex);
+
+  // Unique across nodes: the node ID goes in the upper bits.
+  return ((uint64_t) chpl_nodeID << 40) | (seq & ((UINT64_C(1) << 40) - 1));
+}
+
+void chpl_comm_allreduce_arrive(uint64_t id, int step,
+                                const void* data, size_t size)
+{
+  allreduce_msg_t* msg = chpl_mem_alloc(sizeof(*msg) + size,
+                                        CHPL_RT_MD_COMM_UTIL, 0, 0);
+  msg->id = id;
+  msg->step = step;
+  msg->size = size;
+  memcpy(msg->data, data, size);
+
+  pthread_mutex_lock(&allreduceMsgs_mutex);
+  msg->next = allreduceMsgs;
+  allreduceMsgs = msg;
+  pthread_mutex_unlock(&allreduceMsgs_mutex);
+}
+
+static
+allreduce_msg_t* allreduce_await(uint64_t id, int step, void (*poll)(void))
+{
+  while (true) {
+    pthread_mutex_lock(&allreduceMsgs_mutex);
+    for (allreduce_msg_t** pp = &allreduceMsgs; *pp != NULL;
+         pp = &(*pp)->next) {
+      if ((*pp)->id == id && (*pp)->step == step) {
+        allreduce_msg_t* msg = *pp;
+        *pp = msg->next;
+        pthread_mutex_unlock(&allreduceMsgs_mutex);
+        return msg;
+      }
+    }
+    pthread_mutex_unlock(&allreduceMsgs_mutex);
+
+    if (poll != NULL) {
+      (*poll)();
+    }
+    chpl_task_yield();
+  }
+}
+
+#define ALLREDUCE_COMBINE(T, acc, in, n, op)                            \
+  do {                                                                  \
+    T* _a = (T*) (acc);                                                 \
+    const T* _b = (const T*) (in);                                      \
+    for (size_t _i = 0; _i < (n); _i++) {                               \
+      switch (op) {                                                     \
+      case CHPL_COMM_REDUCE_SUM: _a[_i] += _b[_i]; break;               \
+      case CHPL_COMM_REDUCE_MIN: if (_b[_i] < _a[_i]) _a[_i] = _b[_i];  \
+                                 break;                                 \
+      case CHPL_COMM_REDUCE_MAX: if (_b[_i] > _a[_i]) _a[_i] = _b[_i];  \
+                                 break;                                 \
+      default: chpl_internal_error("unexpected allreduce op");          \
+      }                                                                 \
+    }                                                                   \
+  } while (0)
+
+static
+size_t allreduce_type_size(chpl_comm_reduce_type_t type)
+{
+  switch (type) {
+  case CHPL_COMM_REDUCE_INT32:  return sizeof(int32_t);
+  case CHPL_COMM_REDUCE_INT64:  return sizeof(int64_t);
+  case CHPL_COMM_REDUCE_UINT32: return sizeof(uint32_t);
+  case CHPL_COMM_REDUCE_UINT64: return sizeof(uint64_t);
+  case CHPL_COMM_REDUCE_REAL32: return sizeof(_real32);
+  case CHPL_COMM_REDUCE_REAL64: return sizeof(_real64);
+  case CHPL_COMM_REDUCE_BOOL:   return sizeof(chpl_bool);
+  }
+  chpl_internal_error("unexpected allreduce type");
+  return 0;
+}
+
+//
+// Combine 'n' values from 'in' into those at 'acc'.  All the
+// operations are commutative, so partners combining each other's
+// values in either order get the same result.
+//
+static
+void allreduce_combine(void* acc, const void* in, size_t n,
+                       chpl_comm_reduce_type_t type,
+                       chpl_comm_reduce_op_t op)
+{
+  switch (type) {
+  case CHPL_COMM_REDUCE_INT32:
+    ALLREDUCE_COMBINE(int32_t, acc, in, n, op);
+    break;
+  case CHPL_COMM_REDUCE_INT64:
+    ALLREDUCE_COMBINE(int64_t, acc, in, n, op);
+    break;
+  case CHPL_COMM_REDUCE_UINT32:
+    ALLREDUCE_COMBINE(uint32_t, acc, in, n, op);
+    break;
+  case CHPL_COMM_REDUCE_UINT64:
+    ALLREDUCE_COMBINE(uint64_t, acc, in, n, op);
+    break;
+  case CHPL_COMM_REDUCE_REAL32:
+    ALLREDUCE_COMBINE(_real32, acc, in, n, op);
+    break;
+  case CHPL_COMM_REDUCE_REAL64:
+    ALLREDUCE_COMBINE(_real64, acc, in, n, op);
+    break;
+  case CHPL_COMM_REDUCE_BOOL:
+    {
+      chpl_bool* a = (chpl_bool*) acc;
+      const chpl_bool* b = (const chpl_bool*) in;
+      for (size_t i = 0; i < n; i++) {
+        switch (op) {
+        case CHPL_COMM_REDUCE_LAND: a[i] = a[i] && b[i]; break;
+        case CHPL_COMM_REDUCE_LOR:  a[i] = a[i] || b[i]; break;
+        default: chpl_internal_error("unexpected allreduce op");
+        }
+      }
+    }
+    break;
+  }
+}
+
+#undef ALLREDUCE_COMBINE
+
+static
+void allreduce_recv_combine(uint64_t id, int step, void* buf, size_t n,
+                            chpl_comm_reduce_type_t type,
+                            chpl_comm_reduce_op_t op, void (*poll)(void))
+{
+  allreduce_msg_t* msg = allreduce_await(id, step, poll);
+  allreduce_combine(buf, msg->data, n, type, op);
+  chpl_mem_free(msg, 0, 0);
+}
+
+//
+// Recursive doubling.  With p the largest power of 2 not more than the
+// number of nodes, in each of log2(p) steps every node exchanges its
+// partial result with the node whose virtual rank differs from its own
+// in one bit, and both combine what they get with what they have.  If
+// the number of nodes isn't a power of 2, each of the first 2*(N-p)
+// even-numbered nodes first folds its values into the next node up and
+// then sits out the exchanges, getting the final result from that
+// neighbor at the end.  Values too large for one message are reduced
+// in pieces, one after another.
+//
+void chpl_comm_allreduce_rd(uint64_t id, void* buf, size_t count,
+                            chpl_comm_reduce_type_t type,
+                            chpl_comm_reduce_op_t op,
+                            chpl_comm_allreduce_send_t send,
+                            void (*poll)(void))
+{
+  if (chpl_numNodes <= 1 || count == 0) {
+    return;
+  }
+
+  const c_nodeid_t me = chpl_nodeID;
+  c_nodeid_t p = 1;
+  int numExch = 0;
+  while (2 * p <= chpl_numNodes) {
+    p *= 2;
+    numExch++;
+  }
+  const c_nodeid_t rem = chpl_numNodes - p;
+
+  const size_t eltSize = allreduce_type_size(type);
+  const size_t pieceCnt = CHPL_COMM_ALLREDUCE_MAX_MSG / eltSize;
+  const int stepsPerPiece = numExch + 2;
+
+  int stepBase = 0;
+  for (size_t i = 0; i < count; i += pieceCnt, stepBase += stepsPerPiece) {
+    char* piece = (char*) buf + i * eltSize;
+    const size_t n = (count - i < pieceCnt) ? count - i : pieceCnt;
+    const size_t size = n * eltSize;
+
+    // Step 0: the extra nodes fold their values into a neighbor.
+    c_nodeid_t vrank;
+    if (me < 2 * rem) {
+      if (me % 2 == 0) {
+        (*send)(me + 1, id, stepBase, piece, size);
+        allreduce_msg_t* msg =
+          allreduce_await(id, stepBase + numExch + 1, poll);
+        memcpy(piece, msg->data, size);
+        chpl_mem_free(msg, 0, 0);
+        continue;
+      }
+      allreduce_recv_combine(id, stepBase, piece, n, type, op, poll);
+      vrank = me / 2;
+    } else {
+      vrank = me - rem;
+    }
+
+    // Steps 1..numExch: the exchanges.
+    for (int s = 0; s < numExch; s++) {
+      const c_nodeid_t vpartner = vrank ^ (1 << s);
+      const c_nodeid_t partner = (vpartner < rem)
+                                 ? 2 * vpartner + 1
+                                 : vpartner + rem;
+      (*send)(partner, id, stepBase + s + 1, piece, size);
+      allreduce_recv_combine(id, stepBase + s + 1, piece, n, type, op, poll);
+    }
+
+    // Step numExch+1: hand the result back to a folded-in neighbor.
+    if (me < 2 * rem) {
+      (*send)(me - 1, id, stepBase + numExch + 1, piece, size);
+    }
+  }
+}
+
+
 static pthread_once_t maxHeapSize_once = PTHREAD_ONCE_INIT;
 static size_t maxHeapSize;
 
@@ -21,6 +21,8 @@
 #include "chplrt.h"
 
 #include "chplmemtrack.h"
+#include "chpl-atomics.h"
+#include "chpl-thread-local-storage.h"
 #include "chpl-mem.h"
 #include "chpl-mem-desc.h"
 #include "chpl-mem-sys.h"  // mem layer not initialized yet, need system alloc
@@ -29,6 +31,7 @@
 #include "chpl-comm.h"
 #include "chpl-comm-internal.h"
 #include "chplcgfns.h"
+#include "chpltimers.h"
 #include "chpl-linefile-support.h"
 #include "config.h"
 #include "error.h"
@@ -46,6 +49,7 @@
 
 int chpl_verbose_mem = 0;
 int chpl_memTrack = 0;
+int chpl_memSample = 0;
 
 static void
 printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
@@ -63,7 +67,10 @@ extern void chpl_memTracking_returnConfigVals(chpl_bool* memTrack,
                                               size_t* memMax,
                                               size_t* memThreshold,
                                               c_string* memLog,
-                                              c_string* memLeaksLog);
+                                              c_string* memLeaksLog,
+                                              size_t* memSampleInterval,
+                                              _real64* memSamplePeriod,
+                                              c_string* memSampleLog);
 
 typedef struct memTableEntry_struct { /* table entry */
   size_t number;
@@ -72,19 +79,57 @@ typedef struct memTableEntry_struct { /* table entry */
   void* memAlloc;
   int32_t lineno;
   int32_t filename;
+  size_t weight;        /* bytes this entry stands for in heap profiles */
   struct memTableEntry_struct* nextInBucket;
 } memTableEntry;
 
-#define NUM_HASH_SIZE_INDICES 20
+#define NUM_HASH_SIZE_INDICES 25
 
-static int hashSizes[NUM_HASH_SIZE_INDICES] = { 1543, 3079, 6151, 12289, 24593, 49157, 98317,
+static int hashSizes[NUM_HASH_SIZE_INDICES] = { 53, 97, 193, 389, 769,
+                                                1543, 3079, 6151, 12289, 24593, 49157, 98317,
                                                 196613, 393241, 786433, 1572869, 3145739,
                                                 6291469, 12582917, 25165843, 50331653,
                                                 100663319, 201326611, 402653189, 805306457 };
-static int hashSizeIndex = 0;
-static int hashSize = 0;
 
-static memTableEntry** memTable = NULL;
+//
+// The table of tracked allocations is split into shards, selected by
+// a hash of the allocation address.  Each shard is an independent
+// hash table with its own lock, size, and allocated/freed sums, so
+// concurrent allocations mostly touch different shards and a resize
+// only rehashes the one shard that outgrew its table.  An address
+// always maps to the same shard, so a free done by a different thread
+// than the matching allocation finds its entry.  The per-shard sums
+// are merged only when reporting.
+//
+// We can't use a sync var for concurrency control here.  The Qthreads
+// internal memory allocator shim references this memory tracking code
+// via the Chapel runtime public memory layer interface.  Referring to a
+// sync var here when exiting (to report memTrack results, say), after
+// the tasking layer is shut down, ends up trying to create a qthread in
+// the terminated Qthreads library.  Chaos results.  So, we use pthread
+// mutexes.  Note that this is only safe if we cannot switch tasks on a
+// pthread while holding a mutex and then try to lock it recursively.
+// Currently that is the case, since we do not yield while holding one.
+//
+#define MEMTRACK_NUM_SHARDS 64
+
+typedef struct {
+  pthread_mutex_t lock;
+  memTableEntry** table;
+  int hashSizeIndex;
+  int hashSize;
+  size_t numEntries;     /* number of entries in this shard */
+  size_t allocated;      /* memory allocated through this shard */
+  size_t freed;          /* memory freed through this shard */
+} memTableShard;
+
+// Keep each shard on its own cache line(s), to avoid false sharing.
+typedef union {
+  memTableShard s;
+  char pad[((sizeof(memTableShard) + 63) / 64) * 64];
+} memTableShardPadded;
+
+static memTableShardPadded memTable[MEMTRACK_NUM_SHARDS];
 
 static _Bool memStats = false;
 static _Bool memLeaksByType = false;
@@ -95,36 +140,64 @@ static size_t memThreshold = 0;
 static c_string memLog = NULL;
 static FILE* memLogFile = NULL;
 static c_string memLeaksLog = NULL;
+static size_t memSampleInterval = 0;
+static _real64 memSamplePeriod = 0.0;
+static c_string memSampleLog = NULL;
 
-static size_t totalMem = 0;       /* total memory currently allocated */
-static size_t maxMem = 0;         /* maximum total memory during run  */
-static size_t totalAllocated = 0; /* total memory allocated */
-static size_t totalFreed = 0;     /* total memory freed */
-static size_t totalEntries = 0;     /* number of entries in hash table */
+//
+// The current total and the high water mark need to be exact across
+// shards (the latter, and the memMax check, depend on the former), so
+// these are kept as global atomics rather than per-shard sums.
+//
+static atomic_uint_least64_t totalMem; /* total memory currently allocated */
+static atomic_uint_least64_t maxMem;   /* maximum total memory during run  */
 
 
-// We can't use a sync var for concurrency control here.  The Qthreads
-// internal memory allocator shim references this memory tracking code
-// via the Chapel runtime public memory layer interface.  Referring to a
-// sync var here when exiting (to report memTrack results, say), after
-// the tasking layer is shut down, ends up trying to create a qthread in
-// the terminated Qthreads library.  Chaos results.  We also cannot use
-// an atomic var, because with CHPL_ATOMICS=locks those are implemented
-// by means of sync vars.  So, we use a pthread mutex.  Note that this
-// is only safe if we cannot switch tasks on a pthread while holding the
-// mutex and then try to lock it recursively.  Currently that is the
-// case, since we do not yield while holding the mutex.
-// 
-static pthread_mutex_t memTrack_lockVar = PTHREAD_MUTEX_INITIALIZER;
+//
+// Sampling allocation profiler.
+//
+// With --memSampleInterval=N we track only a sample of allocations,
+// on average one per N bytes allocated by each thread, and write heap
+// profiles giving the estimated bytes in use per allocating source
+// line and allocation type.  The distance to the next sample is drawn
+// from an exponential distribution, so that the sampling can't alias
+// with periodic allocation patterns, and a sampled allocation of S
+// bytes stands for S/(1-exp(-S/N)) bytes, which makes the profile an
+// unbiased estimate.  Sampled allocations live in the table above,
+// but the free path needs a cheap way to tell that an address can't
+// have been sampled.  For that we keep a counting filter indexed by
+// address hash: a free only looks in the table if the count for its
+// address is nonzero.
+//
+// Profiles are written in the "folded stacks" format read by
+// flamegraph.pl and speedscope, one line per source location and
+// allocation type.  They are written at program end and, with
+// --memSamplePeriod=S, every S seconds or so during the run.
+//
+#define MEMSAMPLE_FILTER_SIZE (1 << 16)
+
+typedef struct {
+  int64_t bytesUntilSample;
+  uint64_t rand;
+} memSampleThreadState;
+
+static CHPL_TLS_DECL(memSampleThreadState*, memSampleState);
+
+static atomic_uint_least32_t* sampleFilter = NULL;
+
+static pthread_mutex_t memSampleDumpLock = PTHREAD_MUTEX_INITIALIZER;
+static _real64 memSampleNextDump = 0.0;
+static int memSampleDumpNum = 0;
+
 
 static inline
-void memTrack_lock(void) {
-  (void) pthread_mutex_lock(&memTrack_lockVar);
+void memTrack_lock(memTableShard* shard) {
+  (void) pthread_mutex_lock(&shard->lock);
 }
 
 static inline
-void memTrack_unlock(void) {
-  (void) pthread_mutex_unlock(&memTrack_lockVar);
+void memTrack_unlock(memTableShard* shard) {
+  (void) pthread_mutex_unlock(&shard->lock);
 }
 
 
@@ -155,7 +228,10 @@ void chpl_setMemFlags(void) {
                                     &memMax,
                                     &memThreshold,
                                     &memLog,
-                                    &memLeaksLog);
+                                    &memLeaksLog,
+                                    &memSampleInterval,
+                                    &memSamplePeriod,
+                                    &memSampleLog);
 
   chpl_memTrack = (local_memTrack
                    || memStats
@@ -164,6 +240,12 @@ void chpl_setMemFlags(void) {
                    || memLeaks
                    || memMax > 0
                    || memLeaksLog != NULL);
+
+  //
+  // Sampling doesn't turn on full tracking, but if that is on anyway
+  // the heap profiles are built from the exact tracking data.
+  //
+  chpl_memSample = (memSampleInterval > 0);
   
 
   if (!memLog) {
@@ -179,112 +261,184 @@ void chpl_setMemFlags(void) {
     }
   }
 
-  if (chpl_memTrack) {
-    hashSizeIndex = 0;
-    hashSize = hashSizes[hashSizeIndex];
-    memTable = sys_calloc(hashSize, sizeof(memTableEntry*));
+  if (chpl_memTrack || chpl_memSample) {
+    atomic_init_uint_least64_t(&totalMem, 0);
+    atomic_init_uint_least64_t(&maxMem, 0);
+    for (int i = 0; i < MEMTRACK_NUM_SHARDS; i++) {
+      memTableShard* shard = &memTable[i].s;
+      (void) pthread_mutex_init(&shard->lock, NULL);
+      shard->hashSizeIndex = 0;
+      shard->hashSize = hashSizes[shard->hashSizeIndex];
+      shard->table = sys_calloc(shard->hashSize, sizeof(memTableEntry*));
+      shard->numEntries = 0;
+      shard->allocated = 0;
+      shard->freed = 0;
+    }
+  }
+
+  if (chpl_memSample) {
+    if (!chpl_memTrack) {
+      CHPL_TLS_INIT(memSampleState);
+      sampleFilter = sys_malloc(MEMSAMPLE_FILTER_SIZE * sizeof(*sampleFilter));
+      for (int i = 0; i < MEMSAMPLE_FILTER_SIZE; i++)
+        atomic_init_uint_least32_t(&sampleFilter[i], 0);
+    }
+    if (memSampleLog == NULL || !strcmp(memSampleLog, ""))
+      memSampleLog = "memProfile";
+    memSampleNextDump = chpl_now_time() + memSamplePeriod;
   }
 }
 
 
-static unsigned hash(void* memAlloc, int hashSize) {
-  unsigned hashValue = 0;
-  char* fakeCharPtr = (char*)&memAlloc;
-  size_t i;
-  for (i = 0; i < sizeof(void*); i++) {
-    hashValue = *fakeCharPtr + 31 * hashValue;
-    fakeCharPtr++;
-  }
-  return hashValue % hashSize;
+//
+// Mix the address bits so that both the shard selection (which uses
+// the high bits) and the bucket selection (which uses the remainder
+// modulo a prime) see the variation in the low-order address bits.
+//
+static inline uint64_t hashAddr(void* memAlloc) {
+  uint64_t h = (uint64_t) (uintptr_t) memAlloc;
+  h ^= h >> 33;
+  h *= UINT64_C(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  return h;
+}
+
+
+static inline memTableShard* getShard(uint64_t h) {
+  return &memTable[h >> 58].s; // top 6 bits: MEMTRACK_NUM_SHARDS == 64
+}
+
+
+static inline unsigned hash(uint64_t h, int hashSize) {
+  return (unsigned) (h % (uint64_t) hashSize);
 }
 
 
-static void increaseMemStat(size_t chunk, int32_t lineno, int32_t filename) {
-  totalMem += chunk;
-  totalAllocated += chunk;
-  if (memMax && (totalMem > memMax)) {
+static void increaseMemStat(memTableShard* shard, size_t chunk,
+                            int32_t lineno, int32_t filename) {
+  uint_least64_t newTotal;
+  uint_least64_t oldMax;
+
+  newTotal = atomic_fetch_add_explicit_uint_least64_t(&totalMem, chunk,
+                                                      memory_order_relaxed)
+             + chunk;
+  shard->allocated += chunk;
+  if (memMax && (newTotal > memMax)) {
     chpl_error("Exceeded memory limit", lineno, filename);
   }
-  if (totalMem > maxMem)
-    maxMem = totalMem;
+  oldMax = atomic_load_explicit_uint_least64_t(&maxMem, memory_order_relaxed);
+  while (newTotal > oldMax
+         && !atomic_compare_exchange_weak_explicit_uint_least64_t(
+               &maxMem, &oldMax, newTotal,
+               memory_order_relaxed, memory_order_relaxed))
+    ;
 }
 
 
-static void decreaseMemStat(size_t chunk) {
-  totalMem -= chunk; // > totalMem ? 0 : totalMem - chunk;
-  totalFreed += chunk;
+static void decreaseMemStat(memTableShard* shard, size_t chunk) {
+  (void) atomic_fetch_sub_explicit_uint_least64_t(&totalMem, chunk,
+                                                  memory_order_relaxed);
+  shard->freed += chunk;
 }
 
 
 static void
-resizeTable(int direction) {
+resizeTable(memTableShard* shard, int direction) {
   memTableEntry** newMemTable = NULL;
   int newHashSizeIndex, newHashSize, newHashValue;
   int i;
   memTableEntry* me;
   memTableEntry* next;
 
-  newHashSizeIndex = hashSizeIndex + direction;
+  newHashSizeIndex = shard->hashSizeIndex + direction;
   newHashSize = hashSizes[newHashSizeIndex];
   newMemTable = sys_calloc(newHashSize, sizeof(memTableEntry*));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = next) {
+  for (i = 0; i < shard->hashSize; i++) {
+    for (me = shard->table[i]; me != NULL; me = next) {
       next = me->nextInBucket;
-      newHashValue = hash(me->memAlloc, newHashSize);
+      newHashValue = hash(hashAddr(me->memAlloc), newHashSize);
       me->nextInBucket = newMemTable[newHashValue];
       newMemTable[newHashValue] = me;
     }
   }
 
-  sys_free(memTable);
-  memTable = newMemTable;
-  hashSize = newHashSize;
-  hashSizeIndex = newHashSizeIndex;
+  sys_free(shard->table);
+  shard->table = newMemTable;
+  shard->hashSize = newHashSize;
+  shard->hashSizeIndex = newHashSizeIndex;
 }
 
+static inline
+atomic_uint_least32_t* getSampleFilterCount(uint64_t h) {
+  return &sampleFilter[(h >> 16) & (MEMSAMPLE_FILTER_SIZE - 1)];
+}
+
+
 static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
+                             size_t weight,
                              chpl_mem_descInt_t description, int32_t lineno,
                              int32_t filename) {
+  const uint64_t h = hashAddr(memAlloc);
+  memTableShard* shard = getShard(h);
   unsigned hashValue;
   memTableEntry* memEntry;
 
-  if ((totalEntries+1)*2 > hashSize && hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
-    resizeTable(1);
-
+  // Allocate the entry before taking the lock, to keep that short.
   memEntry = (memTableEntry*) sys_calloc(1, sizeof(memTableEntry));
   if (!memEntry) {
     chpl_error("memtrack fault: out of memory allocating memtrack table",
                lineno, filename);
   }
-
-  hashValue = hash(memAlloc, hashSize);
-  memEntry->nextInBucket = memTable[hashValue];
-  memTable[hashValue] = memEntry;
   memEntry->description = description;
   memEntry->memAlloc = memAlloc;
   memEntry->lineno = lineno;
   memEntry->filename = filename;
   memEntry->number = number;
   memEntry->size = size;
-  increaseMemStat(number*size, lineno, filename);
-  totalEntries += 1;
+  memEntry->weight = weight;
+
+  memTrack_lock(shard);
+
+  if ((shard->numEntries+1)*2 > shard->hashSize
+      && shard->hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
+    resizeTable(shard, 1);
+
+  hashValue = hash(h, shard->hashSize);
+  memEntry->nextInBucket = shard->table[hashValue];
+  shard->table[hashValue] = memEntry;
+  shard->numEntries += 1;
+  if (sampleFilter != NULL)
+    (void) atomic_fetch_add_explicit_uint_least32_t(getSampleFilterCount(h), 1,
+                                                    memory_order_relaxed);
+  increaseMemStat(shard, number*size, lineno, filename);
+
+  memTrack_unlock(shard);
 }
 
 
 static memTableEntry* removeMemTableEntry(void* address) {
-  unsigned hashValue = hash(address, hashSize);
-  memTableEntry* thisBucketEntry = memTable[hashValue];
+  const uint64_t h = hashAddr(address);
+  memTableShard* shard = getShard(h);
+  unsigned hashValue;
+  memTableEntry* thisBucketEntry;
   memTableEntry* deletedBucket = NULL;
 
-  if (!thisBucketEntry)
+  memTrack_lock(shard);
+
+  hashValue = hash(h, shard->hashSize);
+  thisBucketEntry = shard->table[hashValue];
+
+  if (!thisBucketEntry) {
+    memTrack_unlock(shard);
     return NULL;
+  }
 
   if (thisBucketEntry->memAlloc == address) {
-    memTable[hashValue] = thisBucketEntry->nextInBucket;
+    shard->table[hashValue] = thisBucketEntry->nextInBucket;
     deletedBucket = thisBucketEntry;
   } else {
-    for (thisBucketEntry = memTable[hashValue];
+    for (thisBucketEntry = shard->table[hashValue];
          thisBucketEntry != NULL;
          thisBucketEntry = thisBucketEntry->nextInBucket) {
 
@@ -297,15 +451,222 @@ static memTableEntry* removeMemTableEntry(void* address) {
     }
   }
   if (deletedBucket) {
-    decreaseMemStat(deletedBucket->number * deletedBucket->size);
-    totalEntries -= 1;
-    if (totalEntries*8 < hashSize && hashSizeIndex > 0)
-      resizeTable(-1);
+    decreaseMemStat(shard, deletedBucket->number * deletedBucket->size);
+    shard->numEntries -= 1;
+    if (sampleFilter != NULL)
+      (void) atomic_fetch_sub_explicit_uint_least32_t(getSampleFilterCount(h),
+                                                      1, memory_order_relaxed);
+    if (shard->numEntries*8 < shard->hashSize && shard->hashSizeIndex > 0)
+      resizeTable(shard, -1);
   }
+
+  memTrack_unlock(shard);
   return deletedBucket;
 }
 
 
+static size_t getTotalMem(void) {
+  return (size_t) atomic_load_uint_least64_t(&totalMem);
+}
+
+
+// Uniformly distributed in (0, 1], from a per-thread xorshift64*.
+static double sampleRand(memSampleThreadState* st) {
+  uint64_t x = st->rand;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  st->rand = x;
+  return 1.0 - ((x * UINT64_C(0x2545f4914f6cdd1d)) >> 11) * 0x1.0p-53;
+}
+
+
+static int64_t nextSampleDistance(memSampleThreadState* st) {
+  return (int64_t) (-log(sampleRand(st)) * (double) memSampleInterval) + 1;
+}
+
+
+static memSampleThreadState* getSampleState(void) {
+  memSampleThreadState* st = CHPL_TLS_GET(memSampleState);
+  if (st == NULL) {
+    st = (memSampleThreadState*) sys_calloc(1, sizeof(*st));
+    if (!st)
+      chpl_internal_error("memSample: out of memory allocating thread state");
+    st->rand = (((uint64_t) (uintptr_t) st) ^ ((uint64_t) chpl_nodeID << 40)
+                ^ UINT64_C(0x9e3779b97f4a7c15)) | 1;
+    st->bytesUntilSample = nextSampleDistance(st);
+    CHPL_TLS_SET(memSampleState, st);
+  }
+  return st;
+}
+
+
+//
+// Could this address have been sampled?  With full tracking on, the
+// tracking code handles everything and there is no filter.
+//
+static inline chpl_bool isSampledAlloc(void* memAlloc) {
+  if (sampleFilter == NULL)
+    return false;
+  return atomic_load_explicit_uint_least32_t(
+           getSampleFilterCount(hashAddr(memAlloc)), memory_order_relaxed) != 0;
+}
+
+
+typedef struct {
+  int32_t filename;
+  int32_t lineno;
+  chpl_mem_descInt_t description;
+  size_t bytes;
+} memProfileEntry;
+
+
+static int memProfileSiteCmp(const void* p1, const void* p2) {
+  const memProfileEntry* e1 = (const memProfileEntry*) p1;
+  const memProfileEntry* e2 = (const memProfileEntry*) p2;
+  if (e1->filename != e2->filename)
+    return (e1->filename < e2->filename) ? -1 : 1;
+  if (e1->lineno != e2->lineno)
+    return (e1->lineno < e2->lineno) ? -1 : 1;
+  if (e1->description != e2->description)
+    return (e1->description < e2->description) ? -1 : 1;
+  return 0;
+}
+
+
+static int memProfileBytesCmp(const void* p1, const void* p2) {
+  const memProfileEntry* e1 = (const memProfileEntry*) p1;
+  const memProfileEntry* e2 = (const memProfileEntry*) p2;
+  return (e1->bytes > e2->bytes) ? -1 : ((e1->bytes < e2->bytes) ? 1 : 0);
+}
+
+
+//
+// Write a heap profile of the (estimated) memory currently in use,
+// aggregated by allocating source line and allocation type.  The
+// caller must hold memSampleDumpLock.
+//
+static void dumpMemProfile(void) {
+  memProfileEntry* prof = NULL;
+  size_t n = 0;
+  size_t cap = 0;
+  char* profName;
+  FILE* profFile;
+
+  //
+  // Snapshot the table one shard at a time.
+  //
+  for (int s = 0; s < MEMTRACK_NUM_SHARDS; s++) {
+    memTableShard* shard = &memTable[s].s;
+    memTrack_lock(shard);
+    if (n + shard->numEntries > cap) {
+      cap = 2 * (n + shard->numEntries);
+      prof = (memProfileEntry*) sys_realloc(prof, cap * sizeof(*prof));
+      if (!prof)
+        chpl_internal_error("memSample: out of memory writing heap profile");
+    }
+    for (int i = 0; i < shard->hashSize; i++) {
+      for (memTableEntry* me = shard->table[i];
+           me != NULL;
+           me = me->nextInBucket) {
+        prof[n].filename = me->filename;
+        prof[n].lineno = me->lineno;
+        prof[n].description = me->description;
+        prof[n].bytes = me->weight;
+        n++;
+      }
+    }
+    memTrack_unlock(shard);
+  }
+
+  //
+  // Combine the entries for each allocation site, then put the
+  // biggest ones first.
+  //
+  if (n > 0) {
+    size_t m = 0;
+    qsort(prof, n, sizeof(*prof), memProfileSiteCmp);
+    for (size_t i = 1; i < n; i++) {
+      if (memProfileSiteCmp(&prof[m], &prof[i]) == 0)
+        prof[m].bytes += prof[i].bytes;
+      else
+        prof[++m] = prof[i];
+    }
+    n = m + 1;
+    qsort(prof, n, sizeof(*prof), memProfileBytesCmp);
+  }
+
+  profName = (char*) sys_malloc(strlen(memSampleLog) + 2 * 12 + 1);
+  if (chpl_numNodes == 1)
+    sprintf(profName, "%s.%d", memSampleLog, memSampleDumpNum);
+  else
+    sprintf(profName, "%s.%" PRI_c_nodeid_t ".%d",
+            memSampleLog, chpl_nodeID, memSampleDumpNum);
+  memSampleDumpNum++;
+
+  if ((profFile = fopen(profName, "w")) == NULL) {
+    char msg[100 + 256];
+    snprintf(msg, sizeof(msg), "cannot open heap profile file \"%.256s\"",
+             profName);
+    chpl_warning(msg, 0, 0);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      if (prof[i].bytes == 0)
+        continue;
+      if (prof[i].filename)
+        fprintf(profFile, "%s:%" PRId32 ";%s %zu\n",
+                chpl_lookupFilename(prof[i].filename), prof[i].lineno,
+                chpl_mem_descString(prof[i].description), prof[i].bytes);
+      else
+        fprintf(profFile, "--;%s %zu\n",
+                chpl_mem_descString(prof[i].description), prof[i].bytes);
+    }
+    fclose(profFile);
+  }
+
+  sys_free(profName);
+  sys_free(prof);
+}
+
+
+static void maybeDumpMemProfile(void) {
+  if (memSamplePeriod <= 0.0)
+    return;
+
+  // If another thread is already writing a profile, let it.
+  if (pthread_mutex_trylock(&memSampleDumpLock) != 0)
+    return;
+
+  const _real64 now = chpl_now_time();
+  if (now >= memSampleNextDump) {
+    dumpMemProfile();
+    memSampleNextDump = now + memSamplePeriod;
+  }
+
+  (void) pthread_mutex_unlock(&memSampleDumpLock);
+}
+
+
+static void sampleMalloc(void* memAlloc, size_t number, size_t size,
+                         chpl_mem_descInt_t description,
+                         int32_t lineno, int32_t filename) {
+  memSampleThreadState* st = getSampleState();
+  const size_t chunk = number * size;
+  double weight;
+
+  st->bytesUntilSample -= (int64_t) chunk;
+  if (st->bytesUntilSample > 0)
+    return;
+
+  st->bytesUntilSample = nextSampleDistance(st);
+  weight = (double) chunk
+           / (1.0 - exp(-(double) chunk / (double) memSampleInterval));
+  addMemTableEntry(memAlloc, number, size, (size_t) weight,
+                   description, lineno, filename);
+  maybeDumpMemProfile();
+}
+
+
 uint64_t chpl_memoryUsed(int32_t lineno, int32_t filename) {
   if (!chpl_memTrack) {
     chpl_warning("invalid call to memoryUsed(); rerun with --memTrack",
@@ -313,7 +674,7 @@ uint64_t chpl_memoryUsed(int32_t lineno, int32_t filename) {
     return 0;
   }
 
-  return (uint64_t)totalMem;
+  return (uint64_t)getTotalMem();
 }
 
 
@@ -344,18 +705,33 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
              nodeWidth, chpl_nodeID);
   }
 
+  //
+  // Take a snapshot of the values, merging the per-shard sums.
+  //
+  size_t totalAllocated = 0;
+  size_t totalFreed = 0;
+
+  for (int i = 0; i < MEMTRACK_NUM_SHARDS; i++) {
+    memTableShard* shard = &memTable[i].s;
+    memTrack_lock(shard);
+    totalAllocated += shard->allocated;
+    totalFreed += shard->freed;
+    memTrack_unlock(shard);
+  }
+
   //
   // Take a pre-run through the descriptions and values to figure
   // out how long each line will need to be.
   //
-  static const struct {
+  const struct {
     const char* desc;
-    size_t* val;
+    size_t val;
   } descsVals[] = {
-    { "Allocated Now:", &totalMem },
-    { "Allocation High Water Mark:", &maxMem },
-    { "Sum of Allocations:", &totalAllocated },
-    { "Sum of Frees:", &totalFreed },
+    { "Allocated Now:", getTotalMem() },
+    { "Allocation High Water Mark:",
+      (size_t) atomic_load_uint_least64_t(&maxMem) },
+    { "Sum of Allocations:", totalAllocated },
+    { "Sum of Frees:", totalFreed },
   };
   const int nDescsVals = sizeof(descsVals) / sizeof(descsVals[0]);
 
@@ -367,9 +743,9 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
     if (thisDescWidth > descWidth)
       descWidth = thisDescWidth;
     const int thisMemWidth =
-                (*descsVals[i].val == 0)
+                (descsVals[i].val == 0)
                 ? 1
-                : (int) lrint(ceil(log10((double) *descsVals[i].val)));
+                : (int) lrint(ceil(log10((double) descsVals[i].val)));
     if (thisMemWidth > memWidth)
       memWidth = thisMemWidth;
   }
@@ -381,19 +757,15 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
   char buf[4 * (strlen(prefixBuf) + 1 + descWidth + 1 + memWidth + 1) + 1];
   size_t len;
 
-  memTrack_lock();
-
   len = 0;
   for (int i = 0; i < nDescsVals; i++) {
     len += snprintf(buf + len, sizeof(buf) - len,
                     "%s %-*s %*zd\n",
                     prefixBuf,
                     descWidth, descsVals[i].desc,
-                    memWidth, *descsVals[i].val);
+                    memWidth, descsVals[i].val);
   }
 
-  memTrack_unlock();
-
   fputs(buf, memLogFile);
 }
 
@@ -421,12 +793,17 @@ static void printMemAllocsByType(_Bool forLeaks,
 
   table = (size_t*)sys_calloc(numEntries, 3*sizeof(size_t));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = me->nextInBucket) {
-      table[3*me->description] += me->number*me->size;
-      table[3*me->description+1] += 1;
-      table[3*me->description+2] = me->description;
+  for (int s = 0; s < MEMTRACK_NUM_SHARDS; s++) {
+    memTableShard* shard = &memTable[s].s;
+    memTrack_lock(shard);
+    for (i = 0; i < shard->hashSize; i++) {
+      for (me = shard->table[i]; me != NULL; me = me->nextInBucket) {
+        table[3*me->description] += me->number*me->size;
+        table[3*me->description+1] += 1;
+        table[3*me->description+2] = me->description;
+      }
     }
+    memTrack_unlock(shard);
   }
 
   qsort(table, numEntries, 3*sizeof(size_t), memTableEntryCmp);
@@ -539,19 +916,22 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
 
   n = 0;
   filenameWidth = strlen("Allocated Memory (Bytes)");
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      n += 1;
-      if (memEntry->filename) {
-        memEntryFilename = chpl_lookupFilename(memEntry->filename);
-        filenameLength = strlen(memEntryFilename);
-        if (filenameLength > filenameWidth)
-          filenameWidth = filenameLength;
+  for (int s = 0; s < MEMTRACK_NUM_SHARDS; s++) {
+    memTableShard* shard = &memTable[s].s;
+    for (i = 0; i < shard->hashSize; i++) {
+      for (memEntry = shard->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        n += 1;
+        if (memEntry->filename) {
+          memEntryFilename = chpl_lookupFilename(memEntry->filename);
+          filenameLength = strlen(memEntryFilename);
+          if (filenameLength > filenameWidth)
+            filenameWidth = filenameLength;
+        }
       }
     }
   }
@@ -584,14 +964,17 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     chpl_error("out of memory printing memory table", lineno, filename);
 
   n = 0;
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      table[n++] = memEntry;
+  for (int s = 0; s < MEMTRACK_NUM_SHARDS; s++) {
+    memTableShard* shard = &memTable[s].s;
+    for (i = 0; i < shard->hashSize; i++) {
+      for (memEntry = shard->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        table[n++] = memEntry;
+      }
     }
   }
   qsort(table, n, sizeof(memTableEntry*), descCmp);
@@ -630,23 +1013,28 @@ void chpl_reportMemInfo() {
     chpl_printMemAllocStats(0, 0);
   }
   if (memLeaksByType) {
-    if (totalMem) {
+    if (getTotalMem()) {
       fprintf(memLogFile, "\n");
       printMemAllocsByType(true /* forLeaks */, 0, 0);
     }
   }
   if (memLeaksByDesc && strcmp(memLeaksByDesc, "")) {
-    if (totalMem) {
+    if (getTotalMem()) {
       fprintf(memLogFile, "\n");
       chpl_printMemAllocsByDesc(memLeaksByDesc, memThreshold, 0, 0);
     }
   }
   if (memLeaks) {
-    if (totalMem) {
+    if (getTotalMem()) {
       fprintf(memLogFile, "\n");
       printMemAllocs(-1, memThreshold, 0, 0);
     }
   }
+  if (chpl_memSample) {
+    (void) pthread_mutex_lock(&memSampleDumpLock);
+    dumpMemProfile();
+    (void) pthread_mutex_unlock(&memSampleDumpLock);
+  }
   if (memLogFile && memLogFile != stdout)
     fclose(memLogFile);
   if (memLeaksLog && strcmp(memLeaksLog, "")) {
@@ -666,9 +1054,8 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
                        int32_t lineno, int32_t filename) {
   if (number * size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(memAlloc, number, size, description, lineno, filename);
-      memTrack_unlock();
+      addMemTableEntry(memAlloc, number, size, number * size,
+                       description, lineno, filename);
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -678,13 +1065,14 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
               memAlloc);
     }
   }
+  if (chpl_memSample && !chpl_memTrack && chpl_mem_descTrack(description))
+    sampleMalloc(memAlloc, number, size, description, lineno, filename);
 }
 
 
 void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
-  if (chpl_memTrack) {
-    memTrack_lock();
+  if (chpl_memTrack || isSampledAlloc(memAlloc)) {
     memEntry = removeMemTableEntry(memAlloc);
     if (memEntry) {
       if (chpl_verbose_mem) {
@@ -696,7 +1084,6 @@ void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
       }
       sys_free(memEntry);
     }
-    memTrack_unlock();
   } else if (chpl_verbose_mem && !memEntry) {
     fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32 ": free at %p\n",
             chpl_nodeID, (filename ? chpl_lookupFilename(filename) : "--"),
@@ -710,14 +1097,12 @@ void chpl_track_realloc_pre(void* memAlloc, size_t size,
                          int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
 
-  if (chpl_memTrack && size > memThreshold) {
-    memTrack_lock();
+  if ((chpl_memTrack && size > memThreshold) || isSampledAlloc(memAlloc)) {
     if (memAlloc) {
       memEntry = removeMemTableEntry(memAlloc);
       if (memEntry)
         sys_free(memEntry);
     }
-    memTrack_unlock();
   }
 }
 
@@ -728,9 +1113,8 @@ void chpl_track_realloc_post(void* moreMemAlloc,
                          int32_t lineno, int32_t filename) {
   if (size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
-      memTrack_unlock();
+      addMemTableEntry(moreMemAlloc, 1, size, size,
+                       description, lineno, filename);
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -740,6 +1124,8 @@ void chpl_track_realloc_post(void* moreMemAlloc,
               moreMemAlloc);
     }
   }
+  if (chpl_memSample && !chpl_memTrack && chpl_mem_descTrack(description))
+    sampleMalloc(moreMemAlloc, 1, size, description, lineno, filename);
 }
 
 void chpl_startVerboseMem() {
@@ -211,10 +211,12 @@ typedef struct {
 } large_fork_task_t;
 
 typedef struct {
-  void*   ack;
-  int     id;       // private broadcast table entry to update
-  int     size;     // size of data
-  char    data[0];  // data
+  void*      ack;
+  int        id;       // private broadcast table entry to update
+  int        size;     // size of data
+  c_nodeid_t root;     // node the broadcast started on
+  int        fanout;   // fanout of the broadcast tree
+  char       data[0];  // data
 } priv_bcast_t;
 
 typedef struct {
@@ -254,7 +256,8 @@ typedef enum {
   SHUTDOWN,             // tell nodes to get ready for shutdown
   BCAST_SEGINFO,        // broadcast for segment info table
   DO_REPLY_PUT,         // do a PUT here from another locale
-  DO_COPY_PAYLOAD       // copy AM payload to another address
+  DO_COPY_PAYLOAD,      // copy AM payload to another address
+  ALLREDUCE             // partial result for an allreduce
 } AM_handler_function_idx_t;
 
 static void AM_fork_fast(gasnet_token_t token, void* buf, size_t nbytes) {
@@ -508,13 +511,70 @@ static void AM_signal_long(gasnet_token_t token, void *buf, size_t nbytes,
     done->flag = 1;
 }
 
+//
+// Send a private broadcast on to our children in the broadcast tree,
+// and wait until all of their subtrees have it.
+//
+static void priv_bcast_to_children(priv_bcast_t* pbp, chpl_bool do_yield) {
+  c_nodeid_t firstRank;
+  int numChildren = chpl_comm_bcast_tree_children(pbp->root, pbp->fanout,
+                                                  chpl_nodeID, &firstRank);
+  if (numChildren == 0)
+    return;
+
+  done_t done;
+  init_done_obj(&done, numChildren);
+  pbp->ack = &done;
+  for (int i = 0; i < numChildren; i++) {
+    c_nodeid_t node = chpl_comm_bcast_tree_node(pbp->root, firstRank + i);
+    GASNET_Safe(gasnet_AMRequestMedium0(node, PRIV_BCAST, pbp,
+                                        sizeof(*pbp) + pbp->size));
+  }
+  wait_done_obj(&done, do_yield);
+}
+
+static void priv_bcast_forward_wrapper(chpl_comm_on_bundle_t* f) {
+  priv_bcast_t* pbp = (priv_bcast_t*) f->payload;
+  priv_bcast_to_children(pbp, true);
+
+  // Our whole subtree has it; tell our parent.
+  GASNET_Safe(gasnet_AMRequestShort2(f->comm.caller, SIGNAL,
+                                     Arg0(f->comm.ack), Arg1(f->comm.ack)));
+}
+
 static void AM_priv_bcast(gasnet_token_t token, void* buf, size_t nbytes) {
   priv_bcast_t* pbp = buf;
   chpl_memcpy(chpl_rt_priv_bcast_tab[pbp->id], pbp->data, pbp->size);
 
-  // Signal that the handler has completed
-  GASNET_Safe(gasnet_AMReplyShort2(token, SIGNAL,
-                                   Arg0(pbp->ack), Arg1(pbp->ack)));
+  //
+  // If we're a leaf in the broadcast tree we're done.  Otherwise, we
+  // can't send requests from within a handler, so start a task to
+  // forward the data to our children.  It signals our parent once
+  // our whole subtree has the data.
+  //
+  c_nodeid_t firstRank;
+  if (chpl_comm_bcast_tree_children(pbp->root, pbp->fanout, chpl_nodeID,
+                                    &firstRank) == 0) {
+    // Signal that the handler has completed
+    GASNET_Safe(gasnet_AMReplyShort2(token, SIGNAL,
+                                     Arg0(pbp->ack), Arg1(pbp->ack)));
+    return;
+  }
+
+  size_t task_size = sizeof(chpl_comm_on_bundle_t) + nbytes;
+  chpl_comm_on_bundle_t* bptr =
+    chpl_mem_alloc(task_size, CHPL_RT_MD_COMM_PRV_BCAST_DATA, 0, 0);
+  chpl_comm_bundleData_t comm =
+    { .caller = chpl_comm_bcast_tree_parent(pbp->root, pbp->fanout,
+                                            chpl_nodeID),
+      .ack    = pbp->ack };
+  *bptr = (chpl_comm_on_bundle_t) { .kind = CHPL_ARG_BUNDLE_KIND_COMM,
+                                    .comm = comm };
+  memcpy(bptr->payload, pbp, nbytes);
+  chpl_task_startMovedTask(FID_NONE, (chpl_fn_p) priv_bcast_forward_wrapper,
+                           bptr, task_size,
+                           c_sublocid_any, chpl_nullTaskID);
+  chpl_mem_free(bptr, 0, 0);
 }
 
 static void AM_priv_bcast_large(gasnet_token_t token, void* buf, size_t nbytes) {
@@ -576,6 +636,16 @@ void AM_copy_payload(gasnet_token_t token, void* buf, size_t nbytes,
   GASNET_Safe(gasnet_AMReplyShort2(token, SIGNAL, ack0, ack1));
 }
 
+// Hand a partial allreduce result to the task waiting for it.
+static
+void AM_allreduce(gasnet_token_t token, void* buf, size_t nbytes,
+                  gasnet_handlerarg_t id0, gasnet_handlerarg_t id1,
+                  gasnet_handlerarg_t step)
+{
+  chpl_comm_allreduce_arrive(get_uintptr_from_args(id0, id1), step,
+                             buf, nbytes);
+}
+
 static gasnet_handlerentry_t ftable[] = {
   {FORK,          AM_fork},
   {FORK_SMALL,    AM_fork_small},
@@ -593,7 +663,8 @@ static gasnet_handlerentry_t ftable[] = {
   {SHUTDOWN,      AM_shutdown},
   {BCAST_SEGINFO, AM_bcast_seginfo},
   {DO_REPLY_PUT,  AM_reply_put},
-  {DO_COPY_PAYLOAD, AM_copy_payload}
+  {DO_COPY_PAYLOAD, AM_copy_payload},
+  {ALLREDUCE,     AM_allreduce}
 };
 
 //
@@ -975,49 +1046,57 @@ void chpl_comm_broadcast_private(int id, size_t size) {
   done_t* done;
   int numOffsets=1;
 
-  // This can use the system allocator because it involves internode communication.
-  done = (done_t*) chpl_mem_allocManyZero(chpl_numNodes, sizeof(*done),
-                                          CHPL_RT_MD_COMM_FRK_DONE_FLAG,
-                                          0, 0);
   if (payloadSize <= gasnet_AMMaxMedium()) {
+    //
+    // Send the data down a broadcast tree rooted here.  Each node
+    // forwards it to its own children before acknowledging, so when
+    // this returns everyone has it.
+    //
     priv_bcast_t* pbp = chpl_mem_allocMany(1, payloadSize, CHPL_RT_MD_COMM_PRV_BCAST_DATA, 0, 0);
     chpl_memcpy(pbp->data, chpl_rt_priv_bcast_tab[id], size);
     pbp->id = id;
     pbp->size = size;
-    for (node = 0; node < chpl_numNodes; node++) {
-      if (node != chpl_nodeID) {
-        pbp->ack = &done[node];
-        init_done_obj(&done[node], 1);
-        GASNET_Safe(gasnet_AMRequestMedium0(node, PRIV_BCAST, pbp, payloadSize));
-      }
-    }
+    pbp->root = chpl_nodeID;
+    pbp->fanout = chpl_comm_bcast_fanout();
+    priv_bcast_to_children(pbp, false);
     chpl_mem_free(pbp, 0, 0);
-  } else {
-    size_t maxpayloadsize = gasnet_AMMaxMedium();
-    size_t maxsize = maxpayloadsize - sizeof(priv_bcast_large_t);
-    priv_bcast_large_t* pblp = chpl_mem_allocMany(1, maxpayloadsize, CHPL_RT_MD_COMM_PRV_BCAST_DATA, 0, 0);
-    pblp->id = id;
-    numOffsets = (size+maxsize)/maxsize;
+    return;
+  }
+
+  //
+  // Data too big for a single AM goes out in pieces, directly from
+  // here to each node.  This is rare enough that we don't bother to
+  // reassemble it and forward it down a tree.
+  //
+  // This can use the system allocator because it involves internode communication.
+  done = (done_t*) chpl_mem_allocManyZero(chpl_numNodes, sizeof(*done),
+                                          CHPL_RT_MD_COMM_FRK_DONE_FLAG,
+                                          0, 0);
+  size_t maxpayloadsize = gasnet_AMMaxMedium();
+  size_t maxsize = maxpayloadsize - sizeof(priv_bcast_large_t);
+  priv_bcast_large_t* pblp = chpl_mem_allocMany(1, maxpayloadsize, CHPL_RT_MD_COMM_PRV_BCAST_DATA, 0, 0);
+  pblp->id = id;
+  numOffsets = (size+maxsize)/maxsize;
+  for (node = 0; node < chpl_numNodes; node++) {
+    if (node != chpl_nodeID)
+      init_done_obj(&done[node], numOffsets);
+  }
+  for (offset = 0; offset < size; offset += maxsize) {
+    size_t thissize = size - offset;
+    if (thissize > maxsize)
+      thissize = maxsize;
+    pblp->offset = offset;
+    pblp->size = thissize;
+    chpl_memcpy(pblp->data, (char*)chpl_rt_priv_bcast_tab[id]+offset, thissize);
     for (node = 0; node < chpl_numNodes; node++) {
-      if (node != chpl_nodeID)
-        init_done_obj(&done[node], numOffsets);
-    }
-    for (offset = 0; offset < size; offset += maxsize) {
-      size_t thissize = size - offset;
-      if (thissize > maxsize)
-        thissize = maxsize;
-      pblp->offset = offset;
-      pblp->size = thissize;
-      chpl_memcpy(pblp->data, (char*)chpl_rt_priv_bcast_tab[id]+offset, thissize);
-      for (node = 0; node < chpl_numNodes; node++) {
-        if (node != chpl_nodeID) {
-          pblp->ack = &done[node];
-          GASNET_Safe(gasnet_AMRequestMedium0(node, PRIV_BCAST_LARGE, pblp, sizeof(priv_bcast_large_t)+thissize));
-        }
+      if (node != chpl_nodeID) {
+        pblp->ack = &done[node];
+        GASNET_Safe(gasnet_AMRequestMedium0(node, PRIV_BCAST_LARGE, pblp, sizeof(priv_bcast_large_t)+thissize));
       }
     }
-    chpl_mem_free(pblp, 0, 0);
   }
+  chpl_mem_free(pblp, 0, 0);
+
   // wait for the handlers to complete
   for (node = 0; node < chpl_numNodes; node++) {
     if (node != chpl_nodeID)
@@ -1026,6 +1105,28 @@ void chpl_comm_broadcast_private(int id, size_t size) {
   chpl_mem_free(done, 0, 0);
 }
 
+static
+void allreduce_send(c_nodeid_t node, uint64_t id, int step,
+                    const void* data, size_t size)
+{
+  GASNET_Safe(gasnet_AMRequestMedium3(node, ALLREDUCE, (void*) data, size,
+                                      Arg0(id), Arg1(id), step));
+}
+
+static
+void allreduce_poll(void)
+{
+  am_poll_try();
+}
+
+void chpl_comm_allreduce(uint64_t id, void* buf, size_t count,
+                         chpl_comm_reduce_type_t type,
+                         chpl_comm_reduce_op_t op)
+{
+  chpl_comm_allreduce_rd(id, buf, count, type, op,
+                         allreduce_send, allreduce_poll);
+}
+
 void chpl_comm_barrier(const char *msg) {
   int id = (int) msg[0];
   int retval;
@@ -1096,6 +1197,7 @@ void  chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
 
     chpl_comm_diags_verbose_rdma("put", node, size, ln, fn, commID);
     chpl_comm_diags_incr(put);
+    const uint64_t t0 = chpl_comm_diags_profile_start();
 
     // Handle remote address not in remote segment.
 #ifdef GASNET_SEGMENT_EVERYTHING
@@ -1148,6 +1250,8 @@ void  chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
         wait_done_obj(&done, false);
       }
     }
+
+    chpl_comm_diags_profile_time("put", node, ln, fn, t0);
   }
 }
 
@@ -1171,6 +1275,7 @@ void  chpl_comm_get(void* addr, c_nodeid_t node, void* raddr,
 
     chpl_comm_diags_verbose_rdma("get", node, size, ln, fn, commID);
     chpl_comm_diags_incr(get);
+    const uint64_t t0 = chpl_comm_diags_profile_start();
 
     // Handle remote address not in remote segment.
 
@@ -1267,6 +1372,8 @@ void  chpl_comm_get(void* addr, c_nodeid_t node, void* raddr,
         chpl_mem_free(local_buf, 0, 0);
       }
     }
+
+    chpl_comm_diags_profile_time("get", node, ln, fn, t0);
   }
 }
 
@@ -1547,9 +1654,12 @@ void  chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
 
     chpl_comm_diags_verbose_executeOn("", node, ln, fn);
     chpl_comm_diags_incr(execute_on);
+    const uint64_t t0 = chpl_comm_diags_profile_start();
 
     execute_on_common(node, subloc, fid, arg, arg_size,
                      /*fast*/ false, /*blocking*/ true);
+
+    chpl_comm_diags_profile_time("executeOn", node, ln, fn, t0);
   }
 }
 
@@ -1596,9 +1706,12 @@ void  chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
 
     chpl_comm_diags_verbose_executeOn("fast", node, ln, fn);
     chpl_comm_diags_incr(execute_on_fast);
+    const uint64_t t0 = chpl_comm_diags_profile_start();
 
     execute_on_common(node, subloc, fid, arg, arg_size,
                       /*fast*/ true, /*blocking*/ true);
+
+    chpl_comm_diags_profile_time("fast executeOn", node, ln, fn, t0);
   }
 }
 
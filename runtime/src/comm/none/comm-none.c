@@ -152,6 +152,10 @@ wide_ptr_t* chpl_comm_broadcast_global_vars_helper(void) { return NULL; }
 
 void chpl_comm_broadcast_private(int id, size_t size) { }
 
+void chpl_comm_allreduce(uint64_t id, void* buf, size_t count,
+                         chpl_comm_reduce_type_t type,
+                         chpl_comm_reduce_op_t op) { }
+
 void chpl_comm_barrier(const char *msg) { }
 
 void chpl_comm_pre_task_exit(int all) { }
@@ -92,17 +92,13 @@ static struct fid_fabric* ofi_fabric;   // fabric domain
 static struct fid_domain* ofi_domain;   // fabric access domain
 static int useScalableTxEp;             // use a scalable tx endpoint?
 static struct fid_ep* ofi_txEpScal;     // scalable transmit endpoint
-static struct fid_poll* ofi_amhPollSet; // poll set for AM handler
-static int pollSetSize = 0;             // number of fids in the poll set
-static struct fid_wait* ofi_amhWaitSet; // wait set for AM handler
 
 //
 // We direct RMA traffic and AM traffic to different endpoints so we can
 // spread the progress load across all the threads when we're doing
-// manual progress.
+// manual progress.  Each AM handler has its own AM request endpoint;
+// see struct perAmHandlerInfo_t, below.
 //
-static struct fid_ep* ofi_rxEp;         // AM req receive endpoint
-static struct fid_cq* ofi_rxCQ;         // AM req receive endpoint CQ
 static struct fid_ep* ofi_rxEpRma;      // RMA/AMO target endpoint
 static struct fid_cq* ofi_rxCQRma;      // RMA/AMO target endpoint CQ
 static struct fid_cntr* ofi_rxCntrRma;  // RMA/AMO target endpoint counter
@@ -112,8 +108,26 @@ static void (*checkRxRmaCmplsFn)(void); // fn: check for RMA/AMO EP completions
 static struct fid_av* ofi_av;           // address vector
 static fi_addr_t* ofi_rxAddrs;          // table of remote endpoint addresses
 
-#define rxMsgAddr(tcip, n) (ofi_rxAddrs[2 * (n)])
-#define rxRmaAddr(tcip, n) (ofi_rxAddrs[2 * (n) + 1])
+//
+// Each node has an AM request endpoint per AM handler followed by its
+// RMA/AMO endpoint, so there are numAmHandlers + 1 addresses per node.
+// A given tx context always sends its AM requests for a given node to
+// the same AM handler there.  We depend on that: nonblocking AMs sent
+// on a bound tx context are forced to completion by a later blocking
+// one on the same context, which only works if the same handler, in
+// order, processes both.  Including our own node ID spreads different
+// initiators' requests over the handlers even if each of them only
+// uses its first few tx contexts.
+//
+static int numAmHandlers;
+
+#define rxAddrsPerNode (numAmHandlers + 1)
+#define rxMsgAmh(tcip, n)                                               \
+  ((int) (((tcip) - tciTab + chpl_nodeID) % numAmHandlers))
+#define rxMsgAddr(tcip, n)                                              \
+  (ofi_rxAddrs[rxAddrsPerNode * (n) + rxMsgAmh(tcip, n)])
+#define rxRmaAddr(tcip, n)                                              \
+  (ofi_rxAddrs[rxAddrsPerNode * (n) + numAmHandlers])
 
 //
 // Transmit support.
@@ -181,15 +195,30 @@ struct amRequest_execOnLrg_t {
   void* pPayload;                 // addr of arg payload on initiator node
 };
 
-static int numAmHandlers = 1;
-
 //
-// AM request landing zones.
+// AM handler support.  Each AM handler thread has its own AM request
+// endpoint, CQ, and landing zones, and its own poll and wait sets if
+// we use those.  The first handler is also responsible for progress
+// on the RMA/AMO target endpoint.
 //
-static void* amLZs[2];
-static struct iovec ofi_iov_reqs[2];
-static struct fi_msg ofi_msg_reqs[2];
-static int ofi_msg_i;
+struct perAmHandlerInfo_t {
+  struct fid_ep* rxEp;            // AM req receive endpoint
+  struct fid_cq* rxCQ;            // AM req receive endpoint CQ
+  struct fid_poll* pollSet;       // poll set, or NULL if we don't use them
+  struct fid_wait* waitSet;       // wait set, or NULL if we don't use them
+  int pollSetSize;                // number of fids in the poll set
+  struct perTxCtxInfo_t* tcip;    // this handler's tx context
+
+  //
+  // AM request landing zones.
+  //
+  void* amLZs[2];
+  struct iovec iov_reqs[2];
+  struct fi_msg msg_reqs[2];
+  int msg_i;
+};
+
+static struct perAmHandlerInfo_t* amhTab;
 
 
 ////////////////////////////////////////
@@ -293,9 +322,10 @@ static void ofiErrReport(const char*, int, const char*);
 //
 
 //
-// Is this the (an) AM handler thread?
+// Is this the (an) AM handler thread?  If so, which one?
 //
 static __thread chpl_bool isAmHandler = false;
+static __thread struct perAmHandlerInfo_t* amhInfo = NULL;
 
 
 //
@@ -665,18 +695,37 @@ chpl_comm_taskPrvData_t* get_comm_taskPrvdata(void) {
 // task local buffering
 //
 
-// Largest size to use unordered transactions for
+//
+// Unordered PUTs, GETs, and non-fetching AMOs are buffered per task and
+// then initiated together as chained transactions.  The largest size
+// we buffer and the bounds on the chain length are set at startup, in
+// init_ofiTaskLocalBuffering().  Within those bounds each task's chain
+// length adapts to what it is doing: it doubles after several flushes
+// in a row caused by the buffer filling up, and halves after several
+// fence flushes in a row that found the buffer mostly empty.  The
+// vectors a buffer needs are allocated only when the task first uses
+// it, and are dropped again when the chain length changes, when the
+// task stops using the buffer, and when the task ends.
+//
+
+// Default largest size to use unordered transactions for
 #define MAX_UNORDERED_TRANS_SZ 1024
 
 //
-// Maximum number of PUTs/AMOs in a chained transaction list.  This
-// is a provisional value, not yet tuned.
+// Defaults and limits for the number of PUTs/GETs/AMOs in a chained
+// transaction list.  The default maximum is a provisional value, not
+// yet tuned.
 //
 #define MAX_TXNS_IN_FLIGHT 64
+#define MIN_TXNS_IN_FLIGHT 8
+#define MAX_TXNS_IN_FLIGHT_LIMIT 1024
+
+// Number of like flushes in a row that it takes to change chain length
+#define CHAIN_ADAPT_STREAK 2
 
-#define MAX_CHAINED_AMO_NF_LEN MAX_TXNS_IN_FLIGHT
-#define MAX_CHAINED_PUT_LEN MAX_TXNS_IN_FLIGHT
-#define MAX_CHAINED_GET_LEN MAX_TXNS_IN_FLIGHT
+static size_t maxUnorderedTransSz = MAX_UNORDERED_TRANS_SZ;
+static int maxTxnsInFlight = MAX_TXNS_IN_FLIGHT;
+static int minTxnsInFlight = MIN_TXNS_IN_FLIGHT;
 
 enum BuffType {
   amo_nf_buff = 1 << 0,
@@ -684,78 +733,214 @@ enum BuffType {
   put_buff    = 1 << 2
 };
 
+// Chaining state common to all kinds of task local buffers
+typedef struct {
+  int           vi;             // number of buffered transactions
+  int           len;            // current chain length
+  int           fullStreak;     // flushes in a row due to a full buffer
+  int           idleStreak;     // fences in a row with a mostly empty buffer
+  void*         vecs;           // storage for the vectors, or NULL
+} chain_info_t;
+
 // Per task information about non-fetching AMO buffers
 typedef struct {
-  chpl_bool          new;
-  int                vi;
-  uint64_t           opnd1_v[MAX_CHAINED_AMO_NF_LEN];
-  c_nodeid_t         locale_v[MAX_CHAINED_AMO_NF_LEN];
-  void*              object_v[MAX_CHAINED_AMO_NF_LEN];
-  size_t             size_v[MAX_CHAINED_AMO_NF_LEN];
-  enum fi_op         cmd_v[MAX_CHAINED_AMO_NF_LEN];
-  enum fi_datatype   type_v[MAX_CHAINED_AMO_NF_LEN];
-  uint64_t           remote_mr_v[MAX_CHAINED_AMO_NF_LEN];
+  chain_info_t       c;
+  uint64_t*          opnd1_v;
+  c_nodeid_t*        locale_v;
+  void**             object_v;
+  size_t*            size_v;
+  enum fi_op*        cmd_v;
+  enum fi_datatype*  type_v;
+  uint64_t*          remote_mr_v;
   void*              local_mr;
 } amo_nf_buff_task_info_t;
 
+#define AMO_NF_BUFF_VECS(MACRO) \
+  MACRO(opnd1_v) \
+  MACRO(locale_v) \
+  MACRO(object_v) \
+  MACRO(size_v) \
+  MACRO(cmd_v) \
+  MACRO(type_v) \
+  MACRO(remote_mr_v)
+
 // Per task information about GET buffers
 typedef struct {
-  chpl_bool     new;
-  int           vi;
-  void*         tgt_addr_v[MAX_CHAINED_GET_LEN];
-  c_nodeid_t    locale_v[MAX_CHAINED_GET_LEN];
-  uint64_t      remote_mr_v[MAX_CHAINED_GET_LEN];
-  void*         src_addr_v[MAX_CHAINED_GET_LEN];
-  size_t        size_v[MAX_CHAINED_GET_LEN];
-  void*         local_mr_v[MAX_CHAINED_GET_LEN];
+  chain_info_t  c;
+  void**        tgt_addr_v;
+  c_nodeid_t*   locale_v;
+  uint64_t*     remote_mr_v;
+  void**        src_addr_v;
+  size_t*       size_v;
+  void**        local_mr_v;
 } get_buff_task_info_t;
 
+#define GET_BUFF_VECS(MACRO) \
+  MACRO(tgt_addr_v) \
+  MACRO(locale_v) \
+  MACRO(remote_mr_v) \
+  MACRO(src_addr_v) \
+  MACRO(size_v) \
+  MACRO(local_mr_v)
+
 // Per task information about PUT buffers
 typedef struct {
-  chpl_bool     new;
-  int           vi;
-  void*         tgt_addr_v[MAX_CHAINED_PUT_LEN];
-  c_nodeid_t    locale_v[MAX_CHAINED_PUT_LEN];
-  void*         src_addr_v[MAX_CHAINED_PUT_LEN];
-  char          src_v[MAX_CHAINED_PUT_LEN][MAX_UNORDERED_TRANS_SZ];
-  size_t        size_v[MAX_CHAINED_PUT_LEN];
-  uint64_t      remote_mr_v[MAX_CHAINED_PUT_LEN];
-  void*         local_mr_v[MAX_CHAINED_PUT_LEN];
+  chain_info_t  c;
+  void**        tgt_addr_v;
+  c_nodeid_t*   locale_v;
+  void**        src_addr_v;
+  size_t*       size_v;
+  uint64_t*     remote_mr_v;
+  void**        local_mr_v;
+  char*         src_v;          // maxUnorderedTransSz bytes per entry
   struct bitmap_t nodeBitmap;
 } put_buff_task_info_t;
 
+#define PUT_BUFF_VECS(MACRO) \
+  MACRO(tgt_addr_v) \
+  MACRO(locale_v) \
+  MACRO(src_addr_v) \
+  MACRO(size_v) \
+  MACRO(remote_mr_v) \
+  MACRO(local_mr_v)
+
+static inline
+size_t chain_vec_size(size_t elemSize, int len) {
+  return ALIGN_UP(elemSize * len, sizeof(uint64_t));
+}
+
+static inline int mrGetDesc(void**, void*, size_t);
+
+#define CHAIN_VEC_SIZE(v) \
+  vecsSize += chain_vec_size(sizeof(*info->v), info->c.len);
+#define CHAIN_VEC_CARVE(v) \
+  info->v = (void*) p; p += chain_vec_size(sizeof(*info->v), info->c.len);
+
+static
+void amo_nf_buff_vecs_alloc(amo_nf_buff_task_info_t* info) {
+  size_t vecsSize = 0;
+  AMO_NF_BUFF_VECS(CHAIN_VEC_SIZE);
+  char* p = info->c.vecs = chpl_mem_alloc(vecsSize,
+                                          CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  AMO_NF_BUFF_VECS(CHAIN_VEC_CARVE);
+
+  //
+  // The AMO operands themselves are stored in a vector in the info,
+  // so we only need one local memory descriptor for that vector.
+  //
+  CHK_TRUE(mrGetDesc(&info->local_mr, info->opnd1_v,
+                     info->c.len * sizeof(info->opnd1_v[0])) == 0);
+}
+
+static
+void get_buff_vecs_alloc(get_buff_task_info_t* info) {
+  size_t vecsSize = 0;
+  GET_BUFF_VECS(CHAIN_VEC_SIZE);
+  char* p = info->c.vecs = chpl_mem_alloc(vecsSize,
+                                          CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  GET_BUFF_VECS(CHAIN_VEC_CARVE);
+}
+
+static
+void put_buff_vecs_alloc(put_buff_task_info_t* info) {
+  size_t vecsSize = 0;
+  PUT_BUFF_VECS(CHAIN_VEC_SIZE);
+  vecsSize += chain_vec_size(maxUnorderedTransSz, info->c.len);
+  char* p = info->c.vecs = chpl_mem_alloc(vecsSize,
+                                          CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  PUT_BUFF_VECS(CHAIN_VEC_CARVE);
+  info->src_v = p;
+  info->nodeBitmap.len = chpl_numNodes;
+}
+
+#undef CHAIN_VEC_SIZE
+#undef CHAIN_VEC_CARVE
+
+static inline
+void chain_info_drop_vecs(chain_info_t* c) {
+  if (c->vecs != NULL) {
+    chpl_mem_free(c->vecs, 0, 0);
+    c->vecs = NULL;
+  }
+}
+
+//
+// Account for a flush of a task local buffer and adapt its chain
+// length.  A flush is either because the buffer filled up or because
+// of a fence (including the implicit one at task end).  When the
+// length changes the vectors are dropped, to be reallocated at the
+// new length on next use.  We can do that here because the buffer is
+// empty right after a flush.
+//
+static inline
+void chain_info_flushed(chain_info_t* c, chpl_bool full) {
+  if (full) {
+    chpl_comm_diags_incr(unordered_flush_full);
+    c->idleStreak = 0;
+    if (++c->fullStreak >= CHAIN_ADAPT_STREAK && c->len < maxTxnsInFlight) {
+      c->len = (c->len <= maxTxnsInFlight / 2) ? 2 * c->len : maxTxnsInFlight;
+      c->fullStreak = 0;
+      chain_info_drop_vecs(c);
+    }
+  } else {
+    if (c->vi > 0) {
+      chpl_comm_diags_incr(unordered_flush_fence);
+    }
+    c->fullStreak = 0;
+    if (c->vi > c->len / 4) {
+      c->idleStreak = 0;
+    } else if (++c->idleStreak >= CHAIN_ADAPT_STREAK) {
+      c->idleStreak = 0;
+      if (c->len > minTxnsInFlight) {
+        c->len = (c->len / 2 >= minTxnsInFlight) ? c->len / 2 : minTxnsInFlight;
+        chain_info_drop_vecs(c);
+      } else if (c->vi == 0) {
+        chain_info_drop_vecs(c);
+      }
+    }
+  }
+  c->vi = 0;
+}
+
 // Acquire a task local buffer, initializing if needed
 static inline
 void* task_local_buff_acquire(enum BuffType t, size_t extra_size) {
   chpl_comm_taskPrvData_t* prvData = get_comm_taskPrvdata();
   if (prvData == NULL) return NULL;
 
-#define DEFINE_INIT(TYPE, TLS_NAME)                                           \
+#define DEFINE_INIT(TYPE, TLS_NAME, VECS_ALLOC_NAME)                          \
   if (t == TLS_NAME) {                                                        \
     TYPE* info = prvData->TLS_NAME;                                           \
     if (info == NULL) {                                                       \
       prvData->TLS_NAME = chpl_mem_alloc(sizeof(TYPE) + extra_size,           \
                                          CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0); \
       info = prvData->TLS_NAME;                                               \
-      info->new = true;                                                       \
-      info->vi = 0;                                                           \
+      info->c = (chain_info_t) { .vi = 0, .len = minTxnsInFlight,             \
+                                 .fullStreak = 0, .idleStreak = 0,            \
+                                 .vecs = NULL };                              \
+    }                                                                         \
+    if (info->c.vecs == NULL) {                                               \
+      VECS_ALLOC_NAME(info);                                                  \
     }                                                                         \
     return info;                                                              \
   }
 
-  DEFINE_INIT(amo_nf_buff_task_info_t, amo_nf_buff);
-  DEFINE_INIT(get_buff_task_info_t, get_buff);
-  DEFINE_INIT(put_buff_task_info_t, put_buff);
+  DEFINE_INIT(amo_nf_buff_task_info_t, amo_nf_buff, amo_nf_buff_vecs_alloc);
+  DEFINE_INIT(get_buff_task_info_t, get_buff, get_buff_vecs_alloc);
+  DEFINE_INIT(put_buff_task_info_t, put_buff, put_buff_vecs_alloc);
 
 #undef DEFINE_INIT
   return NULL;
 }
 
-static void amo_nf_buff_task_info_flush(amo_nf_buff_task_info_t* info);
-static void get_buff_task_info_flush(get_buff_task_info_t* info);
-static void put_buff_task_info_flush(put_buff_task_info_t* info);
+static void amo_nf_buff_task_info_flush(amo_nf_buff_task_info_t* info,
+                                        chpl_bool full);
+static void get_buff_task_info_flush(get_buff_task_info_t* info,
+                                     chpl_bool full);
+static void put_buff_task_info_flush(put_buff_task_info_t* info,
+                                     chpl_bool full);
 
-// Flush one or more task local buffers
+// Flush one or more task local buffers, at a fence
 static inline
 void task_local_buff_flush(enum BuffType t) {
   chpl_comm_taskPrvData_t* prvData = get_comm_taskPrvdata();
@@ -764,8 +949,8 @@ void task_local_buff_flush(enum BuffType t) {
 #define DEFINE_FLUSH(TYPE, TLS_NAME, FLUSH_NAME)                              \
   if (t & TLS_NAME) {                                                         \
     TYPE* info = prvData->TLS_NAME;                                           \
-    if (info != NULL && info->vi > 0) {                                       \
-      FLUSH_NAME(info);                                                       \
+    if (info != NULL) {                                                       \
+      FLUSH_NAME(info, false /*full*/);                                       \
     }                                                                         \
   }
 
@@ -786,8 +971,11 @@ void task_local_buff_end(enum BuffType t) {
 #define DEFINE_END(TYPE, TLS_NAME, FLUSH_NAME)                                \
   if (t & TLS_NAME) {                                                         \
     TYPE* info = prvData->TLS_NAME;                                           \
-    if (info != NULL && info->vi > 0) {                                       \
-      FLUSH_NAME(info);                                                       \
+    if (info != NULL) {                                                       \
+      if (info->c.vi > 0) {                                                   \
+        FLUSH_NAME(info, false /*full*/);                                     \
+      }                                                                       \
+      chain_info_drop_vecs(&info->c);                                         \
       chpl_mem_free(info, 0, 0);                                              \
       prvData->TLS_NAME = NULL;                                               \
     }                                                                         \
@@ -798,7 +986,7 @@ void task_local_buff_end(enum BuffType t) {
   DEFINE_END(get_buff_task_info_t, get_buff, get_buff_task_info_flush);
   DEFINE_END(put_buff_task_info_t, put_buff, put_buff_task_info_flush);
 
-#undef END
+#undef DEFINE_END
 }
 
 
@@ -812,7 +1000,9 @@ pthread_t pthread_that_inited;
 static void init_ofi(void);
 static void init_ofiFabricDomain(void);
 static void init_ofiDoProviderChecks(void);
+static void init_ofiTaskLocalBuffering(void);
 static void init_ofiEp(void);
+static void init_ofiEpNumAmHandlers(void);
 static void init_ofiEpNumCtxs(void);
 static void init_ofiEpTxCtx(int, chpl_bool,
                             struct fi_cq_attr*, struct fi_cntr_attr*);
@@ -830,7 +1020,6 @@ static void init_broadcast_private(void);
 // forward decls
 //
 static inline int mrGetLocalKey(void*, size_t);
-static inline int mrGetDesc(void**, void*, size_t);
 
 
 void chpl_comm_init(int *argc_p, char ***argv_p) {
@@ -890,6 +1079,7 @@ static
 void init_ofi(void) {
   init_ofiFabricDomain();
   init_ofiDoProviderChecks();
+  init_ofiTaskLocalBuffering();
   init_ofiEp();
   init_ofiExchangeAvInfo();
   init_ofiForMem();
@@ -904,9 +1094,11 @@ void init_ofi(void) {
                               sizeof(orderDummyMap[0]));
 
   DBG_PRINTF(DBG_CFG,
-             "AM config: recv buf size %zd MiB, %s, responses use %s",
-             ofi_iov_reqs[ofi_msg_i].iov_len / (1L << 20),
-             (ofi_amhPollSet == NULL) ? "explicit polling" : "poll+wait sets",
+             "AM config: %d handler%s, recv buf size %zd MiB, %s, "
+             "responses use %s",
+             numAmHandlers, (numAmHandlers == 1) ? "" : "s",
+             amhTab[0].iov_reqs[0].iov_len / (1L << 20),
+             (amhTab[0].pollSet == NULL) ? "explicit polling" : "poll+wait sets",
              (tciTab[tciTabLen - 1].txCQ != NULL) ? "CQ" : "counter");
   if (useScalableTxEp) {
     DBG_PRINTF(DBG_CFG,
@@ -1447,12 +1639,70 @@ void init_ofiDoProviderChecks(void) {
 }
 
 
+static
+void init_ofiTaskLocalBuffering(void) {
+  //
+  // Unordered transactions larger than this aren't buffered.  Each
+  // buffered PUT takes this much space, so we keep it modest.
+  //
+  size_t sz = chpl_env_rt_get_size("COMM_OFI_MAX_UNORDERED_SIZE",
+                                   MAX_UNORDERED_TRANS_SZ);
+  if (sz > ofi_info->ep_attr->max_msg_size) {
+    sz = ofi_info->ep_attr->max_msg_size;
+  }
+  maxUnorderedTransSz = ALIGN_UP(sz, sizeof(uint64_t));
+
+  //
+  // Bounds on the chain length.  Tasks start at the minimum and adapt
+  // from there.  Setting the two the same turns adaptation off.  The
+  // maximum also sizes the worker tx CQs, so that a full chain can
+  // always be initiated at once.
+  //
+  maxTxnsInFlight = chpl_env_rt_get_int("COMM_OFI_MAX_CHAIN_LEN",
+                                        MAX_TXNS_IN_FLIGHT);
+  if (maxTxnsInFlight < 1) {
+    chpl_warning("CHPL_RT_COMM_OFI_MAX_CHAIN_LEN < 1, using 1", 0, 0);
+    maxTxnsInFlight = 1;
+  } else if (maxTxnsInFlight > MAX_TXNS_IN_FLIGHT_LIMIT) {
+    char msg[100];
+    (void) snprintf(msg, sizeof(msg),
+                    "CHPL_RT_COMM_OFI_MAX_CHAIN_LEN > %d, using %d",
+                    MAX_TXNS_IN_FLIGHT_LIMIT, MAX_TXNS_IN_FLIGHT_LIMIT);
+    chpl_warning(msg, 0, 0);
+    maxTxnsInFlight = MAX_TXNS_IN_FLIGHT_LIMIT;
+  }
+
+  minTxnsInFlight = chpl_env_rt_get_int("COMM_OFI_MIN_CHAIN_LEN",
+                                        MIN_TXNS_IN_FLIGHT);
+  if (minTxnsInFlight < 1) {
+    chpl_warning("CHPL_RT_COMM_OFI_MIN_CHAIN_LEN < 1, using 1", 0, 0);
+    minTxnsInFlight = 1;
+  }
+  if (minTxnsInFlight > maxTxnsInFlight) {
+    minTxnsInFlight = maxTxnsInFlight;
+  }
+
+  DBG_PRINTF(DBG_CFG,
+             "unordered buffering: max size %zd, chain len %d..%d",
+             maxUnorderedTransSz, minTxnsInFlight, maxTxnsInFlight);
+}
+
+
 static
 void init_ofiEp(void) {
   //
-  // The AM handler is responsible not only for AM handling and progress
-  // on any RMA it initiates but also progress on inbound RMA, if that
-  // is needed.  It uses poll and wait sets to manage this, if it can.
+  // Figure out how many AM handlers we'll have.  Each gets its own
+  // request endpoint, so the job-wide address vector layout depends
+  // on this, and it has to be the same on every node.
+  //
+  init_ofiEpNumAmHandlers();
+  CHPL_CALLOC(amhTab, numAmHandlers);
+
+  //
+  // The AM handlers are responsible not only for AM handling and
+  // progress on any RMA they initiate but also progress on inbound
+  // RMA, if that is needed; the first handler does the latter.  Each
+  // uses its own poll and wait sets to manage this, if it can.
   // Note: we'll either have both a poll and a wait set, or neither.
   //
   // We don't use poll and waits sets with the efa provider because that
@@ -1471,19 +1721,30 @@ void init_ofiEp(void) {
     int ret;
     struct fi_poll_attr pollSetAttr = (struct fi_poll_attr)
                                       { .flags = 0, };
-    OFI_CHK_2(fi_poll_open(ofi_domain, &pollSetAttr, &ofi_amhPollSet),
+    struct fi_wait_attr waitSetAttr = (struct fi_wait_attr)
+                                      { .wait_obj = FI_WAIT_UNSPEC, };
+    OFI_CHK_2(fi_poll_open(ofi_domain, &pollSetAttr, &amhTab[0].pollSet),
               ret, -FI_ENOSYS);
     if (ret == FI_SUCCESS) {
-      struct fi_wait_attr waitSetAttr = (struct fi_wait_attr)
-                                        { .wait_obj = FI_WAIT_UNSPEC, };
-      OFI_CHK_2(fi_wait_open(ofi_fabric, &waitSetAttr, &ofi_amhWaitSet),
+      OFI_CHK_2(fi_wait_open(ofi_fabric, &waitSetAttr, &amhTab[0].waitSet),
                 ret, -FI_ENOSYS);
       if (ret != FI_SUCCESS) {
-        ofi_amhPollSet = NULL;
-        ofi_amhWaitSet = NULL;
+        OFI_CHK(fi_close(&amhTab[0].pollSet->fid));
+        amhTab[0].pollSet = NULL;
+        amhTab[0].waitSet = NULL;
       }
     } else {
-      ofi_amhPollSet = NULL;
+      amhTab[0].pollSet = NULL;
+    }
+
+    //
+    // If the first handler could have them, the rest can too.
+    //
+    if (amhTab[0].pollSet != NULL) {
+      for (int h = 1; h < numAmHandlers; h++) {
+        OFI_CHK(fi_poll_open(ofi_domain, &pollSetAttr, &amhTab[h].pollSet));
+        OFI_CHK(fi_wait_open(ofi_fabric, &waitSetAttr, &amhTab[h].waitSet));
+      }
     }
   }
 
@@ -1512,7 +1773,7 @@ void init_ofiEp(void) {
   //
   struct fi_av_attr avAttr = (struct fi_av_attr)
                              { .type = FI_AV_TABLE,
-                               .count = chpl_numNodes * 2 /* AM, RMA+AMO */,
+                               .count = chpl_numNodes * rxAddrsPerNode,
                                .name = NULL,
                                .rx_ctx_bits = 0, };
   if (provCtl_sizeAvsByNumEps) {
@@ -1547,7 +1808,7 @@ void init_ofiEp(void) {
   {
     cqAttr = (struct fi_cq_attr)
              { .format = FI_CQ_FORMAT_MSG,
-               .size = 100 + MAX_TXNS_IN_FLIGHT,
+               .size = 100 + maxTxnsInFlight,
                .wait_obj = FI_WAIT_NONE, };
     txCQLen = cqAttr.size;
     for (int i = 0; i < numWorkerTxCtxs; i++) {
@@ -1558,52 +1819,64 @@ void init_ofiEp(void) {
   //
   // TX contexts for the AM handler(s) can just use counters, if the
   // provider supports them.  Otherwise, they have to use CQs also.
+  // AM handler h uses tciTab[numWorkerTxCtxs + h], and its completions
+  // wake it through its own wait set.
   //
-  const enum fi_wait_obj waitObj = (ofi_amhWaitSet == NULL)
+  const enum fi_wait_obj waitObj = (amhTab[0].waitSet == NULL)
                                    ? FI_WAIT_NONE
                                    : FI_WAIT_SET;
-  if (true /*ofi_info->domain_attr->cntr_cnt == 0*/) { // disable tx counters
-    cqAttr = (struct fi_cq_attr)
-             { .format = FI_CQ_FORMAT_MSG,
-               .size = 100,
-               .wait_obj = waitObj,
-               .wait_cond = FI_CQ_COND_NONE,
-               .wait_set = ofi_amhWaitSet, };
-    for (int i = numWorkerTxCtxs; i < tciTabLen; i++) {
-      init_ofiEpTxCtx(i, true /*isAMHandler*/, &cqAttr, NULL);
-    }
-  } else {
-    cntrAttr = (struct fi_cntr_attr)
-               { .events = FI_CNTR_EVENTS_COMP,
+  for (int h = 0; h < numAmHandlers; h++) {
+    const int i = numWorkerTxCtxs + h;
+    if (true /*ofi_info->domain_attr->cntr_cnt == 0*/) { // disable tx counters
+      cqAttr = (struct fi_cq_attr)
+               { .format = FI_CQ_FORMAT_MSG,
+                 .size = 100,
                  .wait_obj = waitObj,
-                 .wait_set = ofi_amhWaitSet, };
-    for (int i = numWorkerTxCtxs; i < tciTabLen; i++) {
+                 .wait_cond = FI_CQ_COND_NONE,
+                 .wait_set = amhTab[h].waitSet, };
+      init_ofiEpTxCtx(i, true /*isAMHandler*/, &cqAttr, NULL);
+    } else {
+      cntrAttr = (struct fi_cntr_attr)
+                 { .events = FI_CNTR_EVENTS_COMP,
+                   .wait_obj = waitObj,
+                   .wait_set = amhTab[h].waitSet, };
       init_ofiEpTxCtx(i, true /*isAMHandler*/, NULL, &cntrAttr);
     }
+    amhTab[h].tcip = &tciTab[i];
   }
 
   //
-  // Create receive contexts.
+  // Create receive contexts, one AM request endpoint per AM handler
+  // plus the RMA/AMO target endpoint.
   //
   // For the CQ length, allow for an appreciable proportion of the job
   // to send requests to us at once.
   //
+  for (int h = 0; h < numAmHandlers; h++) {
+    struct perAmHandlerInfo_t* amh = &amhTab[h];
+    cqAttr = (struct fi_cq_attr)
+             { .size = chpl_numNodes * numWorkerTxCtxs,
+               .format = FI_CQ_FORMAT_DATA,
+               .wait_obj = waitObj,
+               .wait_cond = FI_CQ_COND_NONE,
+               .wait_set = amh->waitSet, };
+    OFI_CHK(fi_endpoint(ofi_domain, ofi_info, &amh->rxEp, NULL));
+    OFI_CHK(fi_ep_bind(amh->rxEp, &ofi_av->fid, 0));
+    OFI_CHK(fi_cq_open(ofi_domain, &cqAttr, &amh->rxCQ, &amh->rxCQ));
+    OFI_CHK(fi_ep_bind(amh->rxEp, &amh->rxCQ->fid, FI_TRANSMIT | FI_RECV));
+    OFI_CHK(fi_enable(amh->rxEp));
+  }
+
   cqAttr = (struct fi_cq_attr)
            { .size = chpl_numNodes * numWorkerTxCtxs,
              .format = FI_CQ_FORMAT_DATA,
              .wait_obj = waitObj,
              .wait_cond = FI_CQ_COND_NONE,
-             .wait_set = ofi_amhWaitSet, };
+             .wait_set = amhTab[0].waitSet, };
   cntrAttr = (struct fi_cntr_attr)
              { .events = FI_CNTR_EVENTS_COMP,
                .wait_obj = waitObj,
-               .wait_set = ofi_amhWaitSet, };
-
-  OFI_CHK(fi_endpoint(ofi_domain, ofi_info, &ofi_rxEp, NULL));
-  OFI_CHK(fi_ep_bind(ofi_rxEp, &ofi_av->fid, 0));
-  OFI_CHK(fi_cq_open(ofi_domain, &cqAttr, &ofi_rxCQ, &ofi_rxCQ));
-  OFI_CHK(fi_ep_bind(ofi_rxEp, &ofi_rxCQ->fid, FI_TRANSMIT | FI_RECV));
-  OFI_CHK(fi_enable(ofi_rxEp));
+               .wait_set = amhTab[0].waitSet, };
 
   OFI_CHK(fi_endpoint(ofi_domain, ofi_info, &ofi_rxEpRma, NULL));
   OFI_CHK(fi_ep_bind(ofi_rxEpRma, &ofi_av->fid, 0));
@@ -1623,21 +1896,67 @@ void init_ofiEp(void) {
 
   //
   // If we're using poll and wait sets, put all the progress-related
-  // CQs and/or counters in the poll set.
+  // CQs and/or counters in the poll sets: each handler's own request
+  // CQ and tx completions, and for the first one, the RMA/AMO target
+  // endpoint completions.
+  //
+  if (amhTab[0].pollSet != NULL) {
+    for (int h = 0; h < numAmHandlers; h++) {
+      struct perAmHandlerInfo_t* amh = &amhTab[h];
+      OFI_CHK(fi_poll_add(amh->pollSet, &amh->rxCQ->fid, 0));
+      OFI_CHK(fi_poll_add(amh->pollSet, amh->tcip->txCmplFid, 0));
+      amh->pollSetSize = 2;
+      if (h == 0) {
+        OFI_CHK(fi_poll_add(amh->pollSet, ofi_rxCmplFidRma, 0));
+        amh->pollSetSize++;
+      }
+    }
+  }
+}
+
+
+static
+void init_ofiEpNumAmHandlers(void) {
+  //
+  // By default we have a single AM handler.  More can help when many
+  // nodes direct a lot of AM traffic (executeOns, AMOs the network
+  // can't do, etc.) at each other at once, so that AM processing
+  // rather than the network limits throughput.  Each handler needs
+  // a tx context and a receive endpoint of its own, so there's no
+  // point in having more than the provider can give us and still
+  // leave a tx context for the workers.
+  //
+  numAmHandlers = chpl_env_rt_get_int("COMM_OFI_NUM_AM_HANDLERS", 1);
+  if (numAmHandlers < 1) {
+    chpl_warning("CHPL_RT_COMM_OFI_NUM_AM_HANDLERS < 1, using 1", 0, 0);
+    numAmHandlers = 1;
+  }
+
+  //
+  // Each handler has a receive endpoint and a tx context, which may be
+  // an endpoint too.  There's also the RMA/AMO endpoint, and at least
+  // one worker tx context.
   //
-  if (ofi_amhPollSet != NULL) {
-    OFI_CHK(fi_poll_add(ofi_amhPollSet, &ofi_rxCQ->fid, 0));
-    OFI_CHK(fi_poll_add(ofi_amhPollSet, ofi_rxCmplFidRma, 0));
-    OFI_CHK(fi_poll_add(ofi_amhPollSet, tciTab[tciTabLen - 1].txCmplFid, 0));
-    pollSetSize = 3;
+  const struct fi_domain_attr* dom_attr = ofi_info->domain_attr;
+  int maxAmHandlers = CHPL_COMM_DIAGS_MAX_AM_HANDLERS;
+  if (dom_attr->ep_cnt < 2 * (size_t) maxAmHandlers + 2) {
+    maxAmHandlers = (dom_attr->ep_cnt < 4) ? 1 : (dom_attr->ep_cnt - 2) / 2;
+  }
+  if (numAmHandlers > maxAmHandlers) {
+    char msg[100];
+    snprintf(msg, sizeof(msg),
+             "CHPL_RT_COMM_OFI_NUM_AM_HANDLERS > %d, using %d",
+             maxAmHandlers, maxAmHandlers);
+    chpl_warning(msg, 0, 0);
+    numAmHandlers = maxAmHandlers;
   }
+
+  chpl_comm_diags_set_num_am_handlers(numAmHandlers);
 }
 
 
 static
 void init_ofiEpNumCtxs(void) {
-  CHK_TRUE(numAmHandlers == 1); // force reviewing this if #AM handlers changes
-
   //
   // Note for future maintainers: if interoperability between Chapel
   // and other languages someday results in non-tasking layer threads
@@ -1709,10 +2028,10 @@ void init_ofiEpNumCtxs(void) {
   }
 
   //
-  // Receive contexts are much easier -- we just need one
-  // for each AM handler.
+  // Receive contexts are much easier -- we just need one for each AM
+  // handler.  Each of those is on a regular endpoint of its own, which
+  // init_ofiEpNumAmHandlers() already allowed for.
   //
-  CHK_TRUE(dom_attr->max_ep_rx_ctx >= numAmHandlers);
   numRxCtxs = numAmHandlers;
 }
 
@@ -1762,6 +2081,27 @@ void init_ofiExchangeAvInfo(void) {
   // Exchange addresses with the rest of the nodes.
   //
 
+  //
+  // The address layout depends on the number of AM handlers, so that
+  // has to be the same everywhere.  Check this even when not debugging,
+  // because it's user-settable and a mismatch would be hard to diagnose
+  // otherwise.
+  //
+  {
+    int* numsAmh;
+    CHPL_CALLOC(numsAmh, chpl_numNodes);
+    chpl_comm_ofi_oob_allgather(&numAmHandlers, numsAmh, sizeof(int));
+    for (int i = 0; i < chpl_numNodes; i++) {
+      if (numsAmh[i] != numAmHandlers) {
+        INTERNAL_ERROR_V("node %d has %d AM handlers but node %d has %d; "
+                         "CHPL_RT_COMM_OFI_NUM_AM_HANDLERS must be the same "
+                         "on all nodes",
+                         i, numsAmh[i], (int) chpl_nodeID, numAmHandlers);
+      }
+    }
+    CHPL_FREE(numsAmh);
+  }
+
   //
   // Get everybody else's address.
   // Note: this assumes all addresses, job-wide, are the same length.
@@ -1773,9 +2113,15 @@ void init_ofiExchangeAvInfo(void) {
     size_t len = 0;
     size_t lenRma = 0;
 
-    OFI_CHK_1(fi_getname(&ofi_rxEp->fid, NULL, &len), -FI_ETOOSMALL);
+    OFI_CHK_1(fi_getname(&amhTab[0].rxEp->fid, NULL, &len), -FI_ETOOSMALL);
     OFI_CHK_1(fi_getname(&ofi_rxEpRma->fid, NULL, &lenRma), -FI_ETOOSMALL);
     CHK_TRUE(len == lenRma);
+    for (int h = 1; h < numAmHandlers; h++) {
+      size_t lenAm = 0;
+      OFI_CHK_1(fi_getname(&amhTab[h].rxEp->fid, NULL, &lenAm),
+                -FI_ETOOSMALL);
+      CHK_TRUE(len == lenAm);
+    }
 
     size_t* lens;
     CHPL_CALLOC(lens, chpl_numNodes);
@@ -1787,31 +2133,38 @@ void init_ofiExchangeAvInfo(void) {
     }
   }
 
+  //
+  // Our addresses are those of the AM handlers' request endpoints, in
+  // handler order, followed by that of the RMA/AMO endpoint.
+  //
   char* my_addr;
   char* addrs;
   size_t my_addr_len = 0;
 
-  OFI_CHK_1(fi_getname(&ofi_rxEp->fid, NULL, &my_addr_len), -FI_ETOOSMALL);
-  CHPL_CALLOC_SZ(my_addr, 2 * my_addr_len, 1);
-  OFI_CHK(fi_getname(&ofi_rxEp->fid, my_addr, &my_addr_len));
-  OFI_CHK(fi_getname(&ofi_rxEpRma->fid, my_addr + my_addr_len, &my_addr_len));
-  CHPL_CALLOC_SZ(addrs, chpl_numNodes, 2 * my_addr_len);
+  OFI_CHK_1(fi_getname(&amhTab[0].rxEp->fid, NULL, &my_addr_len),
+            -FI_ETOOSMALL);
+  CHPL_CALLOC_SZ(my_addr, rxAddrsPerNode * my_addr_len, 1);
+  for (int h = 0; h < numAmHandlers; h++) {
+    OFI_CHK(fi_getname(&amhTab[h].rxEp->fid, my_addr + h * my_addr_len,
+                       &my_addr_len));
+  }
+  OFI_CHK(fi_getname(&ofi_rxEpRma->fid,
+                     my_addr + numAmHandlers * my_addr_len, &my_addr_len));
+  CHPL_CALLOC_SZ(addrs, chpl_numNodes, rxAddrsPerNode * my_addr_len);
   if (DBG_TEST_MASK(DBG_CFGAV)) {
-    char nameBuf[128];
-    size_t nameLen;
-    nameLen = sizeof(nameBuf);
-    char nameBuf2[128];
-    size_t nameLen2;
-    nameLen2 = sizeof(nameBuf2);
-    (void) fi_av_straddr(ofi_av, my_addr, nameBuf, &nameLen);
-    (void) fi_av_straddr(ofi_av, my_addr + my_addr_len, nameBuf2, &nameLen2);
-    DBG_PRINTF(DBG_CFGAV, "my_addrs: %.*s%s, %.*s%s",
-               (int) nameLen, nameBuf,
-               (nameLen <= sizeof(nameBuf)) ? "" : "[...]",
-               (int) nameLen2, nameBuf2,
-               (nameLen2 <= sizeof(nameBuf2)) ? "" : "[...]");
-  }
-  chpl_comm_ofi_oob_allgather(my_addr, addrs, 2 * my_addr_len);
+    for (int i = 0; i < rxAddrsPerNode; i++) {
+      char nameBuf[128];
+      size_t nameLen;
+      nameLen = sizeof(nameBuf);
+      (void) fi_av_straddr(ofi_av, my_addr + i * my_addr_len,
+                           nameBuf, &nameLen);
+      DBG_PRINTF(DBG_CFGAV, "my_addrs[%d] (%s): %.*s%s",
+                 i, (i < numAmHandlers) ? "AM" : "RMA",
+                 (int) nameLen, nameBuf,
+                 (nameLen <= sizeof(nameBuf)) ? "" : "[...]");
+    }
+  }
+  chpl_comm_ofi_oob_allgather(my_addr, addrs, rxAddrsPerNode * my_addr_len);
 
   //
   // Insert the addresses into the address vector and build up a vector
@@ -1823,9 +2176,10 @@ void init_ofiExchangeAvInfo(void) {
   // Only when the provider cannot support scalable EPs and we have
   // multiple actual endpoints are the AVs individualized to those.
   //
-  CHPL_CALLOC(ofi_rxAddrs, 2 * chpl_numNodes);
-  CHK_TRUE(fi_av_insert(ofi_av, addrs, 2 * chpl_numNodes, ofi_rxAddrs, 0, NULL)
-           == 2 * chpl_numNodes);
+  const int numAddrs = rxAddrsPerNode * chpl_numNodes;
+  CHPL_CALLOC(ofi_rxAddrs, numAddrs);
+  CHK_TRUE(fi_av_insert(ofi_av, addrs, numAddrs, ofi_rxAddrs, 0, NULL)
+           == numAddrs);
 
   CHPL_FREE(my_addr);
   CHPL_FREE(addrs);
@@ -1918,6 +2272,17 @@ void init_ofiForMem(void) {
 
 static int isAtomicValid(enum fi_datatype);
 
+//
+// Strided transfers whose contiguous runs are no larger than this are
+// packed and sent in one AM+RMA per piece, rather than one RMA per run.
+// The pieces are at most strdPackMaxSize bytes.  See strdUsePacking().
+//
+#define STRD_PACK_CHUNK_MAX 1024
+#define STRD_PACK_MAX_SIZE (1UL << 20)
+
+static size_t strdPackChunkMax = STRD_PACK_CHUNK_MAX;
+static size_t strdPackMaxSize = STRD_PACK_MAX_SIZE;
+
 static
 void init_ofiForRma(void) {
   //
@@ -1925,6 +2290,21 @@ void init_ofiForRma(void) {
   // initialize its internals.  The datatype here doesn't matter.
   //
   (void) isAtomicValid(FI_INT32);
+
+  //
+  // Packed strided transfers.  A chunk limit of 0 turns packing off.
+  //
+  strdPackChunkMax = chpl_env_rt_get_size("COMM_OFI_STRD_PACK_CHUNK_MAX",
+                                          STRD_PACK_CHUNK_MAX);
+  strdPackMaxSize = chpl_env_rt_get_size("COMM_OFI_STRD_PACK_MAX_SIZE",
+                                         STRD_PACK_MAX_SIZE);
+  if (strdPackMaxSize < strdPackChunkMax) {
+    strdPackMaxSize = strdPackChunkMax;
+  }
+
+  DBG_PRINTF(DBG_CFG,
+             "strided packing: chunks up to %zd, pieces up to %zd",
+             strdPackChunkMax, strdPackMaxSize);
 }
 
 
@@ -1941,60 +2321,65 @@ void init_ofiForAms(void) {
   // in 0.1 sec.  Assuming an average AM request size of 256 bytes, a 40
   // MiB buffer is enough to give us the desired 0.1 sec lifetime before
   // it needs renewing.  We actually then split this in half and create
-  // 2 half-sized buffers (see below), so reflect that here also.
+  // 2 half-sized buffers (see below), so reflect that here also.  With
+  // multiple AM handlers each one only sees its share of the requests,
+  // so it only needs its share of the space.
   //
-  const size_t amLZSize = ((size_t) 40 << 20) / 2;
+  size_t amLZSize = ((size_t) 40 << 20) / 2 / numAmHandlers;
+  if (amLZSize < ((size_t) 1 << 20)) {
+    amLZSize = (size_t) 1 << 20;
+  }
 
-  //
-  // Set the minimum multi-receive buffer space.  Make it big enough to
-  // hold a max-sized request from every potential sender, but no more
-  // than 10% of the buffer size.  Some providers don't have fi_setopt()
-  // for some ep types, so allow this to fail in that case.  But note
-  // that if it does fail and we get overruns we'll die or, worse yet,
-  // silently compute wrong results.
-  //
-  {
-    size_t sz = chpl_numNodes * tciTabLen * sizeof(struct amRequest_execOn_t);
-    if (sz > amLZSize / 10) {
-        sz = amLZSize / 10;
+  for (int h = 0; h < numAmHandlers; h++) {
+    struct perAmHandlerInfo_t* amh = &amhTab[h];
+
+    //
+    // Set the minimum multi-receive buffer space.  Make it big enough
+    // to hold a max-sized request from every potential sender, but no
+    // more than 10% of the buffer size.  Some providers don't have
+    // fi_setopt() for some ep types, so allow this to fail in that
+    // case.  But note that if it does fail and we get overruns we'll
+    // die or, worse yet, silently compute wrong results.
+    //
+    {
+      size_t sz = chpl_numNodes * tciTabLen
+                  * sizeof(struct amRequest_execOn_t);
+      if (sz > amLZSize / 10) {
+          sz = amLZSize / 10;
+      }
+      int ret;
+      OFI_CHK_2(fi_setopt(&amh->rxEp->fid, FI_OPT_ENDPOINT,
+                          FI_OPT_MIN_MULTI_RECV, &sz, sizeof(sz)),
+                ret, -FI_ENOSYS);
     }
-    int ret;
-    OFI_CHK_2(fi_setopt(&ofi_rxEp->fid, FI_OPT_ENDPOINT,
-                        FI_OPT_MIN_MULTI_RECV, &sz, sizeof(sz)),
-              ret, -FI_ENOSYS);
-  }
 
-  //
-  // Pre-post multi-receive buffer for inbound AM requests.  In reality
-  // set up two of these and swap back and forth between them, to hedge
-  // against receiving "buffer filled and released" events out of order
-  // with respect to the messages stored within them.
-  //
-  CHPL_CALLOC_SZ(amLZs[0], 1, amLZSize);
-  CHPL_CALLOC_SZ(amLZs[1], 1, amLZSize);
-
-  ofi_iov_reqs[0] = (struct iovec) { .iov_base = amLZs[0],
-                                     .iov_len = amLZSize, };
-  ofi_iov_reqs[1] = (struct iovec) { .iov_base = amLZs[1],
-                                     .iov_len = amLZSize, };
-  ofi_msg_reqs[0] = (struct fi_msg) { .msg_iov = &ofi_iov_reqs[0],
-                                      .desc = NULL,
-                                      .iov_count = 1,
-                                      .addr = FI_ADDR_UNSPEC,
-                                      .context = NULL,
-                                      .data = 0x0, };
-  ofi_msg_reqs[1] = (struct fi_msg) { .msg_iov = &ofi_iov_reqs[1],
-                                      .desc = NULL,
-                                      .iov_count = 1,
-                                      .addr = FI_ADDR_UNSPEC,
-                                      .context = NULL,
-                                      .data = 0x0, };
-  ofi_msg_i = 0;
-  OFI_CHK(fi_recvmsg(ofi_rxEp, &ofi_msg_reqs[ofi_msg_i], FI_MULTI_RECV));
-  DBG_PRINTF(DBG_AMBUFFERS,
-             "pre-post fi_recvmsg(AMLZs %p, len %#zx)",
-             ofi_msg_reqs[ofi_msg_i].msg_iov->iov_base,
-             ofi_msg_reqs[ofi_msg_i].msg_iov->iov_len);
+    //
+    // Pre-post multi-receive buffer for inbound AM requests.  In
+    // reality set up two of these and swap back and forth between
+    // them, to hedge against receiving "buffer filled and released"
+    // events out of order with respect to the messages stored within
+    // them.
+    //
+    for (int i = 0; i < 2; i++) {
+      CHPL_CALLOC_SZ(amh->amLZs[i], 1, amLZSize);
+      amh->iov_reqs[i] = (struct iovec) { .iov_base = amh->amLZs[i],
+                                          .iov_len = amLZSize, };
+      amh->msg_reqs[i] = (struct fi_msg) { .msg_iov = &amh->iov_reqs[i],
+                                           .desc = NULL,
+                                           .iov_count = 1,
+                                           .addr = FI_ADDR_UNSPEC,
+                                           .context = NULL,
+                                           .data = 0x0, };
+    }
+    amh->msg_i = 0;
+    OFI_CHK(fi_recvmsg(amh->rxEp, &amh->msg_reqs[amh->msg_i],
+                       FI_MULTI_RECV));
+    DBG_PRINTF(DBG_AMBUFFERS,
+               "AMH %d pre-post fi_recvmsg(AMLZs %p, len %#zx)",
+               h,
+               amh->msg_reqs[amh->msg_i].msg_iov->iov_base,
+               amh->msg_reqs[amh->msg_i].msg_iov->iov_len);
+  }
 
   init_amHandling();
 }
@@ -2155,19 +2540,26 @@ void fini_ofi(void) {
     CHPL_FREE(memTabMap);
   }
 
-  CHPL_FREE(amLZs[1]);
-  CHPL_FREE(amLZs[0]);
-
   CHPL_FREE(ofi_rxAddrs);
 
-  if (ofi_amhPollSet != NULL) {
-    OFI_CHK(fi_poll_del(ofi_amhPollSet, tciTab[tciTabLen - 1].txCmplFid, 0));
-    OFI_CHK(fi_poll_del(ofi_amhPollSet, ofi_rxCmplFidRma, 0));
-    OFI_CHK(fi_poll_del(ofi_amhPollSet, &ofi_rxCQ->fid, 0));
+  for (int h = 0; h < numAmHandlers; h++) {
+    struct perAmHandlerInfo_t* amh = &amhTab[h];
+
+    CHPL_FREE(amh->amLZs[1]);
+    CHPL_FREE(amh->amLZs[0]);
+
+    if (amh->pollSet != NULL) {
+      if (h == 0) {
+        OFI_CHK(fi_poll_del(amh->pollSet, ofi_rxCmplFidRma, 0));
+      }
+      OFI_CHK(fi_poll_del(amh->pollSet, amh->tcip->txCmplFid, 0));
+      OFI_CHK(fi_poll_del(amh->pollSet, &amh->rxCQ->fid, 0));
+    }
+
+    OFI_CHK(fi_close(&amh->rxEp->fid));
+    OFI_CHK(fi_close(&amh->rxCQ->fid));
   }
 
-  OFI_CHK(fi_close(&ofi_rxEp->fid));
-  OFI_CHK(fi_close(&ofi_rxCQ->fid));
   OFI_CHK(fi_close(&ofi_rxEpRma->fid));
   OFI_CHK(fi_close(ofi_rxCmplFidRma));
 
@@ -2182,11 +2574,15 @@ void fini_ofi(void) {
 
   OFI_CHK(fi_close(&ofi_av->fid));
 
-  if (ofi_amhPollSet != NULL) {
-    OFI_CHK(fi_close(&ofi_amhWaitSet->fid));
-    OFI_CHK(fi_close(&ofi_amhPollSet->fid));
+  for (int h = 0; h < numAmHandlers; h++) {
+    if (amhTab[h].pollSet != NULL) {
+      OFI_CHK(fi_close(&amhTab[h].waitSet->fid));
+      OFI_CHK(fi_close(&amhTab[h].pollSet->fid));
+    }
   }
 
+  CHPL_FREE(amhTab);
+
   OFI_CHK(fi_close(&ofi_domain->fid));
   OFI_CHK(fi_close(&ofi_fabric->fid));
 
@@ -2553,7 +2949,10 @@ typedef enum {
   am_opExecOnLrg,                          // on-stmt, large arg
   am_opGet,                                // do an RMA GET
   am_opPut,                                // do an RMA PUT
+  am_opGetStrd,                            // RMA GET, unpack to strided
+  am_opPutStrd,                            // pack from strided, RMA PUT
   am_opAMO,                                // do an AMO
+  am_opAllreduce,                          // partial allreduce result
   am_opFree,                               // free some memory
   am_opNop,                                // do nothing; for MCM & liveness
   am_opShutdown,                           // signal main process for shutdown
@@ -2592,6 +2991,27 @@ struct amRequest_RMA_t {
   size_t size;                  // number of bytes
 };
 
+//
+// A strided transfer is a sequence of contiguous runs ("chunks") of
+// cnt[0] bytes each.  Chunk i is at the address found by treating i as
+// a mixed-radix number with digits in cnt[1..lvls], and multiplying
+// each digit by the byte stride str[] of its level.  A request covers
+// numChunks chunks starting at firstChunk, which travel packed together
+// in a buffer on the initiator.
+//
+#define MAX_STRD_LVLS 8
+
+struct amRequest_RMAStrd_t {
+  struct amRequest_base_t b;
+  void* addr;                   // strided base address on AM target node
+  void* raddr;                  // packed buffer on AM initiator's node
+  size_t firstChunk;            // first chunk in this request
+  size_t numChunks;             // number of chunks in this request
+  int lvls;                     // number of stride levels
+  size_t cnt[MAX_STRD_LVLS + 1];  // chunk bytes, then count per level
+  size_t str[MAX_STRD_LVLS];      // byte stride per level, on AM target
+};
+
 typedef union {
   int32_t i32;
   uint32_t u32;
@@ -2613,6 +3033,14 @@ struct amRequest_AMO_t {
   void* result;                 // result address on initiator's node
 };
 
+struct amRequest_allreduce_t {
+  struct amRequest_base_t b;
+  uint64_t id;                  // reduction id
+  int step;                     // algorithm step the data is for
+  int size;                     // data size (bytes)
+  char data[CHPL_COMM_ALLREDUCE_MAX_MSG];  // partial result
+};
+
 struct amRequest_free_t {
   struct amRequest_base_t b;
   void* p;                      // address to free, on AM target node
@@ -2623,7 +3051,9 @@ typedef union {
   struct amRequest_execOn_t xo;      // present only to set the max req size
   struct amRequest_execOnLrg_t xol;
   struct amRequest_RMA_t rma;
+  struct amRequest_RMAStrd_t rmaStrd;
   struct amRequest_AMO_t amo;
+  struct amRequest_allreduce_t ar;
   struct amRequest_free_t free;
 } amRequest_t;
 
@@ -2632,6 +3062,11 @@ struct taskArg_RMA_t {
   struct amRequest_RMA_t rma;
 };
 
+struct taskArg_RMAStrd_t {
+  chpl_task_bundle_t hdr;
+  struct amRequest_RMAStrd_t rmaStrd;
+};
+
 
 #ifdef CHPL_COMM_DEBUG
 static const char* am_opName(amOp_t);
@@ -2646,8 +3081,12 @@ static void amRequestExecOn(c_nodeid_t, c_sublocid_t, chpl_fn_int_t,
                             chpl_comm_on_bundle_t*, size_t,
                             chpl_bool, chpl_bool);
 static void amRequestRMA(c_nodeid_t, amOp_t, void*, void*, size_t);
+static void amRequestRMAStrd(c_nodeid_t, amOp_t,
+                             struct amRequest_RMAStrd_t*);
 static void amRequestAMO(c_nodeid_t, void*, const void*, const void*, void*,
                          int, enum fi_datatype, size_t);
+static void amRequestAllreduce(c_nodeid_t, uint64_t, int,
+                               const void*, size_t);
 static void amRequestFree(c_nodeid_t, void*);
 static void amRequestNop(c_nodeid_t, chpl_bool);
 static void amRequestCommon(c_nodeid_t, amRequest_t*, size_t,
@@ -2673,8 +3112,11 @@ void chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
 
   chpl_comm_diags_verbose_executeOn("", node, ln, fn);
   chpl_comm_diags_incr(execute_on);
+  const uint64_t t0 = chpl_comm_diags_profile_start();
 
   amRequestExecOn(node, subloc, fid, arg, argSize, false, true);
+
+  chpl_comm_diags_profile_time("executeOn", node, ln, fn, t0);
 }
 
 
@@ -2721,8 +3163,11 @@ void chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
 
   chpl_comm_diags_verbose_executeOn("fast", node, ln, fn);
   chpl_comm_diags_incr(execute_on_fast);
+  const uint64_t t0 = chpl_comm_diags_profile_start();
 
   amRequestExecOn(node, subloc, fid, arg, argSize, true, true);
+
+  chpl_comm_diags_profile_time("fast executeOn", node, ln, fn, t0);
 }
 
 
@@ -2822,6 +3267,27 @@ void amRequestRMA(c_nodeid_t node, amOp_t op,
 }
 
 
+static inline
+void amRequestRMAStrd(c_nodeid_t node, amOp_t op,
+                      struct amRequest_RMAStrd_t* rmaStrd) {
+  assert(!isAmHandler);
+  amRequest_t req = { .rmaStrd = *rmaStrd, };
+  req.b.op = op;
+  req.b.node = chpl_nodeID;
+  amRequestCommon(node, &req, sizeof(req.rmaStrd),
+                  &req.b.pAmDone, true /*yieldDuringTxnWait*/, NULL);
+
+  //
+  // As with amRequestRMA(), this forced any previous nonblocking
+  // nonfetching-AMO AM on the same node to completion.
+  //
+  chpl_comm_taskPrvData_t* prvData = get_comm_taskPrvdata();
+  if (prvData != NULL && prvData->nfaBitmap != NULL) {
+    bitmapClear(prvData->nfaBitmap, node);
+  }
+}
+
+
 static inline
 void amRequestAMO(c_nodeid_t node, void* object,
                   const void* operand1, const void* operand2, void* result,
@@ -2925,6 +3391,22 @@ void amRequestAMO(c_nodeid_t node, void* object,
 }
 
 
+static
+void amRequestAllreduce(c_nodeid_t node, uint64_t id, int step,
+                        const void* data, size_t size) {
+  amRequest_t req = { .ar = { .b = { .op = am_opAllreduce,
+                                     .node = chpl_nodeID, },
+                              .id = id,
+                              .step = step,
+                              .size = (int) size, }, };
+  CHK_TRUE(size <= sizeof(req.ar.data));
+  memcpy(req.ar.data, data, size);
+  amRequestCommon(node, &req,
+                  offsetof(struct amRequest_allreduce_t, data) + size,
+                  NULL, true /*yieldDuringTxnWait*/, NULL);
+}
+
+
 static inline
 void amRequestFree(c_nodeid_t node, void* p) {
   amRequest_t req = { .free = { .b = { .op = am_opFree,
@@ -3086,13 +3568,15 @@ static pthread_cond_t amStartStopCond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t amStartStopMutex = PTHREAD_MUTEX_INITIALIZER;
 
 static void amHandler(void*);
-static void processRxAmReq(struct perTxCtxInfo_t*);
+static void processRxAmReq(struct perAmHandlerInfo_t*);
 static void amHandleExecOn(chpl_comm_on_bundle_t*);
 static inline void amWrapExecOnBody(void*);
 static void amHandleExecOnLrg(chpl_comm_on_bundle_t*);
 static void amWrapExecOnLrgBody(struct amRequest_execOnLrg_t*);
 static void amWrapGet(struct taskArg_RMA_t*);
 static void amWrapPut(struct taskArg_RMA_t*);
+static void amWrapGetStrd(struct taskArg_RMAStrd_t*);
+static void amWrapPutStrd(struct taskArg_RMAStrd_t*);
 static void amHandleAMO(struct amRequest_AMO_t*);
 static inline void amSendDone(c_nodeid_t, amDone_t*);
 static inline void amCheckLiveness(void);
@@ -3110,8 +3594,8 @@ void init_amHandling(void) {
   atomic_init_bool(&amHandlersExit, false);
 
   PTHREAD_CHK(pthread_mutex_lock(&amStartStopMutex));
-  for (int i = 0; i < numAmHandlers; i++) {
-    CHK_TRUE(chpl_task_createCommTask(amHandler, NULL) == 0);
+  for (int h = 0; h < numAmHandlers; h++) {
+    CHK_TRUE(chpl_task_createCommTask(amHandler, &amhTab[h]) == 0);
   }
   PTHREAD_CHK(pthread_cond_wait(&amStartStopCond, &amStartStopMutex));
   PTHREAD_CHK(pthread_mutex_unlock(&amStartStopMutex));
@@ -3142,14 +3626,17 @@ void fini_amHandling(void) {
 static __thread struct perTxCtxInfo_t* amTcip;
 
 static
-void amHandler(void* argNil) {
+void amHandler(void* arg) {
+  struct perAmHandlerInfo_t* amh = (struct perAmHandlerInfo_t*) arg;
+  amhInfo = amh;
+  isAmHandler = true;
+
   struct perTxCtxInfo_t* tcip;
   CHK_TRUE((tcip = tciAllocForAmHandler()) != NULL);
+  CHK_TRUE(tcip == amh->tcip);
   amTcip = tcip;
 
-  isAmHandler = true;
-
-  DBG_PRINTF(DBG_THREADS, "AM handler running");
+  DBG_PRINTF(DBG_THREADS, "AM handler %d running", (int) (amh - amhTab));
 
   //
   // Count this AM handler thread as running.  The creator thread
@@ -3165,19 +3652,20 @@ void amHandler(void* argNil) {
   // Process AM requests and watch transmit responses arrive.
   //
   while (!atomic_load_bool(&amHandlersExit)) {
-    if (ofi_amhPollSet != NULL) {
-      void* contexts[pollSetSize];
+    if (amh->pollSet != NULL) {
+      void* contexts[amh->pollSetSize];
       int ret;
-      OFI_CHK_COUNT(fi_poll(ofi_amhPollSet, contexts, pollSetSize), ret);
+      OFI_CHK_COUNT(fi_poll(amh->pollSet, contexts, amh->pollSetSize), ret);
 
       if (ret == 0) {
-        ret = fi_wait(ofi_amhWaitSet, 100 /*ms*/);
+        ret = fi_wait(amh->waitSet, 100 /*ms*/);
         if (ret != FI_SUCCESS
             && ret != -FI_EINTR
             && ret != -FI_ETIMEDOUT) {
-          OFI_ERR("fi_wait(ofi_amhWaitSet)", ret, fi_strerror(ret));
+          OFI_ERR("fi_wait(amh->waitSet)", ret, fi_strerror(ret));
         }
-        OFI_CHK_COUNT(fi_poll(ofi_amhPollSet, contexts, pollSetSize), ret);
+        OFI_CHK_COUNT(fi_poll(amh->pollSet, contexts, amh->pollSetSize),
+                      ret);
       }
 
       //
@@ -3187,8 +3675,8 @@ void amHandler(void* argNil) {
       // progress, and the poll call itself did that.
       //
       for (int i = 0; i < ret; i++) {
-        if (contexts[i] == &ofi_rxCQ) {
-          processRxAmReq(tcip);
+        if (contexts[i] == &amh->rxCQ) {
+          processRxAmReq(amh);
         } else if (contexts[i] == &tcip->checkTxCmplsFn) {
           (*tcip->checkTxCmplsFn)(tcip);
         } else if (contexts[i] == &checkRxRmaCmplsFn) {
@@ -3200,11 +3688,14 @@ void amHandler(void* argNil) {
       }
     } else {
       //
-      // The provider can't do poll sets.
+      // The provider can't do poll sets.  Only the first AM handler
+      // checks the RMA endpoint.
       //
-      processRxAmReq(tcip);
+      processRxAmReq(amh);
       (*tcip->checkTxCmplsFn)(tcip);
-      (*checkRxRmaCmplsFn)();
+      if (amh == &amhTab[0]) {
+        (*checkRxRmaCmplsFn)();
+      }
 
       sched_yield();
     }
@@ -3224,23 +3715,23 @@ void amHandler(void* argNil) {
     PTHREAD_CHK(pthread_cond_signal(&amStartStopCond));
   PTHREAD_CHK(pthread_mutex_unlock(&amStartStopMutex));
 
-  DBG_PRINTF(DBG_THREADS, "AM handler done");
+  DBG_PRINTF(DBG_THREADS, "AM handler %d done", (int) (amh - amhTab));
 }
 
 
 static
-void processRxAmReq(struct perTxCtxInfo_t* tcip) {
+void processRxAmReq(struct perAmHandlerInfo_t* amh) {
   //
-  // Process requests received on the AM request endpoint.
+  // Process requests received on this AM handler's request endpoint.
   //
   struct fi_cq_data_entry cqes[5];
   const size_t maxEvents = sizeof(cqes) / sizeof(cqes[0]);
   ssize_t ret;
-  CHK_TRUE((ret = fi_cq_read(ofi_rxCQ, cqes, maxEvents)) > 0
+  CHK_TRUE((ret = fi_cq_read(amh->rxCQ, cqes, maxEvents)) > 0
            || ret == -FI_EAGAIN
            || ret == -FI_EAVAIL);
   if (ret == -FI_EAVAIL) {
-    reportCQError(ofi_rxCQ);
+    reportCQError(amh->rxCQ);
   }
 
   const size_t numEvents = (ret == -FI_EAGAIN) ? 0 : ret;
@@ -3253,8 +3744,9 @@ void processRxAmReq(struct perTxCtxInfo_t* tcip) {
       amRequest_t* req = (amRequest_t*) cqes[i].buf;
       DBG_PRINTF(DBG_AMBUFFERS,
                  "CQ rx AM req @ buffer offset %zd, sz %zd, seqId %s",
-                 (char*) req - (char*) ofi_iov_reqs[ofi_msg_i].iov_base,
+                 (char*) req - (char*) amh->iov_reqs[amh->msg_i].iov_base,
                  cqes[i].len, am_seqIdStr(req));
+      chpl_comm_diags_incr_am_handler(amh - amhTab);
 
 #if defined(CHPL_COMM_DEBUG) && defined(DEBUG_CRC_MSGS)
       if (DBG_TEST_MASK(DBG_AM)) {
@@ -3269,8 +3761,13 @@ void processRxAmReq(struct perTxCtxInfo_t* tcip) {
           req->b.crc = 0;
           reqSize = (req->b.op == am_opGet || req->b.op == am_opPut)
                     ? sizeof(struct amRequest_RMA_t)
+                    : (req->b.op == am_opGetStrd || req->b.op == am_opPutStrd)
+                    ? sizeof(struct amRequest_RMAStrd_t)
                     : (req->b.op == am_opAMO)
                     ? sizeof(struct amRequest_AMO_t)
+                    : (req->b.op == am_opAllreduce)
+                    ? offsetof(struct amRequest_allreduce_t, data)
+                      + req->ar.size
                     : (req->b.op == am_opFree)
                     ? sizeof(struct amRequest_free_t)
                     : (req->b.op == am_opFree)
@@ -3318,10 +3815,37 @@ void processRxAmReq(struct perTxCtxInfo_t* tcip) {
         }
         break;
 
+      case am_opGetStrd:
+        {
+          struct taskArg_RMAStrd_t arg =
+            { .hdr.kind = CHPL_ARG_BUNDLE_KIND_TASK,
+              .rmaStrd = req->rmaStrd, };
+          chpl_task_startMovedTask(FID_NONE, (chpl_fn_p) amWrapGetStrd,
+                                   &arg, sizeof(arg), c_sublocid_any,
+                                   chpl_nullTaskID);
+        }
+        break;
+
+      case am_opPutStrd:
+        {
+          struct taskArg_RMAStrd_t arg =
+            { .hdr.kind = CHPL_ARG_BUNDLE_KIND_TASK,
+              .rmaStrd = req->rmaStrd, };
+          chpl_task_startMovedTask(FID_NONE, (chpl_fn_p) amWrapPutStrd,
+                                   &arg, sizeof(arg), c_sublocid_any,
+                                   chpl_nullTaskID);
+        }
+        break;
+
       case am_opAMO:
         amHandleAMO(&req->amo);
         break;
 
+      case am_opAllreduce:
+        chpl_comm_allreduce_arrive(req->ar.id, req->ar.step,
+                                   req->ar.data, req->ar.size);
+        break;
+
       case am_opFree:
         CHPL_FREE(req->free.p);
         break;
@@ -3347,12 +3871,14 @@ void processRxAmReq(struct perTxCtxInfo_t* tcip) {
       //
       // Multi-receive buffer filled; post the other one.
       //
-      ofi_msg_i = 1 - ofi_msg_i;
-      OFI_CHK(fi_recvmsg(ofi_rxEp, &ofi_msg_reqs[ofi_msg_i], FI_MULTI_RECV));
+      amh->msg_i = 1 - amh->msg_i;
+      OFI_CHK(fi_recvmsg(amh->rxEp, &amh->msg_reqs[amh->msg_i],
+                         FI_MULTI_RECV));
       DBG_PRINTF(DBG_AMBUFFERS,
-                 "re-post fi_recvmsg(AMLZs %p, len %#zx)",
-                 ofi_msg_reqs[ofi_msg_i].msg_iov->iov_base,
-                 ofi_msg_reqs[ofi_msg_i].msg_iov->iov_len);
+                 "AMH %d re-post fi_recvmsg(AMLZs %p, len %#zx)",
+                 (int) (amh - amhTab),
+                 amh->msg_reqs[amh->msg_i].msg_iov->iov_base,
+                 amh->msg_reqs[amh->msg_i].msg_iov->iov_len);
     }
 
     CHK_TRUE((cqes[i].flags & ~(FI_MSG | FI_RECV | FI_MULTI_RECV)) == 0);
@@ -3473,6 +3999,43 @@ void amWrapPut(struct taskArg_RMA_t* tsk_rma) {
 }
 
 
+static void strdCopy(chpl_bool, char*, char*, size_t, size_t,
+                     int, const size_t*, const size_t*);
+
+static
+void amWrapGetStrd(struct taskArg_RMAStrd_t* tsk_rmaStrd) {
+  struct amRequest_RMAStrd_t* rs = &tsk_rmaStrd->rmaStrd;
+  size_t size = rs->numChunks * rs->cnt[0];
+
+  CHK_TRUE(mrGetKey(NULL, NULL, rs->b.node, rs->raddr, size) == 0);
+  char* buf = allocBounceBuf(size);
+  (void) ofi_get(buf, rs->b.node, rs->raddr, size);
+  strdCopy(false /*pack*/, buf, rs->addr, rs->firstChunk, rs->numChunks,
+           rs->lvls, rs->cnt, rs->str);
+  freeBounceBuf(buf);
+
+  DBG_PRINTF(DBG_AM | DBG_AMRECV, "%s", am_reqDoneStr((amRequest_t*) rs));
+  amSendDone(rs->b.node, rs->b.pAmDone);
+}
+
+
+static
+void amWrapPutStrd(struct taskArg_RMAStrd_t* tsk_rmaStrd) {
+  struct amRequest_RMAStrd_t* rs = &tsk_rmaStrd->rmaStrd;
+  size_t size = rs->numChunks * rs->cnt[0];
+
+  CHK_TRUE(mrGetKey(NULL, NULL, rs->b.node, rs->raddr, size) == 0);
+  char* buf = allocBounceBuf(size);
+  strdCopy(true /*pack*/, buf, rs->addr, rs->firstChunk, rs->numChunks,
+           rs->lvls, rs->cnt, rs->str);
+  (void) ofi_put(buf, rs->b.node, rs->raddr, size);
+  freeBounceBuf(buf);
+
+  DBG_PRINTF(DBG_AM | DBG_AMRECV, "%s", am_reqDoneStr((amRequest_t*) rs));
+  amSendDone(rs->b.node, rs->b.pAmDone);
+}
+
+
 static
 void amHandleAMO(struct amRequest_AMO_t* amo) {
   assert(amo->b.node != chpl_nodeID);    // should be handled on initiator
@@ -3652,8 +4215,11 @@ void chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
 
   chpl_comm_diags_verbose_rdma("put", node, size, ln, fn, commID);
   chpl_comm_diags_incr(put);
+  const uint64_t t0 = chpl_comm_diags_profile_start();
 
   (void) ofi_put(addr, node, raddr, size);
+
+  chpl_comm_diags_profile_time("put", node, ln, fn, t0);
 }
 
 
@@ -3684,8 +4250,157 @@ void chpl_comm_get(void* addr, int32_t node, void* raddr,
 
   chpl_comm_diags_verbose_rdma("get", node, size, ln, fn, commID);
   chpl_comm_diags_incr(get);
+  const uint64_t t0 = chpl_comm_diags_profile_start();
 
   (void) ofi_get(addr, node, raddr, size);
+
+  chpl_comm_diags_profile_time("get", node, ln, fn, t0);
+}
+
+
+//
+// Copy numChunks chunks, starting at firstChunk, between the packed
+// buffer 'buf' and the strided memory at 'base'.  See the comment on
+// struct amRequest_RMAStrd_t.
+//
+static
+void strdCopy(chpl_bool pack, char* buf, char* base,
+              size_t firstChunk, size_t numChunks,
+              int lvls, const size_t* cnt, const size_t* str) {
+  size_t idx[MAX_STRD_LVLS];
+  size_t off = 0;
+
+  for (int t = 0; t < lvls; t++) {
+    idx[t] = firstChunk % cnt[t + 1];
+    firstChunk /= cnt[t + 1];
+    off += idx[t] * str[t];
+  }
+
+  for (size_t i = 0; i < numChunks; i++) {
+    if (pack) {
+      memcpy(buf, base + off, cnt[0]);
+    } else {
+      memcpy(base + off, buf, cnt[0]);
+    }
+    buf += cnt[0];
+
+    for (int t = 0; t < lvls; t++) {
+      off += str[t];
+      if (++idx[t] < cnt[t + 1]) {
+        break;
+      }
+      off -= idx[t] * str[t];
+      idx[t] = 0;
+    }
+  }
+}
+
+
+//
+// Cost model for strided transfers.  Done one run at a time, each run
+// costs a network round trip, since our PUTs and GETs are blocking.
+// Packed, each piece costs an AM round trip and an RMA, plus copying
+// the data on both sides.  So packing wins when there are more than a
+// couple of runs and they are small enough that the copies cost less
+// than the round trips they replace.
+//
+static inline
+chpl_bool strdUsePacking(size_t chunkSize, size_t numChunks) {
+  return chunkSize <= strdPackChunkMax && numChunks > 2;
+}
+
+
+//
+// Do a strided PUT or GET by packing runs together, if the cost model
+// says to.  Returns false, having done nothing, if it doesn't.
+//
+static
+chpl_bool strdPackedXfer(chpl_bool isPut, c_nodeid_t node,
+                         void* laddr, size_t* lstrides,
+                         void* raddr, size_t* rstrides,
+                         size_t* count, int32_t stridelevels, size_t elemSize,
+                         int32_t commID, int ln, int32_t fn) {
+  if (stridelevels < 1 || stridelevels > MAX_STRD_LVLS) {
+    return false;
+  }
+
+  struct amRequest_RMAStrd_t rs = { .addr = raddr,
+                                    .lvls = stridelevels, };
+  size_t lstr[MAX_STRD_LVLS];
+  size_t numChunks = 1;
+
+  rs.cnt[0] = count[0] * elemSize;
+  for (int t = 0; t < stridelevels; t++) {
+    rs.cnt[t + 1] = count[t + 1];
+    rs.str[t] = rstrides[t] * elemSize;
+    lstr[t] = lstrides[t] * elemSize;
+    numChunks *= count[t + 1];
+  }
+
+  if (rs.cnt[0] == 0 || !strdUsePacking(rs.cnt[0], numChunks)) {
+    return false;
+  }
+
+  //
+  // The target RMAs the packed data to or from our buffer, so it must
+  // be registered.  If it can't be, neither can anything else.
+  //
+  size_t chunksPerPiece = strdPackMaxSize / rs.cnt[0];
+  if (chunksPerPiece > numChunks) {
+    chunksPerPiece = numChunks;
+  }
+  size_t bufSize = chunksPerPiece * rs.cnt[0];
+  char* buf = allocBounceBuf(bufSize);
+  if (mrGetLocalKey(buf, bufSize) != 0) {
+    freeBounceBuf(buf);
+    return false;
+  }
+  rs.raddr = buf;
+
+  // Communications callback support
+  chpl_comm_cb_event_kind_t cbKind = isPut
+                                     ? chpl_comm_cb_event_kind_put_strd
+                                     : chpl_comm_cb_event_kind_get_strd;
+  if (chpl_comm_have_callbacks(cbKind)) {
+    chpl_comm_cb_info_t cb_data =
+      { cbKind, chpl_nodeID, node,
+        .iu.comm_strd={isPut ? laddr : raddr, isPut ? lstrides : rstrides,
+                       isPut ? raddr : laddr, isPut ? rstrides : lstrides,
+                       count, stridelevels, elemSize, commID, ln, fn}};
+    chpl_comm_do_callbacks (&cb_data);
+  }
+
+  DBG_PRINTF(DBG_RMA | (isPut ? DBG_RMAWRITE : DBG_RMAREAD),
+             "%s strd %d:%p %s %p, %zd chunks of sz %zd, lvls %d",
+             isPut ? "PUT" : "GET", (int) node, raddr, isPut ? "<=" : "=>",
+             laddr, numChunks, rs.cnt[0], (int) stridelevels);
+
+  for (rs.firstChunk = 0;
+       rs.firstChunk < numChunks;
+       rs.firstChunk += rs.numChunks) {
+    rs.numChunks = numChunks - rs.firstChunk;
+    if (rs.numChunks > chunksPerPiece) {
+      rs.numChunks = chunksPerPiece;
+    }
+    size_t size = rs.numChunks * rs.cnt[0];
+
+    if (isPut) {
+      chpl_comm_diags_verbose_rdma("put_strd", node, size, ln, fn, commID);
+      chpl_comm_diags_incr(put);
+      strdCopy(true /*pack*/, buf, laddr, rs.firstChunk, rs.numChunks,
+               stridelevels, rs.cnt, lstr);
+      amRequestRMAStrd(node, am_opGetStrd, &rs);
+    } else {
+      chpl_comm_diags_verbose_rdma("get_strd", node, size, ln, fn, commID);
+      chpl_comm_diags_incr(get);
+      amRequestRMAStrd(node, am_opPutStrd, &rs);
+      strdCopy(false /*pack*/, buf, laddr, rs.firstChunk, rs.numChunks,
+               stridelevels, rs.cnt, lstr);
+    }
+  }
+
+  freeBounceBuf(buf);
+  return true;
 }
 
 
@@ -3694,6 +4409,12 @@ void chpl_comm_put_strd(void* dstaddr_arg, size_t* dststrides,
                         void* srcaddr_arg, size_t* srcstrides,
                         size_t* count, int32_t stridelevels, size_t elemSize,
                         int32_t commID, int ln, int32_t fn) {
+  if (strdPackedXfer(true /*isPut*/, dstnode,
+                     srcaddr_arg, srcstrides, dstaddr_arg, dststrides,
+                     count, stridelevels, elemSize, commID, ln, fn)) {
+    return;
+  }
+
   put_strd_common(dstaddr_arg, dststrides,
                   dstnode,
                   srcaddr_arg, srcstrides,
@@ -3708,6 +4429,12 @@ void chpl_comm_get_strd(void* dstaddr_arg, size_t* dststrides,
                         void* srcaddr_arg, size_t* srcstrides, size_t* count,
                         int32_t stridelevels, size_t elemSize,
                         int32_t commID, int ln, int32_t fn) {
+  if (strdPackedXfer(false /*isPut*/, srcnode,
+                     dstaddr_arg, dststrides, srcaddr_arg, srcstrides,
+                     count, stridelevels, elemSize, commID, ln, fn)) {
+    return;
+  }
+
   get_strd_common(dstaddr_arg, dststrides,
                   srcnode,
                   srcaddr_arg, srcstrides,
@@ -3905,11 +4632,11 @@ struct perTxCtxInfo_t* findFreeTciTabEntry(chpl_bool bindToAmHandler) {
 
   if (bindToAmHandler) {
     //
-    // AM handlers use tciTab[numWorkerTxCtxs .. tciTabLen - 1].  For
-    // now we only support a single AM handler, so this is simple.  If
-    // we ever have more, the CHK_FALSE will force us to revisit this.
+    // AM handlers use tciTab[numWorkerTxCtxs .. tciTabLen - 1], one
+    // each, in the same order as amhTab[].
     //
-    tcip = &tciTab[numWorkerTxCtxs];
+    CHK_TRUE(amhInfo != NULL);
+    tcip = &tciTab[numWorkerTxCtxs + (amhInfo - amhTab)];
     CHK_FALSE(atomic_exchange_bool(&tcip->allocated, true));
     return tcip;
   }
@@ -4194,16 +4921,16 @@ void ofi_put_V(int v_len, void** addr_v, void** local_mr_v,
 
 // Flush buffered PUTs for the specified task info and reset the counter.
 static inline
-void put_buff_task_info_flush(put_buff_task_info_t* info) {
-  if (info->vi > 0) {
+void put_buff_task_info_flush(put_buff_task_info_t* info, chpl_bool full) {
+  if (info->c.vi > 0) {
     DBG_PRINTF(DBG_RMAUNORD,
-               "put_buff_task_info_flush(): info has %d entries",
-               info->vi);
-    ofi_put_V(info->vi, info->src_addr_v, info->local_mr_v,
+               "put_buff_task_info_flush(%s): info has %d of %d entries",
+               full ? "full" : "fence", info->c.vi, info->c.len);
+    ofi_put_V(info->c.vi, info->src_addr_v, info->local_mr_v,
               info->locale_v, info->tgt_addr_v, info->remote_mr_v,
               info->size_v, &info->nodeBitmap);
-    info->vi = 0;
   }
+  chain_info_flushed(&info->c, full);
 }
 
 
@@ -4214,30 +4941,27 @@ void do_remote_put_buff(void* addr, c_nodeid_t node, void* raddr,
   uint64_t mrRaddr;
   put_buff_task_info_t* info;
   size_t extra_size = bitmapSizeofMap(chpl_numNodes);
-  if (size > MAX_UNORDERED_TRANS_SZ
+  if (size > maxUnorderedTransSz
       || mrGetKey(&mrKey, &mrRaddr, node, raddr, size) != 0
       || (info = task_local_buff_acquire(put_buff, extra_size)) == NULL) {
     (void) ofi_put(addr, node, raddr, size);
     return;
   }
 
-  if (info->new) {
-    info->nodeBitmap.len = chpl_numNodes;
-    info->new = false;
-  }
+  int vi = info->c.vi;
+  char* src = info->src_v + vi * maxUnorderedTransSz;
 
   void* mrDesc = NULL;
-  CHK_TRUE(mrGetDesc(&mrDesc, info->src_v, size) == 0);
+  CHK_TRUE(mrGetDesc(&mrDesc, src, size) == 0);
 
-  int vi = info->vi;
-  memcpy(&info->src_v[vi], addr, size);
-  info->src_addr_v[vi] = &info->src_v[vi];
+  memcpy(src, addr, size);
+  info->src_addr_v[vi] = src;
   info->locale_v[vi] = node;
   info->tgt_addr_v[vi] = raddr;
   info->size_v[vi] = size;
   info->remote_mr_v[vi] = mrKey;
   info->local_mr_v[vi] = mrDesc;
-  info->vi++;
+  info->c.vi++;
 
   DBG_PRINTF(DBG_RMAUNORD,
              "do_remote_put_buff(): info[%d] = "
@@ -4245,8 +4969,8 @@ void do_remote_put_buff(void* addr, c_nodeid_t node, void* raddr,
              vi, info->src_addr_v[vi], (int) node, raddr, size, mrKey, mrDesc);
 
   // flush if buffers are full
-  if (info->vi == MAX_CHAINED_PUT_LEN) {
-    put_buff_task_info_flush(info);
+  if (info->c.vi == info->c.len) {
+    put_buff_task_info_flush(info, true /*full*/);
   }
 }
 /*** END OF BUFFERED PUT OPERATIONS ***/
@@ -4471,16 +5195,16 @@ void ofi_get_V(int v_len, void** addr_v, void** local_mr_v,
 
 // Flush buffered GETs for the specified task info and reset the counter.
 static inline
-void get_buff_task_info_flush(get_buff_task_info_t* info) {
-  if (info->vi > 0) {
+void get_buff_task_info_flush(get_buff_task_info_t* info, chpl_bool full) {
+  if (info->c.vi > 0) {
     DBG_PRINTF(DBG_RMAUNORD,
-               "get_buff_task_info_flush(): info has %d entries",
-               info->vi);
-    ofi_get_V(info->vi, info->tgt_addr_v, info->local_mr_v,
+               "get_buff_task_info_flush(%s): info has %d of %d entries",
+               full ? "full" : "fence", info->c.vi, info->c.len);
+    ofi_get_V(info->c.vi, info->tgt_addr_v, info->local_mr_v,
               info->locale_v, info->src_addr_v, info->remote_mr_v,
               info->size_v);
-    info->vi = 0;
   }
+  chain_info_flushed(&info->c, full);
 }
 
 
@@ -4490,7 +5214,7 @@ void do_remote_get_buff(void* addr, c_nodeid_t node, void* raddr,
   uint64_t mrKey;
   uint64_t mrRaddr;
   get_buff_task_info_t* info;
-  if (size > MAX_UNORDERED_TRANS_SZ
+  if (size > maxUnorderedTransSz
       || mrGetKey(&mrKey, &mrRaddr, node, raddr, size) != 0
       || (info = task_local_buff_acquire(get_buff, 0)) == NULL) {
     (void) ofi_get(addr, node, raddr, size);
@@ -4500,14 +5224,14 @@ void do_remote_get_buff(void* addr, c_nodeid_t node, void* raddr,
   void* mrDesc = NULL;
   CHK_TRUE(mrGetDesc(&mrDesc, addr, size) == 0);
 
-  int vi = info->vi;
+  int vi = info->c.vi;
   info->tgt_addr_v[vi] = addr;
   info->locale_v[vi] = node;
   info->remote_mr_v[vi] = mrKey;
   info->src_addr_v[vi] = raddr;
   info->size_v[vi] = size;
   info->local_mr_v[vi] = mrDesc;
-  info->vi++;
+  info->c.vi++;
 
   DBG_PRINTF(DBG_RMAUNORD,
              "do_remote_get_buff(): info[%d] = "
@@ -4515,8 +5239,8 @@ void do_remote_get_buff(void* addr, c_nodeid_t node, void* raddr,
              vi, addr, (int) node, mrKey, raddr, size, mrDesc);
 
   // flush if buffers are full
-  if (info->vi == MAX_CHAINED_GET_LEN) {
-    get_buff_task_info_flush(info);
+  if (info->c.vi == info->c.len) {
+    get_buff_task_info_flush(info, true /*full*/);
   }
 }
 /*** END OF BUFFERED GET OPERATIONS ***/
@@ -4716,10 +5440,11 @@ void amEnsureProgress(struct perTxCtxInfo_t* tcip) {
     return;
   }
 
-  if (ofi_amhPollSet != NULL) {
-    void* contexts[pollSetSize];
+  struct perAmHandlerInfo_t* amh = amhInfo;
+  if (amh->pollSet != NULL) {
+    void* contexts[amh->pollSetSize];
     int ret;
-    OFI_CHK_COUNT(fi_poll(ofi_amhPollSet, contexts, pollSetSize), ret);
+    OFI_CHK_COUNT(fi_poll(amh->pollSet, contexts, amh->pollSetSize), ret);
 
     //
     // Process the CQs/counters that had events.  We really only have
@@ -4729,7 +5454,7 @@ void amEnsureProgress(struct perTxCtxInfo_t* tcip) {
     // progress, which the poll call itself will have done.
     //
     for (int i = 0; i < ret; i++) {
-      if (contexts[i] == &ofi_rxCQ) {
+      if (contexts[i] == &amh->rxCQ) {
         // no action
       } else if (contexts[i] == &tcip->checkTxCmplsFn) {
         (*tcip->checkTxCmplsFn)(tcip);
@@ -4742,10 +5467,13 @@ void amEnsureProgress(struct perTxCtxInfo_t* tcip) {
     }
   } else {
     //
-    // The provider can't do poll sets.
+    // The provider can't do poll sets.  As in the main loop, only the
+    // first AM handler checks the RMA endpoint.
     //
     (*tcip->checkTxCmplsFn)(tcip);
-    (*checkRxRmaCmplsFn)();
+    if (amh == &amhTab[0]) {
+      (*checkRxRmaCmplsFn)();
+    }
   }
 }
 
@@ -5432,16 +6160,17 @@ void doCpuAMO(void* obj,
 
 // Flush buffered AMOs for the specified task info and reset the counter.
 static inline
-void amo_nf_buff_task_info_flush(amo_nf_buff_task_info_t* info) {
-  if (info->vi > 0) {
+void amo_nf_buff_task_info_flush(amo_nf_buff_task_info_t* info,
+                                 chpl_bool full) {
+  if (info->c.vi > 0) {
     DBG_PRINTF(DBG_RMAUNORD,
-               "amo_nf_buff_task_info_flush(): info has %d entries",
-               info->vi);
-    ofi_amo_nf_V(info->vi, info->opnd1_v, info->local_mr,
+               "amo_nf_buff_task_info_flush(%s): info has %d of %d entries",
+               full ? "full" : "fence", info->c.vi, info->c.len);
+    ofi_amo_nf_V(info->c.vi, info->opnd1_v, info->local_mr,
                  info->locale_v, info->object_v, info->remote_mr_v,
                  info->size_v, info->cmd_v, info->type_v);
-    info->vi = 0;
   }
+  chain_info_flushed(&info->c, full);
 }
 
 
@@ -5471,16 +6200,7 @@ void do_remote_amo_nf_buff(void* opnd1, c_nodeid_t node,
     return;
   }
 
-  if (info->new) {
-    //
-    // The AMO operands themselves are stored in a vector in the info,
-    // so we only need one local memory descriptor for that vector.
-    //
-    CHK_TRUE(mrGetDesc(&info->local_mr, info->opnd1_v, size) == 0);
-    info->new = false;
-  }
-
-  int vi = info->vi;
+  int vi = info->c.vi;
   info->opnd1_v[vi]     = size == 4 ? *(uint32_t*) opnd1:
                                       *(uint64_t*) opnd1;
   info->locale_v[vi]    = node;
@@ -5489,7 +6209,7 @@ void do_remote_amo_nf_buff(void* opnd1, c_nodeid_t node,
   info->cmd_v[vi]       = ofiOp;
   info->type_v[vi]      = ofiType;
   info->remote_mr_v[vi] = mrKey;
-  info->vi++;
+  info->c.vi++;
 
   DBG_PRINTF(DBG_RMAUNORD,
              "do_remote_amo_nf_buff(): info[%d] = "
@@ -5498,8 +6218,8 @@ void do_remote_amo_nf_buff(void* opnd1, c_nodeid_t node,
              (int) ofiOp, (int) ofiType, mrKey, info->local_mr);
 
   // flush if buffers are full
-  if (info->vi == MAX_CHAINED_AMO_NF_LEN) {
-    amo_nf_buff_task_info_flush(info);
+  if (info->c.vi == info->c.len) {
+    amo_nf_buff_task_info_flush(info, true /*full*/);
   }
 }
 /*** END OF NON-FETCHING BUFFERED ATOMIC OPERATIONS ***/
@@ -5522,6 +6242,26 @@ int32_t chpl_comm_getMaxThreads(void) {
 }
 
 
+////////////////////////////////////////
+//
+// Interface: collectives
+//
+
+//
+// Allreduce partial results travel in AMs, which the AM handlers hand
+// to the participating tasks.  See chpl_comm_allreduce_rd().
+//
+void chpl_comm_allreduce(uint64_t id, void* buf, size_t count,
+                         chpl_comm_reduce_type_t type,
+                         chpl_comm_reduce_op_t op) {
+  DBG_PRINTF(DBG_INTERFACE,
+             "chpl_comm_allreduce(%#" PRIx64 ", %p, %zd, %d, %d)",
+             id, buf, count, (int) type, (int) op);
+
+  chpl_comm_allreduce_rd(id, buf, count, type, op, amRequestAllreduce, NULL);
+}
+
+
 ////////////////////////////////////////
 //
 // Interface: barriers
@@ -5821,7 +6561,10 @@ const char* am_opName(amOp_t op) {
   case am_opExecOnLrg: return "opExecOnLrg";
   case am_opGet: return "opGet";
   case am_opPut: return "opPut";
+  case am_opGetStrd: return "opGetStrd";
+  case am_opPutStrd: return "opPutStrd";
   case am_opAMO: return "opAMO";
+  case am_opAllreduce: return "opAllreduce";
   case am_opFree: return "opFree";
   case am_opNop: return "opNop";
   case am_opShutdown: return "opShutdown";
@@ -5907,6 +6650,18 @@ const char* am_reqStr(c_nodeid_t tgtNode, amRequest_t* req, size_t reqSize) {
                     req->rma.b.node, req->rma.raddr, req->rma.size);
     break;
 
+  case am_opGetStrd:
+  case am_opPutStrd:
+    len += snprintf(buf + len, sizeof(buf) - len,
+                    ", %d:%p %s %d:%p, chunks %zd..%zd of sz %zd, lvls %d",
+                    (int) tgtNode, req->rmaStrd.addr,
+                    (req->b.op == am_opGetStrd) ? "<-" : "->",
+                    req->rmaStrd.b.node, req->rmaStrd.raddr,
+                    req->rmaStrd.firstChunk,
+                    req->rmaStrd.firstChunk + req->rmaStrd.numChunks - 1,
+                    req->rmaStrd.cnt[0], req->rmaStrd.lvls);
+    break;
+
   case am_opAMO:
     if (req->amo.ofiOp == FI_CSWAP) {
       len += snprintf(buf + len, sizeof(buf) - len,
@@ -5945,6 +6700,12 @@ const char* am_reqStr(c_nodeid_t tgtNode, amRequest_t* req, size_t reqSize) {
     }
     break;
 
+  case am_opAllreduce:
+    len += snprintf(buf + len, sizeof(buf) - len,
+                    ", id %#" PRIx64 ", step %d, sz %d",
+                    req->ar.id, req->ar.step, req->ar.size);
+    break;
+
   case am_opFree:
     len += snprintf(buf + len, sizeof(buf) - len, ", %p",
                     req->free.p);
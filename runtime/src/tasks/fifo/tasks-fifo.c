@@ -27,6 +27,7 @@
 #include "chplcgfns.h"
 #include "chpl-arg-bundle.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
@@ -80,10 +81,69 @@ typedef struct lockReport {
 } lockReport_t;
 
 
+//
+// Work-stealing mode (CHPL_RT_TASKS_WORK_STEALING=true).
+//
+// By default every task goes through the single task pool above,
+// under threading_lock.  In work-stealing mode each thread that runs
+// tasks instead gets a Chase-Lev deque.  A thread pushes the tasks it
+// creates onto the bottom of its own deque and pops from there too
+// (LIFO), and threads with nothing to do steal from the top of other
+// threads' deques (FIFO).  Only the owner touches the bottom, so the
+// common create/run path needs no lock.  The task pool remains as an
+// injection queue for threads without a deque (such as the comm
+// thread) and for tasks that don't fit in a full deque.  Deques have
+// a fixed capacity, which avoids having to reclaim a grown array that
+// a thief might still be reading.
+//
+// In this mode cobegin/coforall task lists are not kept as linked
+// lists.  Instead each task records which list it belongs to, and
+// chpl_task_executeTasksInList() runs tasks from the bottom of the
+// calling thread's deque for as long as they belong to that list.
+// Children that were stolen are simply run elsewhere.
+//
+// Idle threads spin briefly and then park on a condition variable,
+// with a timeout so that a missed wakeup can only delay a thread,
+// never strand it.
+//
+#define WS_DEQUE_SIZE 8192           // entries per deque; a power of 2
+#define WS_DEFAULT_MAX_DEQUES 256    // if the thread count is unbounded
+#define WS_SPINS_BEFORE_PARK 64      // failed searches before parking
+#define WS_PARK_USECS 1000           // maximum park duration
+
+typedef struct {
+  atomic_int_least64_t top;          // thieves take from here
+  char pad1[64 - sizeof(atomic_int_least64_t)];
+  atomic_int_least64_t bottom;       // owner pushes and pops here
+  char pad2[64 - sizeof(atomic_int_least64_t)];
+  atomic_uintptr_t tasks[WS_DEQUE_SIZE];
+} ws_deque_t;
+
+static chpl_bool           ws_enabled = false;
+static chpl_bool           ws_report = false;
+static ws_deque_t**        ws_deques;          // deques of all threads
+static int32_t             ws_max_deques;
+static atomic_int_least32_t ws_num_deques;
+static atomic_int_least64_t ws_queued_cnt;     // tasks in deques and pool
+static atomic_int_least64_t ws_idle_cnt;       // threads looking for work
+static atomic_int_least32_t ws_parked_cnt;     // threads parked
+static chpl_bool           ws_threads_maxed = false;
+static chpl_thread_mutex_t ws_park_lock;
+static chpl_thread_condvar_t ws_park_cond;
+
+// Counts reported at exit with CHPL_RT_TASKS_WORK_STEALING_REPORT=true
+static atomic_uint_least64_t ws_steal_cnt;     // tasks stolen
+static atomic_uint_least64_t ws_steal_fail_cnt;// full searches that failed
+static atomic_uint_least64_t ws_park_cnt;      // times a thread parked
+static atomic_uint_least64_t ws_overflow_cnt;  // tasks sent to the pool
+
+
 // This is the data that is private to each thread.
 typedef struct {
   task_pool_p   ptask;
   lockReport_t* lockRprt;
+  ws_deque_t*   deque;        // work-stealing deque, if any
+  uint64_t      ws_rand;      // state for choosing steal victims
 } thread_private_data_t;
 
 
@@ -141,10 +201,24 @@ static void                    check_for_deadlock(void);
 static void                    thread_begin(void*);
 static void                    thread_end(void);
 static void                    maybe_add_thread(void);
+static task_pool_p             new_ptask(chpl_fn_int_t, chpl_fn_p,
+                                         void*, size_t, chpl_bool,
+                                         int, int32_t);
 static task_pool_p             add_to_task_pool(chpl_fn_int_t, chpl_fn_p,
                                                 void*, size_t,
                                                 chpl_bool, task_pool_p*,
                                                 chpl_bool, int, int32_t);
+static void                    run_task(thread_private_data_t*,
+                                        task_pool_p);
+static void                    run_task_inline(task_pool_p, task_pool_p);
+static void                    ws_init(void);
+static void                    ws_register_thread(thread_private_data_t*);
+static void                    ws_add_task(chpl_fn_int_t, chpl_fn_p,
+                                           void*, size_t, chpl_bool,
+                                           task_pool_p*, int, int32_t);
+static void                    ws_execute_tasks_in_list(task_pool_p*);
+static void                    ws_thread_loop(thread_private_data_t*);
+static void                    ws_report_tasks(void);
 
 //
 // Condition variable methods
@@ -351,6 +425,10 @@ void chpl_task_init(void) {
 
   chpl_thread_init(thread_begin, thread_end);
 
+  ws_enabled = chpl_env_rt_get_bool("TASKS_WORK_STEALING", false);
+  if (ws_enabled)
+    ws_init();
+
   //
   // Set main thread private data, so that things that require access
   // to it, like chpl_task_getID() and chpl_task_setSerial(), can be
@@ -380,6 +458,18 @@ void chpl_task_exit(void) {
   if (!initialized)
     return;
 
+  if (ws_enabled && ws_report) {
+    printf("%d: work stealing: %" PRIu64 " steals, %" PRIu64
+           " failed searches, %" PRIu64 " parks, %" PRIu64
+           " pool overflows\n",
+           (int) chpl_nodeID,
+           (uint64_t) atomic_load_uint_least64_t(&ws_steal_cnt),
+           (uint64_t) atomic_load_uint_least64_t(&ws_steal_fail_cnt),
+           (uint64_t) atomic_load_uint_least64_t(&ws_park_cnt),
+           (uint64_t) atomic_load_uint_least64_t(&ws_overflow_cnt));
+    fflush(stdout);
+  }
+
   chpl_thread_exit();
 }
 
@@ -391,6 +481,10 @@ static void* do_callMain(void* arg) {
   // make sure this thread has thread-private data.
   setup_main_thread_private_data();
 
+  // the main task creates tasks too, so give it a deque.
+  if (ws_enabled)
+    ws_register_thread(get_thread_private_data());
+
   // make sure that the lock report is set up.
   if (blockreport)
     initializeLockReportForThread();
@@ -614,6 +708,15 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
 
   arg->kind = CHPL_ARG_BUNDLE_KIND_TASK;
 
+  if (ws_enabled) {
+    ws_add_task(fid, chpl_ftable[fid], arg, arg_size, false,
+                ((task_list_locale == chpl_nodeID)
+                 ? (task_pool_p*) p_task_list_void
+                 : NULL),
+                lineno, filename);
+    return;
+  }
+
   // begin critical section
   chpl_thread_mutexLock(&threading_lock);
 
@@ -647,6 +750,11 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
   // Note: this function needs to tolerate an empty task
   // list. That will happen for coforalls inside a serial block, say.
 
+  if (ws_enabled) {
+    ws_execute_tasks_in_list(p_task_list_head);
+    return;
+  }
+
   curr_ptask = get_current_ptask(true /*must_be_task*/);
 
   while (*p_task_list_head != NULL) {
@@ -666,61 +774,70 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
     if (task_to_run_fun == NULL)
       continue;
 
-    set_current_ptask(child_ptask);
+    run_task_inline(curr_ptask, child_ptask);
+  }
+}
 
-    // begin critical section
-    chpl_thread_mutexLock(&extra_task_lock);
 
-    extra_task_cnt++;
+//
+// Run a child task on the current thread, in the context of the
+// current task, which is waiting for it.
+//
+static
+void run_task_inline(task_pool_p curr_ptask, task_pool_p child_ptask) {
+  set_current_ptask(child_ptask);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&extra_task_lock);
+  // begin critical section
+  chpl_thread_mutexLock(&extra_task_lock);
 
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_suspended(curr_ptask->taskBundle->id);
-      chpldev_taskTable_set_active(child_ptask->taskBundle->id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
+  extra_task_cnt++;
 
-    if (blockreport)
-      initializeLockReportForThread();
-
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
-                           child_ptask->taskBundle->requested_fid,
-                           child_ptask->taskBundle->filename,
-                           child_ptask->taskBundle->lineno,
-                           child_ptask->taskBundle->id,
-                           child_ptask->taskBundle->is_executeOn);
-
-    (*task_to_run_fun)(&child_ptask->bundle);
-
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
-                           child_ptask->taskBundle->requested_fid,
-                           child_ptask->taskBundle->filename,
-                           child_ptask->taskBundle->lineno,
-                           child_ptask->taskBundle->id,
-                           child_ptask->taskBundle->is_executeOn);
-
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_active(curr_ptask->taskBundle->id);
-      chpldev_taskTable_remove(child_ptask->taskBundle->id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
+  // end critical section
+  chpl_thread_mutexUnlock(&extra_task_lock);
 
-    // begin critical section
-    chpl_thread_mutexLock(&extra_task_lock);
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_suspended(curr_ptask->taskBundle->id);
+    chpldev_taskTable_set_active(child_ptask->taskBundle->id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
+
+  if (blockreport)
+    initializeLockReportForThread();
 
-    extra_task_cnt--;
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
+                         child_ptask->taskBundle->requested_fid,
+                         child_ptask->taskBundle->filename,
+                         child_ptask->taskBundle->lineno,
+                         child_ptask->taskBundle->id,
+                         child_ptask->taskBundle->is_executeOn);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&extra_task_lock);
+  (child_ptask->taskBundle->requested_fn)(&child_ptask->bundle);
 
-    set_current_ptask(curr_ptask);
-    chpl_mem_free(child_ptask, 0, 0);
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
+                         child_ptask->taskBundle->requested_fid,
+                         child_ptask->taskBundle->filename,
+                         child_ptask->taskBundle->lineno,
+                         child_ptask->taskBundle->id,
+                         child_ptask->taskBundle->is_executeOn);
 
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_active(curr_ptask->taskBundle->id);
+    chpldev_taskTable_remove(child_ptask->taskBundle->id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
   }
+
+  // begin critical section
+  chpl_thread_mutexLock(&extra_task_lock);
+
+  extra_task_cnt--;
+
+  // end critical section
+  chpl_thread_mutexUnlock(&extra_task_lock);
+
+  set_current_ptask(curr_ptask);
+  chpl_mem_free(child_ptask, 0, 0);
 }
 
 
@@ -737,6 +854,11 @@ void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
                   void* arg, size_t arg_size,
                   c_sublocid_t subloc,
                   int lineno, int32_t filename) {
+  if (ws_enabled) {
+    ws_add_task(fid, fp, arg, arg_size, true, NULL, lineno, filename);
+    return;
+  }
+
   // begin critical section
   chpl_thread_mutexLock(&threading_lock);
 
@@ -864,6 +986,8 @@ chpl_bool chpl_task_guardPagesInUse(void) {
 }
 
 uint32_t chpl_task_getNumQueuedTasks(void) {
+  if (ws_enabled)
+    return (uint32_t) atomic_load_int_least64_t(&ws_queued_cnt);
   return queued_task_cnt;
 }
 
@@ -875,7 +999,10 @@ int32_t chpl_task_getNumBlockedTasks(void) {
     chpl_thread_mutexLock(&threading_lock);
     chpl_thread_mutexLock(&block_report_lock);
 
-    numBlockedTasks = blocked_thread_cnt - idle_thread_cnt;
+    numBlockedTasks = blocked_thread_cnt
+                      - (ws_enabled
+                         ? (int) atomic_load_int_least64_t(&ws_idle_cnt)
+                         : idle_thread_cnt);
 
     // end critical section
     chpl_thread_mutexUnlock(&block_report_lock);
@@ -990,6 +1117,8 @@ static void report_all_tasks(void) {
            pendingTask->taskBundle->lineno);
     pendingTask = pendingTask->next;
   }
+  if (ws_enabled)
+    ws_report_tasks();
   printf("\n");
 
   // print out running tasks
@@ -1151,9 +1280,17 @@ thread_begin(void* ptask_void) {
 
   tp->ptask = NULL;
   tp->lockRprt = NULL;
+  tp->deque = NULL;
+  tp->ws_rand = 0;
   if (blockreport)
     initializeLockReportForThread();
 
+  if (ws_enabled) {
+    ws_register_thread(tp);
+    ws_thread_loop(tp);
+    return;
+  }
+
   while (true) {
     //
     // wait for a task to be present in the task pool
@@ -1226,38 +1363,7 @@ thread_begin(void* ptask_void) {
     // end critical section
     chpl_thread_mutexUnlock(&threading_lock);
 
-    tp->ptask = ptask;
-
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_active(ptask->taskBundle->id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
-
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
-                           ptask->taskBundle->requested_fid,
-                           ptask->taskBundle->filename,
-                           ptask->taskBundle->lineno,
-                           ptask->taskBundle->id,
-                           ptask->taskBundle->is_executeOn);
-
-    (ptask->taskBundle->requested_fn)(&ptask->bundle);
-
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
-                           ptask->taskBundle->requested_fid,
-                           ptask->taskBundle->filename,
-                           ptask->taskBundle->lineno,
-                           ptask->taskBundle->id,
-                           ptask->taskBundle->is_executeOn);
-
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_remove(ptask->taskBundle->id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
-
-    tp->ptask = NULL;
-    chpl_mem_free(ptask, 0, 0);
+    run_task(tp, ptask);
 
     // begin critical section
     chpl_thread_mutexLock(&threading_lock);
@@ -1273,6 +1379,45 @@ thread_begin(void* ptask_void) {
 }
 
 
+//
+// Run a task taken from the pool (or a deque) on an otherwise idle thread.
+//
+static void run_task(thread_private_data_t* tp, task_pool_p ptask) {
+  tp->ptask = ptask;
+
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_active(ptask->taskBundle->id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
+
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
+                         ptask->taskBundle->requested_fid,
+                         ptask->taskBundle->filename,
+                         ptask->taskBundle->lineno,
+                         ptask->taskBundle->id,
+                         ptask->taskBundle->is_executeOn);
+
+  (ptask->taskBundle->requested_fn)(&ptask->bundle);
+
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
+                         ptask->taskBundle->requested_fid,
+                         ptask->taskBundle->filename,
+                         ptask->taskBundle->lineno,
+                         ptask->taskBundle->id,
+                         ptask->taskBundle->is_executeOn);
+
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_remove(ptask->taskBundle->id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
+
+  tp->ptask = NULL;
+  chpl_mem_free(ptask, 0, 0);
+}
+
+
 //
 // When a thread is destroyed it calls this ending function.
 //
@@ -1300,7 +1445,10 @@ static void maybe_add_thread(void) {
 
   if (!warning_issued && chpl_thread_canCreate()) {
     if (chpl_thread_create(NULL) == 0) {
-      idle_thread_cnt++;
+      if (ws_enabled)
+        (void) atomic_fetch_add_int_least64_t(&ws_idle_cnt, 1);
+      else
+        idle_thread_cnt++;
     }
     else {
       int32_t max_threads = chpl_thread_getMaxThreads();
@@ -1324,17 +1472,11 @@ static void maybe_add_thread(void) {
 
 
 // create a task from the given function pointer and arguments
-// and append it to the end of the task pool
-// assumes threading_lock has already been acquired!
 static inline
-task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
-                             void* a, size_t a_size,
-                             chpl_bool is_executeOn,
-                             task_pool_p* p_task_list_head,
-                             chpl_bool is_begin_stmt,
-                             int lineno, int32_t filename) {
-
-
+task_pool_p new_ptask(chpl_fn_int_t fid, chpl_fn_p fp,
+                      void* a, size_t a_size,
+                      chpl_bool is_executeOn,
+                      int lineno, int32_t filename) {
   task_pool_p ptask;
   chpl_task_prvDataImpl_t pv;
 
@@ -1371,8 +1513,6 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
       .infoChapel      = ptask->taskBundle->infoChapel,// retain; set by caller
     };
 
-  enqueue_task(ptask, p_task_list_head);
-
   chpl_task_do_callbacks(chpl_task_cb_event_kind_create,
                          ptask->taskBundle->requested_fid,
                          ptask->taskBundle->filename,
@@ -1389,6 +1529,26 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
     chpl_thread_mutexUnlock(&taskTable_lock);
   }
 
+  return ptask;
+}
+
+
+// create a task from the given function pointer and arguments
+// and append it to the end of the task pool
+// assumes threading_lock has already been acquired!
+static inline
+task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
+                             void* a, size_t a_size,
+                             chpl_bool is_executeOn,
+                             task_pool_p* p_task_list_head,
+                             chpl_bool is_begin_stmt,
+                             int lineno, int32_t filename) {
+  task_pool_p ptask;
+
+  ptask = new_ptask(fid, fp, a, a_size, is_executeOn, lineno, filename);
+
+  enqueue_task(ptask, p_task_list_head);
+
   // If we now have more tasks than threads to run them on, try to start
   // another thread
   if (queued_task_cnt > idle_thread_cnt) {
@@ -1399,6 +1559,424 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
 }
 
 
+// Work stealing
+
+static void ws_init(void) {
+  int32_t max_threads;
+
+  ws_report = chpl_env_rt_get_bool("TASKS_WORK_STEALING_REPORT", false);
+
+  //
+  // One deque per thread that can run tasks, plus one for the main
+  // task.  If the thread count is unbounded we pick a limit; threads
+  // beyond it just use the task pool.
+  //
+  max_threads = chpl_thread_getMaxThreads();
+  ws_max_deques = (max_threads > 0) ? max_threads + 1 : WS_DEFAULT_MAX_DEQUES;
+  ws_deques = (ws_deque_t**) chpl_mem_calloc(ws_max_deques,
+                                             sizeof(ws_deques[0]),
+                                             CHPL_RT_MD_THREAD_PRV_DATA,
+                                             0, 0);
+
+  atomic_init_int_least32_t(&ws_num_deques, 0);
+  atomic_init_int_least64_t(&ws_queued_cnt, 0);
+  atomic_init_int_least64_t(&ws_idle_cnt, 0);
+  atomic_init_int_least32_t(&ws_parked_cnt, 0);
+  atomic_init_uint_least64_t(&ws_steal_cnt, 0);
+  atomic_init_uint_least64_t(&ws_steal_fail_cnt, 0);
+  atomic_init_uint_least64_t(&ws_park_cnt, 0);
+  atomic_init_uint_least64_t(&ws_overflow_cnt, 0);
+
+  chpl_thread_mutexInit(&ws_park_lock);
+  chpl_thread_condvar_init(&ws_park_cond);
+}
+
+
+//
+// Give the calling thread a deque, if there are any left.
+//
+static void ws_register_thread(thread_private_data_t* tp) {
+  int32_t idx;
+  ws_deque_t* dq;
+
+  tp->deque = NULL;
+  tp->ws_rand = 0x9E3779B97F4A7C15ULL * ((uint64_t) (intptr_t) tp | 1);
+
+  idx = atomic_fetch_add_int_least32_t(&ws_num_deques, 1);
+  if (idx >= ws_max_deques)
+    return;
+
+  dq = (ws_deque_t*) chpl_mem_calloc(1, sizeof(ws_deque_t),
+                                     CHPL_RT_MD_THREAD_PRV_DATA, 0, 0);
+  atomic_init_int_least64_t(&dq->top, 0);
+  atomic_init_int_least64_t(&dq->bottom, 0);
+
+  tp->deque = dq;
+  ws_deques[idx] = dq;
+}
+
+
+//
+// Chase-Lev deque operations, in the form given for C11 atomics by
+// Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (PPoPP 2013).  Only the owner
+// may push or pop.
+//
+static inline
+chpl_bool ws_push(ws_deque_t* dq, task_pool_p ptask) {
+  int_least64_t b = atomic_load_explicit_int_least64_t(&dq->bottom,
+                                                       memory_order_relaxed);
+  int_least64_t t = atomic_load_explicit_int_least64_t(&dq->top,
+                                                       memory_order_acquire);
+  if (b - t >= WS_DEQUE_SIZE)
+    return false;
+
+  atomic_store_explicit_uintptr_t(&dq->tasks[b & (WS_DEQUE_SIZE - 1)],
+                                  (uintptr_t) ptask, memory_order_relaxed);
+  chpl_atomic_thread_fence(memory_order_release);
+  atomic_store_explicit_int_least64_t(&dq->bottom, b + 1,
+                                      memory_order_relaxed);
+  return true;
+}
+
+
+static inline
+task_pool_p ws_pop(ws_deque_t* dq) {
+  int_least64_t b;
+  int_least64_t t;
+  task_pool_p ptask = NULL;
+
+  b = atomic_load_explicit_int_least64_t(&dq->bottom,
+                                         memory_order_relaxed) - 1;
+  atomic_store_explicit_int_least64_t(&dq->bottom, b, memory_order_relaxed);
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  t = atomic_load_explicit_int_least64_t(&dq->top, memory_order_relaxed);
+
+  if (t <= b) {
+    ptask = (task_pool_p)
+            atomic_load_explicit_uintptr_t(&dq->tasks[b & (WS_DEQUE_SIZE - 1)],
+                                           memory_order_relaxed);
+    if (t == b) {
+      // Last entry; race against thieves for it.
+      if (!atomic_compare_exchange_strong_explicit_int_least64_t(
+             &dq->top, &t, t + 1,
+             memory_order_seq_cst, memory_order_relaxed))
+        ptask = NULL;
+      atomic_store_explicit_int_least64_t(&dq->bottom, b + 1,
+                                          memory_order_relaxed);
+    }
+  }
+  else {
+    atomic_store_explicit_int_least64_t(&dq->bottom, b + 1,
+                                        memory_order_relaxed);
+  }
+
+  return ptask;
+}
+
+
+static inline
+task_pool_p ws_steal(ws_deque_t* dq) {
+  int_least64_t t;
+  int_least64_t b;
+  task_pool_p ptask;
+
+  t = atomic_load_explicit_int_least64_t(&dq->top, memory_order_acquire);
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  b = atomic_load_explicit_int_least64_t(&dq->bottom, memory_order_acquire);
+  if (t >= b)
+    return NULL;
+
+  ptask = (task_pool_p)
+          atomic_load_explicit_uintptr_t(&dq->tasks[t & (WS_DEQUE_SIZE - 1)],
+                                         memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit_int_least64_t(
+         &dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+    return NULL; // lost a race with another thief or the owner
+
+  return ptask;
+}
+
+
+static inline
+chpl_bool ws_work_available(void) {
+  return atomic_load_int_least64_t(&ws_queued_cnt) > 0;
+}
+
+
+//
+// A task was just made available.  Wake a parked thread, if there
+// is one, and start another thread if there aren't enough idle ones.
+//
+static inline
+void ws_task_added(void) {
+  if (atomic_load_int_least32_t(&ws_parked_cnt) > 0) {
+    chpl_thread_mutexLock(&ws_park_lock);
+    (void) pthread_cond_signal(&ws_park_cond);
+    chpl_thread_mutexUnlock(&ws_park_lock);
+  }
+
+  if (!ws_threads_maxed
+      && (atomic_load_int_least64_t(&ws_queued_cnt)
+          > atomic_load_int_least64_t(&ws_idle_cnt))) {
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    maybe_add_thread();
+    if (!chpl_thread_canCreate())
+      ws_threads_maxed = true;
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+}
+
+
+static void ws_add_task(chpl_fn_int_t fid, chpl_fn_p fp,
+                        void* a, size_t a_size,
+                        chpl_bool is_executeOn,
+                        task_pool_p* p_task_list_head,
+                        int lineno, int32_t filename) {
+  thread_private_data_t* tp = chpl_thread_getPrivateData();
+  task_pool_p ptask;
+
+  ptask = new_ptask(fid, fp, a, a_size, is_executeOn, lineno, filename);
+
+  // Count it first, so that it never looks like there is less work
+  // than there is.
+  (void) atomic_fetch_add_int_least64_t(&ws_queued_cnt, 1);
+
+  if (tp != NULL && tp->deque != NULL) {
+    // Just tag the task with its list; see "Work-stealing mode" above.
+    ptask->p_list_head = p_task_list_head;
+    if (ws_push(tp->deque, ptask)) {
+      ws_task_added();
+      return;
+    }
+    (void) atomic_fetch_add_uint_least64_t(&ws_overflow_cnt, 1);
+  }
+
+  // begin critical section
+  chpl_thread_mutexLock(&threading_lock);
+
+  enqueue_task(ptask, NULL);
+
+  // end critical section
+  chpl_thread_mutexUnlock(&threading_lock);
+
+  ws_task_added();
+}
+
+
+//
+// Run the tasks in the given list that are still at the bottom of
+// this thread's deque.  Any others have been stolen, or were put in
+// the task pool, and will be run by other threads.
+//
+static void ws_execute_tasks_in_list(task_pool_p* p_task_list_head) {
+  thread_private_data_t* tp = get_thread_private_data();
+  task_pool_p curr_ptask = get_current_ptask(true /*must_be_task*/);
+  task_pool_p child_ptask;
+
+  if (tp->deque == NULL)
+    return;
+
+  while ((child_ptask = ws_pop(tp->deque)) != NULL) {
+    if (child_ptask->p_list_head != p_task_list_head) {
+      // This belongs to some enclosing construct; leave it be.  It
+      // just came off, so it will fit.
+      (void) ws_push(tp->deque, child_ptask);
+      break;
+    }
+
+    (void) atomic_fetch_sub_int_least64_t(&ws_queued_cnt, 1);
+    run_task_inline(curr_ptask, child_ptask);
+  }
+}
+
+
+//
+// Find a task for an idle thread: first from its own deque, then from
+// the task pool, then by stealing from a randomly chosen thread.
+//
+static task_pool_p ws_find_task(thread_private_data_t* tp) {
+  task_pool_p ptask = NULL;
+  int32_t n;
+  int32_t start;
+  int32_t i;
+
+  if (tp->deque != NULL && (ptask = ws_pop(tp->deque)) != NULL)
+    goto found;
+
+  if (task_pool_head != NULL) {
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    if ((ptask = task_pool_head) != NULL)
+      dequeue_task(ptask);
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+
+    if (ptask != NULL)
+      goto found;
+  }
+
+  n = atomic_load_int_least32_t(&ws_num_deques);
+  if (n > ws_max_deques)
+    n = ws_max_deques;
+  if (n == 0)
+    return NULL;
+
+  // xorshift64
+  tp->ws_rand ^= tp->ws_rand << 13;
+  tp->ws_rand ^= tp->ws_rand >> 7;
+  tp->ws_rand ^= tp->ws_rand << 17;
+  start = (int32_t) (tp->ws_rand % (uint64_t) n);
+
+  for (i = 0; i < n; i++) {
+    ws_deque_t* victim = ws_deques[(start + i) % n];
+    if (victim == NULL || victim == tp->deque)
+      continue;
+    if ((ptask = ws_steal(victim)) != NULL) {
+      (void) atomic_fetch_add_uint_least64_t(&ws_steal_cnt, 1);
+      goto found;
+    }
+  }
+
+  (void) atomic_fetch_add_uint_least64_t(&ws_steal_fail_cnt, 1);
+  return NULL;
+
+found:
+  (void) atomic_fetch_sub_int_least64_t(&ws_queued_cnt, 1);
+  return ptask;
+}
+
+
+//
+// Park the calling thread until a task is added or the timeout
+// expires.  The wakeup side (ws_task_added()) counts the task before
+// checking for parked threads and we count ourselves as parked before
+// checking for tasks, so one side or the other always notices.
+//
+static void ws_park(void) {
+  struct timeval now;
+  struct timespec ts;
+
+  chpl_thread_mutexLock(&ws_park_lock);
+  (void) atomic_fetch_add_int_least32_t(&ws_parked_cnt, 1);
+
+  if (!ws_work_available()) {
+    (void) atomic_fetch_add_uint_least64_t(&ws_park_cnt, 1);
+    gettimeofday(&now, NULL);
+    ts.tv_sec = now.tv_sec;
+    ts.tv_nsec = (now.tv_usec + WS_PARK_USECS) * 1000UL;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000L;
+    }
+    (void) pthread_cond_timedwait(&ws_park_cond, &ws_park_lock, &ts);
+  }
+
+  (void) atomic_fetch_sub_int_least32_t(&ws_parked_cnt, 1);
+  chpl_thread_mutexUnlock(&ws_park_lock);
+}
+
+
+//
+// Wait for work to show up, doing the same deadlock detection as the
+// non-work-stealing loop in thread_begin().
+//
+static void ws_idle_wait(void) {
+  struct timeval deadline, now;
+  chpl_bool maybe_deadlocked;
+  int spins = 0;
+
+  maybe_deadlocked = set_block_loc(0, CHPL_FILE_IDX_IDLE_TASK);
+  if (maybe_deadlocked) {
+    gettimeofday(&deadline, NULL);
+    deadline.tv_sec += 1;
+  }
+
+  while (!ws_work_available()) {
+    if (spins < WS_SPINS_BEFORE_PARK)
+      spins++;
+    else
+      ws_park();
+
+    // This is also where the thread can be canceled at shutdown.
+    chpl_thread_yield();
+
+    if (maybe_deadlocked && !ws_work_available()) {
+      gettimeofday(&now, NULL);
+      if (now.tv_sec > deadline.tv_sec
+          || (now.tv_sec == deadline.tv_sec
+              && now.tv_usec >= deadline.tv_usec)) {
+        check_for_deadlock();
+        break;
+      }
+    }
+  }
+
+  unset_block_loc();
+}
+
+
+static void ws_thread_loop(thread_private_data_t* tp) {
+  task_pool_p ptask;
+  int fails = 0;
+
+  while (true) {
+    if ((ptask = ws_find_task(tp)) == NULL) {
+      // Work can be present but momentarily out of reach (a thief
+      // lost a race, say), so retry a few times before really waiting.
+      if (++fails < WS_SPINS_BEFORE_PARK && ws_work_available())
+        chpl_thread_yield();
+      else {
+        ws_idle_wait();
+        fails = 0;
+      }
+      continue;
+    }
+    fails = 0;
+
+    if (blockreport)
+      progress_cnt++;
+
+    (void) atomic_fetch_sub_int_least64_t(&ws_idle_cnt, 1);
+    run_task(tp, ptask);
+    (void) atomic_fetch_add_int_least64_t(&ws_idle_cnt, 1);
+  }
+}
+
+
+//
+// Print the tasks waiting in the deques, for the task report.  This
+// reads the deques without synchronization, so it is only a snapshot.
+//
+static void ws_report_tasks(void) {
+  int32_t n = atomic_load_int_least32_t(&ws_num_deques);
+  int32_t i;
+
+  if (n > ws_max_deques)
+    n = ws_max_deques;
+  for (i = 0; i < n; i++) {
+    ws_deque_t* dq = ws_deques[i];
+    int_least64_t t, b;
+    if (dq == NULL)
+      continue;
+    t = atomic_load_int_least64_t(&dq->top);
+    b = atomic_load_int_least64_t(&dq->bottom);
+    for ( ; t < b; t++) {
+      task_pool_p ptask = (task_pool_p)
+        atomic_load_uintptr_t(&dq->tasks[t & (WS_DEQUE_SIZE - 1)]);
+      printf("- %s:%d\n",
+             chpl_lookupFilename(ptask->taskBundle->filename),
+             ptask->taskBundle->lineno);
+    }
+  }
+}
+
 // Threads
 
 uint32_t chpl_task_getNumThreads(void) {
@@ -1406,5 +1984,7 @@ uint32_t chpl_task_getNumThreads(void) {
 }
 
 uint32_t chpl_task_getNumIdleThreads(void) {
+  if (ws_enabled)
+    return (uint32_t) atomic_load_int_least64_t(&ws_idle_cnt);
   return idle_thread_cnt;
 }
@@ -0,0 +1,11 @@
+module Helper {
+  proc triple(x: int) { return 3 * x; }
+}
+
+module incrementalCache {
+  use Helper;
+
+  proc main() {
+    writeln(triple(14));
+  }
+}
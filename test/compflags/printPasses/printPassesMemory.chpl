@@ -0,0 +1 @@
+writeln("Hello from a program compiled with --print-passes-memory");
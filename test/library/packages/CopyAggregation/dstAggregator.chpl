@@ -0,0 +1,33 @@
+use BlockDist, CopyAggregation, Random;
+
+config const n = 100000;
+
+const D = {0..#n} dmapped Block({0..#n});
+var A: [D] int = D;
+
+// scatter A through a random permutation
+var perm: [D] int = D;
+shuffle(perm, seed=17);
+
+var B: [D] int;
+forall i in D with (var agg = new DstAggregator(int)) do
+  agg.copy(B[perm[i]], A[i]);
+
+var ok = true;
+forall i in D with (&& reduce ok) do
+  ok &&= B[perm[i]] == A[i];
+writeln(ok);
+
+// reverse, with an explicit flush partway through
+var C: [D] real;
+forall i in D with (var agg = new DstAggregator(real)) {
+  agg.copy(C[n-1-i], i:real);
+  if i == n/2 then agg.flush();
+}
+writeln(&& reduce [i in D] C[i] == (n-1-i):real);
+
+// tuples are trivially copyable too
+var T: [D] (int, real);
+forall i in D with (var agg = new DstAggregator((int, real))) do
+  agg.copy(T[(i + n/3) % n], (i, i/2.0));
+writeln(&& reduce [i in D] T[(i + n/3) % n] == (i, i/2.0));
@@ -0,0 +1,3 @@
+use CopyAggregation;
+
+var agg = new DstAggregator(string);
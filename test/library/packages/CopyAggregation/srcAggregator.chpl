@@ -0,0 +1,31 @@
+use BlockDist, CopyAggregation, Random;
+
+config const n = 100000;
+
+const D = {0..#n} dmapped Block({0..#n});
+var A: [D] int = [i in D] i * 3;
+
+// gather A through a random permutation
+var perm: [D] int = D;
+shuffle(perm, seed=23);
+
+var B: [D] int;
+forall i in D with (var agg = new SrcAggregator(int)) do
+  agg.copy(B[i], A[perm[i]]);
+writeln(&& reduce [i in D] B[i] == A[perm[i]]);
+
+// reverse, with an explicit flush partway through
+var C: [D] int;
+forall i in D with (var agg = new SrcAggregator(int)) {
+  agg.copy(C[i], A[n-1-i]);
+  if i == n/2 then agg.flush();
+}
+writeln(&& reduce [i in D] C[i] == A[n-1-i]);
+
+// a destination that isn't local is copied right away
+var x: int;
+on Locales[numLocales-1] {
+  var agg = new SrcAggregator(int);
+  agg.copy(x, A[n/2]);
+}
+writeln(x == A[n/2]);
@@ -0,0 +1,98 @@
+// Compares sort() on a Block array, which uses the distributed sample
+// sort, with the two-array distributed radix sort and the element-wise
+// MSB radix sort that sort() used to call. Run at -nl 1 through 64 to
+// see how each one scales.
+use BlockDist;
+use CommDiagnostics;
+use Memory;
+use Random;
+use Sort;
+use Time;
+
+type elemType = int;
+
+const totMem = here.physicalMemory(unit = MemUnits.Bytes);
+config const memFraction = 50;
+
+config const correctness = false;
+config const commCount = false;
+config const nElemsTiny = numLocales*4096;
+config const nElemsSmall = if correctness then nElemsTiny else 10_000_000;
+config const nElemsLarge = numLocales*((totMem/numBytes(elemType))/memFraction);
+
+enum arraySize {tiny, small, large};
+
+config const size = if correctness then arraySize.tiny else arraySize.large;
+
+const nElems = if size == arraySize.tiny then nElemsTiny else
+               if size == arraySize.small then nElemsSmall else
+               if size == arraySize.large then nElemsLarge else -1;
+
+// The element-wise sort gets very slow as locales are added
+config const elementWise = numLocales <= 4;
+
+var t: Timer;
+inline proc startDiag() {
+  if !correctness {
+    if commCount {
+      startCommDiagnostics();
+    }
+    else {
+      t.start();
+    }
+  }
+}
+
+inline proc endDiag(name) {
+  if !correctness {
+    if commCount {
+      stopCommDiagnostics();
+      const d = getCommDiagnostics();
+      writeln(name, "-GETS: ", + reduce (d.get + d.get_nb));
+      writeln(name, "-PUTS: ", + reduce (d.put + d.put_nb));
+      writeln(name, "-ONS: ", + reduce (d.execute_on + d.execute_on_fast +
+                                        d.execute_on_nb));
+      resetCommDiagnostics();
+    }
+    else {
+      t.stop();
+      writeln(name, " time : ", t.elapsed());
+      const mbPerNode: real = nElems * numBytes(elemType) / (1024*1024) / numLocales;
+      writeln(name, " MB/s per node : ", mbPerNode/t.elapsed());
+      t.clear();
+    }
+  }
+}
+
+proc check(name, A, sum) {
+  if !isSorted(A) then
+    halt(name, " did not sort the array");
+  if + reduce A != sum then
+    halt(name, " changed the elements");
+}
+
+proc main() {
+  var A = newBlockArr({1..nElems}, elemType);
+  fillRandom(A, seed=314159265);
+  const sum = + reduce A;
+
+  var B = A;
+  startDiag();
+  sort(B);
+  endDiag("SampleSort");
+  check("SampleSort", B, sum);
+
+  B = A;
+  startDiag();
+  TwoArrayRadixSort.twoArrayRadixSort(B);
+  endDiag("TwoArrayRadixSort");
+  check("TwoArrayRadixSort", B, sum);
+
+  if elementWise {
+    B = A;
+    startDiag();
+    MSBRadixSort.msbRadixSort(B);
+    endDiag("MSBRadixSort");
+    check("MSBRadixSort", B, sum);
+  }
+}
@@ -0,0 +1,21 @@
+use CommDiagnostics;
+
+config const n = 1000;
+
+// Have every locale run on-statements on its neighbor.
+startCommDiagnostics();
+coforall loc in Locales do on loc {
+  const neighbor = Locales[(here.id + 1) % numLocales];
+  for 1..n do on neighbor { }
+}
+stopCommDiagnostics();
+
+// Comm layers that don't report per-handler load give an empty array.
+// The others should have handled at least the on-statements we sent.
+var ok = true;
+for loc in Locales do on loc {
+  const load = getAMHandlerLoadHere();
+  if load.size != 0 && + reduce load < n then
+    ok = false;
+}
+writeln(ok);
@@ -0,0 +1,29 @@
+use CommDiagnostics;
+
+var x: int;
+
+startCommProfile();
+on Locales[numLocales-1] {
+  for i in 1..10 do
+    x += i;
+}
+stopCommProfile();
+
+// Only report the operations this file did directly; what the modules
+// do behind the scenes can change without affecting what is tested.
+proc report() {
+  for e in getCommProfile() do
+    if e.file.endsWith("commProfile.chpl") then
+      writeln((e.locId, e.line, e.op, e.peer, e.count, e.numBytes));
+  writeln("--");
+}
+
+report();
+writeln(x);
+
+// Profiling is off now, so this should not be counted.
+on Locales[numLocales-1] do x += 1;
+report();
+
+resetCommProfile();
+report();
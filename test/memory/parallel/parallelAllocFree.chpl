@@ -0,0 +1,36 @@
+//
+// Allocate and free from many tasks at once with memory tracking on,
+// to check that the tracked totals stay consistent under concurrency.
+//
+use Memory;
+
+config const numTasks = here.maxTaskPar * 4;
+config const numIters = 2000;
+
+class C {
+  var x: int;
+}
+
+proc allocFree(tid: int) {
+  var sum = 0;
+  for i in 1..numIters {
+    var a = new unmanaged C(i);
+    var b = new unmanaged C(tid);
+    sum += a.x + b.x;
+    delete b;
+    delete a;
+  }
+  return sum;
+}
+
+var m1 = memoryUsed();
+
+var total = 0;
+coforall tid in 1..numTasks with (+ reduce total) do
+  total += allocFree(tid);
+
+var m2 = memoryUsed();
+
+writeln(total == numTasks * (numIters * (numIters + 1) / 2)
+                 + numIters * (numTasks * (numTasks + 1) / 2));
+writeln("Amount of leaked memory after parallel alloc/free: ", m2:int - m1:int);
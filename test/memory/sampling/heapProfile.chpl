@@ -0,0 +1,19 @@
+//
+// Check the heap profile written with --memSampleInterval.  With an
+// interval of 1 byte every allocation is sampled, so the profile is
+// exact and only the leaked nodes remain in it at program end.
+//
+class Node {
+  var x: int;
+  var next: unmanaged Node?;
+}
+
+config const n = 1000;
+
+var head: unmanaged Node?;
+for i in 1..n do
+  head = new unmanaged Node(i, head);
+
+var A: [1..n] int;
+A = 1;
+writeln(+ reduce A);
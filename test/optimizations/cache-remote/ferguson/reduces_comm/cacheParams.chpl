@@ -0,0 +1,24 @@
+use CommDiagnostics;
+
+config const n = 100000;
+
+var A:[1..n] int = 1..n;
+
+on Locales[1] {
+  const before = getRemoteCacheParametersHere();
+  writeln(before.page_size > 0, " ", before.line_size > 0);
+  // CHPL_RT_CACHE_REMOTE_SIZE is set to 4m in the .execenv
+  writeln(before.cache_pages * before.page_size == 4*1024*1024);
+
+  // Read A sequentially a few times; every fetched line gets used, so
+  // adaptation should never shrink the readahead window.
+  var total = 0;
+  for 1..4 do
+    for i in 1..n do
+      total += A[i];
+  writeln(total == 4 * (n * (n + 1) / 2));
+
+  const after = getRemoteCacheParametersHere();
+  writeln(after.readahead_bytes >= before.readahead_bytes);
+  writeln(after.ain_pages > 0 && after.ain_pages <= after.cache_pages / 2);
+}
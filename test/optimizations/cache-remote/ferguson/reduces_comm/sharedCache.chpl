@@ -0,0 +1,31 @@
+use CommDiagnostics;
+
+config const n = 10000;
+config const printCounts = false;
+
+var A:[1..n] int = 1..n;
+
+resetCommDiagnostics();
+startCommDiagnostics();
+
+on Locales[1] {
+  const nTasks = max(2, here.maxTaskPar);
+  var total = 0;
+  // Every task reads all of A, so with a shared cache most of the
+  // remote pages only need to be fetched once.
+  coforall tid in 0..#nTasks with (+ reduce total) {
+    for i in 1..n do
+      total += A[i];
+  }
+  writeln(total == nTasks * (n * (n + 1) / 2));
+}
+
+stopCommDiagnostics();
+
+var d = getCommDiagnostics();
+var ngets = (d(1).get + d(1).get_nb):int;
+
+if printCounts then
+  writeln(ngets, " gets, ", d(1).cache_shared_hit, " shared hits");
+
+assert(ngets < n);
@@ -0,0 +1,33 @@
+use CommDiagnostics;
+
+config const n = 1000;
+config const printCounts = false;
+
+var A:[1..n, 1..n] int;
+var B:[1..n] int;
+
+forall (i,j) in A.domain do
+  A[i,j] = i*n + j;
+
+resetCommDiagnostics();
+startCommDiagnostics();
+
+on Locales[1] {
+  // Walk down columns (a stride of one row), going forward through
+  // one array and backward through another.
+  for j in 1..n by 97 {
+    var sum = 0;
+    for i in 1..n do
+      sum += A[i,j];
+    for i in 1..n by -1 do
+      B[i] = A[i,j];
+    writeln(j, ": ", sum == n*n*(n+1)/2 + n*j, " ", B[n] == n*n + j);
+  }
+}
+
+stopCommDiagnostics();
+
+if printCounts {
+  var d = getCommDiagnostics();
+  writeln("get = ", d(1).get, " get_nb = ", d(1).get_nb);
+}
@@ -0,0 +1,54 @@
+// A coforall+on over the Locales array is started down a tree of the
+// locales when there are more of them than the fanout (set to 2 in the
+// .execenv).  Check that each locale runs the body exactly once and sees
+// the values captured where the coforall started.
+
+var x = 5;
+const s = "hello";
+var a: [1..3] int = 1;
+record R { var i: int; var str: string; }
+const r = new R(7, "seven");
+
+var seen: [LocaleSpace] int;
+coforall loc in Locales do on loc {
+  seen[here.id] += x + s.size + a[2] + r.i + r.str.size +
+                   (loc.id == here.id):int;
+}
+writeln(&& reduce (seen == 24));
+
+// nested
+var count: atomic int;
+coforall loc in Locales do on loc {
+  coforall loc2 in Locales do on loc2 do
+    count.add(1);
+}
+writeln(count.read() == numLocales**2);
+
+// through a ref formal
+proc f(ref y: int) {
+  var sum: atomic int;
+  coforall loc in Locales do on loc do
+    sum.add(y);
+  y = sum.read();
+}
+var y = 1;
+f(y);
+writeln(y == numLocales);
+
+// errors come back to the coforall
+try {
+  coforall loc in Locales do on loc {
+    if here.id == numLocales-1 then throw new Error("boom");
+  }
+} catch e: TaskErrors {
+  for err in e do writeln(err!.message());
+} catch e {
+  writeln("other ", e.message());
+}
+
+// started from somewhere other than locale 0
+on Locales[numLocales-1] {
+  var seen2: [LocaleSpace] int;
+  coforall loc in Locales do on loc do seen2[here.id] = here.id + 1;
+  writeln(&& reduce [i in LocaleSpace] (seen2[i] == i + 1));
+}
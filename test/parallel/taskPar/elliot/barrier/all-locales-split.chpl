@@ -0,0 +1,39 @@
+use AllLocalesBarriers;
+
+config const numIters = 100;
+
+// Each locale bumps its own counter and then uses the split-phase barrier;
+// after the wait every locale must see every other locale's bump.
+var counts: [LocaleSpace] atomic int;
+var errors: atomic int;
+
+coforall loc in Locales do on loc {
+  for i in 1..numIters {
+    counts[here.id].add(1);
+    allLocalesBarrier.notify();
+    if i % 2 == 0 then
+      while !allLocalesBarrier.check() { }
+    allLocalesBarrier.wait();
+    for c in counts do
+      if c.read() < i then errors.add(1);
+  }
+}
+writeln("errors: ", errors.read());
+
+// Same thing with multiple tasks per locale
+const numTasksPerLocale = 4;
+allLocalesBarrier.reset(numTasksPerLocale);
+
+coforall loc in Locales do on loc {
+  coforall tid in 1..numTasksPerLocale {
+    for i in 1..numIters {
+      counts[here.id].add(1);
+      allLocalesBarrier.notify();
+      allLocalesBarrier.wait();
+      for c in counts do
+        if c.read() < numIters + numTasksPerLocale*i then errors.add(1);
+      allLocalesBarrier.barrier();
+    }
+  }
+}
+writeln("errors: ", errors.read());
@@ -0,0 +1,41 @@
+// Exercise the fifo tasking layer's work-stealing mode with begins,
+// nested cobegins, coforalls, and tasks that block on each other.
+
+config const numBegins = 10000;
+config const numCoforall = 100;
+
+proc fib(n: int): int {
+  if n < 2 then return n;
+  if n < 10 then return fib(n-1) + fib(n-2);
+  var a, b: int;
+  cobegin with (ref a, ref b) {
+    a = fib(n-1);
+    b = fib(n-2);
+  }
+  return a + b;
+}
+
+var count: atomic int;
+sync {
+  for 1..numBegins do
+    begin count.add(1);
+}
+writeln(count.read() == numBegins);
+
+writeln(fib(20));
+
+count.write(0);
+coforall i in 1..numCoforall {
+  coforall j in 1..4 do
+    count.add(1);
+}
+writeln(count.read() == numCoforall * 4);
+
+// a chain of tasks, each waiting for the one created after it
+var s$: [0..10] sync int;
+sync {
+  for i in 1..10 do
+    begin s$[i-1].writeEF(s$[i].readFE() + 1);
+  s$[10].writeEF(0);
+}
+writeln(s$[0].readFE());
@@ -11,7 +11,8 @@ const numTasks = numLocales * numTasksPerLocale;
 enum BarrierMode {
   LocalAtomic,
   LocalSync,
-  GlobalAllLocales
+  GlobalAllLocales,
+  GlobalAllLocalesSplit
 };
 use BarrierMode;
 
@@ -25,6 +26,7 @@ proc main() {
     when LocalAtomic do LocalBarrierBarrier();
     when LocalSync do LocalSyncBarrierBarrier();
     when GlobalAllLocales do GlobalAllLocalesBarrierBarrier();
+    when GlobalAllLocalesSplit do GlobalAllLocalesSplitBarrier();
   }
   t.stop();
 
@@ -56,3 +58,13 @@ proc GlobalAllLocalesBarrierBarrier() {
       for 1..numTrials do
         allLocalesBarrier.barrier();
 }
+
+proc GlobalAllLocalesSplitBarrier() {
+  allLocalesBarrier.reset(numTasksPerLocale);
+  coforall loc in Locales do on loc do
+    coforall 1..numTasksPerLocale do
+      for 1..numTrials {
+        allLocalesBarrier.notify();
+        allLocalesBarrier.wait();
+      }
+}
@@ -0,0 +1,50 @@
+//
+// Time the broadcasts done during module initialization: the private
+// broadcasts of module-level consts of simple types and the serialized
+// broadcasts of module-level string consts.  These go down a tree
+// whose fanout is set by CHPL_RT_COMM_BCAST_FANOUT, so running this
+// with increasing numbers of locales shows how they scale.
+//
+use Time;
+
+config const printTimings = false;
+
+var t: Timer;
+t.start();
+
+config const c0 = 0, c1 = 1, c2 = 2, c3 = 3,
+             c4 = 4, c5 = 5, c6 = 6, c7 = 7;
+
+const i0 = c0 * 10, i1 = c1 * 10, i2 = c2 * 10, i3 = c3 * 10,
+      i4 = c4 * 10, i5 = c5 * 10, i6 = c6 * 10, i7 = c7 * 10;
+
+const s0 = "s" + c0:string * 16, s1 = "s" + c1:string * 16,
+      s2 = "s" + c2:string * 16, s3 = "s" + c3:string * 16,
+      s4 = "s" + c4:string * 16, s5 = "s" + c5:string * 16,
+      s6 = "s" + c6:string * 16, s7 = "s" + c7:string * 16;
+
+t.stop();
+
+proc main() {
+  const ints = (c0, c1, c2, c3, c4, c5, c6, c7,
+                i0, i1, i2, i3, i4, i5, i6, i7);
+  const strs = (s0, s1, s2, s3, s4, s5, s6, s7);
+
+  var numErrors: atomic int;
+  coforall loc in Locales with (ref numErrors) do on loc {
+    if (c0, c1, c2, c3, c4, c5, c6, c7,
+        i0, i1, i2, i3, i4, i5, i6, i7) != ints then
+      numErrors.add(1);
+    if (s0, s1, s2, s3, s4, s5, s6, s7) != strs then
+      numErrors.add(1);
+  }
+
+  if numErrors.read() == 0 then
+    writeln("Success");
+  else
+    writeln("Mismatched values: ", numErrors.read());
+
+  if printTimings {
+    writeln("Broadcast time: ", t.elapsed());
+  }
+}
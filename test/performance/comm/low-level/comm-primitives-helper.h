@@ -0,0 +1,2 @@
+static inline void emptyFn(void) { }
+static inline void infiniteSink(int x) { }
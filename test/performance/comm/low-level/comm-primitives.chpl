@@ -0,0 +1,244 @@
+//
+// Characterize the primitive operations of the comm layer between two
+// locales: GET/PUT latency and bandwidth by transfer size, nonblocking
+// GET/PUT throughput, AMO rates, the 3 flavors of remote execution, and
+// strided transfer bandwidth.  The GETs, PUTs, and strided transfers are
+// done by calling the runtime entry points the generated code uses, so
+// what is timed is just the comm layer and not the module code that would
+// otherwise lead to it.
+//
+// All operations go from locale 0 to locale 1.  With numTasks=1 the
+// reported latency is the time for one operation; with more tasks the
+// rate and bandwidth show how well the comm layer handles concurrent
+// traffic.
+//
+// This doesn't need a real network to be useful.  With GASNet's smp or
+// udp conduits, or the ofi comm layer with the sockets or tcp provider,
+// both locales can run on one machine (see "Oversubscription" in
+// doc/rst/usingchapel/executing.rst), which is enough to compare two
+// versions of a comm layer against each other.  The .ml-execopts file
+// lists the configurations whose results are graphed.
+//
+use Time, CPtr, SysCTypes, BlockDist;
+
+enum op_t {
+  opGet,
+  opPut,
+  opGetNB,
+  opPutNB,
+  opAMO,
+  opFetchAMO,
+  opOn,
+  opFastOn,
+  opOnNB,
+  opStridedGet,
+  opStridedPut
+};
+
+use op_t;
+
+config const op = opGet;
+
+// bytes moved per GET/PUT, or per strided transfer
+config const xferBytes = 8;
+
+// nonblocking operations (GET/PUT/on) in flight at once, per task
+config const nbDepth = 16;
+
+// bytes per contiguous run, for strided transfers; runs are spaced
+// twice this far apart on both sides
+config const strdRunBytes = 8;
+
+config const numTasks = 1;
+
+config const runSecs = 1.0;
+config const minOpsPerTimerCheck = 100;
+
+config const printTimings = false;
+
+extern type chpl_comm_nb_handle_t = c_void_ptr;
+
+extern proc chpl_gen_comm_get(addr: c_void_ptr, node: int(32),
+                              raddr: c_void_ptr, size: size_t,
+                              commID: int(32), ln: c_int, fn: int(32));
+extern proc chpl_gen_comm_put(addr: c_void_ptr, node: int(32),
+                              raddr: c_void_ptr, size: size_t,
+                              commID: int(32), ln: c_int, fn: int(32));
+extern proc chpl_comm_get_nb(addr: c_void_ptr, node: int(32),
+                             raddr: c_void_ptr, size: size_t,
+                             commID: int(32), ln: c_int,
+                             fn: int(32)): chpl_comm_nb_handle_t;
+extern proc chpl_comm_put_nb(addr: c_void_ptr, node: int(32),
+                             raddr: c_void_ptr, size: size_t,
+                             commID: int(32), ln: c_int,
+                             fn: int(32)): chpl_comm_nb_handle_t;
+extern proc chpl_comm_wait_nb_some(h: c_ptr(chpl_comm_nb_handle_t),
+                                   nhandles: size_t);
+extern proc chpl_gen_comm_get_strd(dstaddr: c_void_ptr,
+                                   dststrides: c_ptr(size_t),
+                                   srcnode: int(32), srcaddr: c_void_ptr,
+                                   srcstrides: c_ptr(size_t),
+                                   count: c_ptr(size_t), stridelevels: int(32),
+                                   elemSize: size_t, commID: int(32),
+                                   ln: c_int, fn: int(32));
+extern proc chpl_gen_comm_put_strd(dstaddr: c_void_ptr,
+                                   dststrides: c_ptr(size_t),
+                                   dstnode: int(32), srcaddr: c_void_ptr,
+                                   srcstrides: c_ptr(size_t),
+                                   count: c_ptr(size_t), stridelevels: int(32),
+                                   elemSize: size_t, commID: int(32),
+                                   ln: c_int, fn: int(32));
+
+const isStrided = op == opStridedGet || op == opStridedPut;
+const isNB = op == opGetNB || op == opPutNB || op == opOnNB;
+const opsPerIter = if isNB then nbDepth else 1;
+const movesData = op == opGet || op == opPut || op == opGetNB ||
+                  op == opPutNB || isStrided;
+
+// Each task gets its own buffer on both sides, big enough for the
+// spread-out runs of a strided transfer.
+const bufBytes = if isStrided then 2 * xferBytes else xferBytes;
+
+const targetSpace = LocaleSpace dmapped Block(LocaleSpace);
+var targetAtomic: [targetSpace] atomic int;
+
+proc main() {
+  if numLocales < 2 then
+    halt('This program needs at least 2 locales.');
+  if isStrided && (strdRunBytes <= 0 || xferBytes % strdRunBytes != 0) then
+    halt('xferBytes must be a multiple of strdRunBytes.');
+
+  var remoteBufs: [1..numTasks] c_void_ptr;
+  on Locales[1] {
+    for b in remoteBufs {
+      b = c_malloc(uint(8), bufBytes);
+      c_memset(b, 1, bufBytes);
+    }
+  }
+
+  // Warm up, to leave out any costs of the first communication with a
+  // locale, such as connecting endpoints.
+  on Locales[1] do emptyFn();
+
+  var numOpsOnTasks: [1..numTasks] int;
+  var timeOnTasks: [1..numTasks] real;
+  var errors: atomic int;
+
+  coforall taskIdx in 1..numTasks with (ref errors) {
+    const localBuf = c_malloc(uint(8), bufBytes);
+    const remoteBuf = remoteBufs[taskIdx];
+    c_memset(localBuf, 2, bufBytes);
+
+    var handles: [0..#nbDepth] chpl_comm_nb_handle_t;
+
+    // strides and counts for strided transfers, in bytes
+    var strides: [0..0] size_t = (2 * strdRunBytes):size_t;
+    var counts: [0..1] size_t = [strdRunBytes:size_t,
+                                 (xferBytes / max(strdRunBytes, 1)):size_t];
+
+    ref xAtomic = targetAtomic[1];
+
+    var nopsAtCheck = minOpsPerTimerCheck;
+    var nops: int;
+
+    var t: Timer;
+    var tElapsed: real;
+
+    t.start();
+
+    while true {
+      if nops >= nopsAtCheck {
+        tElapsed = t.elapsed();
+        if tElapsed >= runSecs then break;
+        nopsAtCheck = (nops * (0.75 * runSecs / tElapsed)):int;
+        if nopsAtCheck - nops < minOpsPerTimerCheck then
+          nopsAtCheck = nops + minOpsPerTimerCheck;
+      }
+
+      select op {
+        when opGet do
+          chpl_gen_comm_get(localBuf, 1, remoteBuf, xferBytes:size_t,
+                            -1, 0, 0);
+        when opPut do
+          chpl_gen_comm_put(localBuf, 1, remoteBuf, xferBytes:size_t,
+                            -1, 0, 0);
+        when opGetNB {
+          for h in handles do
+            h = chpl_comm_get_nb(localBuf, 1, remoteBuf, xferBytes:size_t,
+                                 -1, 0, 0);
+          chpl_comm_wait_nb_some(c_ptrTo(handles[0]), nbDepth:size_t);
+        }
+        when opPutNB {
+          for h in handles do
+            h = chpl_comm_put_nb(localBuf, 1, remoteBuf, xferBytes:size_t,
+                                 -1, 0, 0);
+          chpl_comm_wait_nb_some(c_ptrTo(handles[0]), nbDepth:size_t);
+        }
+        when opAMO do
+          xAtomic.add(1);
+        when opFetchAMO do
+          infiniteSink(xAtomic.fetchAdd(1));
+        when opOn do
+          on Locales[1] do emptyFn();
+        when opFastOn do
+          on Locales[1] do ;
+        when opOnNB do
+          sync {
+            for 1..nbDepth do begin on Locales[1] do emptyFn();
+          }
+        when opStridedGet do
+          chpl_gen_comm_get_strd(localBuf, c_ptrTo(strides[0]), 1,
+                                 remoteBuf, c_ptrTo(strides[0]),
+                                 c_ptrTo(counts[0]), 1, 1, -1, 0, 0);
+        when opStridedPut do
+          chpl_gen_comm_put_strd(remoteBuf, c_ptrTo(strides[0]), 1,
+                                 localBuf, c_ptrTo(strides[0]),
+                                 c_ptrTo(counts[0]), 1, 1, -1, 0, 0);
+      }
+      nops += opsPerIter;
+    }
+
+    numOpsOnTasks[taskIdx] = nops;
+    timeOnTasks[taskIdx] = tElapsed;
+
+    // Make sure the data actually moved.  GETs leave the remote bytes
+    // (1s) in our buffer, and PUTs leave ours (2s) in the remote one.
+    if movesData {
+      const isGet = op == opGet || op == opGetNB || op == opStridedGet;
+      if !isGet then
+        chpl_gen_comm_get(localBuf, 1, remoteBuf, bufBytes:size_t, -1, 0, 0);
+      const p = localBuf:c_ptr(uint(8));
+      for i in 0..#xferBytes {
+        const j = if isStrided
+                  then (i / strdRunBytes) * 2 * strdRunBytes + i % strdRunBytes
+                  else i;
+        if p[j] != (if isGet then 1 else 2) then
+          errors.add(1);
+      }
+    }
+
+    c_free(localBuf);
+  }
+
+  on Locales[1] do
+    for b in remoteBufs do c_free(b);
+
+  if errors.read() != 0 then
+    writeln('data mismatches: ', errors.read());
+
+  if printTimings {
+    const numOpsTotal = + reduce numOpsOnTasks;
+    const timeTotal = + reduce timeOnTasks;
+    const timePerTask = timeTotal / numTasks;
+    const opRate = numOpsTotal / timePerTask;
+
+    writeln('numOps = ', numOpsTotal);
+    writeln('Latency (usec/op) = ', 1e6 * timePerTask * numTasks / numOpsTotal);
+    writeln('Rate (mOps/sec) = ', opRate / 1e6);
+    if movesData then
+      writeln('Bandwidth (MB/s) = ', opRate * xferBytes / 2**20);
+  }
+}
+
+extern proc emptyFn();
+extern proc infiniteSink(x: int);
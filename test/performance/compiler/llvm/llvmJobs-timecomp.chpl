@@ -0,0 +1,56 @@
+//
+// Time compiling a program big enough for the LLVM back end's
+// optimization and code generation (the makeBinary pass) to matter,
+// with the work spread over different numbers of threads by
+// --llvm-jobs.  The program itself just needs to pull in a good mix of
+// the standard modules and distributions; its output is only checked
+// so that a mis-linked split shows up as a failure.
+//
+use BlockDist, CyclicDist, Sort, Random, Map, List, Set, Search;
+
+config const n = 1000;
+
+proc main() {
+  // distributed arrays and reductions
+  const BlockSpace = {1..n} dmapped Block({1..n});
+  const CyclicSpace = {1..n} dmapped Cyclic(startIdx=1);
+  var A: [BlockSpace] int;
+  var B: [CyclicSpace] real;
+
+  forall i in BlockSpace do A[i] = (i * 7919) % n;
+  forall i in CyclicSpace do B[i] = A[i] / 2.0;
+
+  writeln("sum A = ", + reduce A);
+  writeln("max B = ", max reduce B);
+  writeln("minloc A = ", minloc reduce zip(A, A.domain));
+
+  // sorting and searching
+  var C: [1..n] int = A;
+  sort(C);
+  writeln("sorted = ", isSorted(C));
+  const (found, idx) = binarySearch(C, C[n/2]);
+  writeln("found = ", found, ", at middle = ", C[idx] == C[n/2]);
+
+  // random numbers, with a fixed seed
+  var R: [1..n] real;
+  fillRandom(R, seed=314159);
+  writeln("random in range = ", && reduce [r in R] (r >= 0.0 && r < 1.0));
+
+  // collections
+  var m = new map(int, string);
+  var l = new list(int);
+  var s = new set(int);
+  for i in 1..n {
+    m.add(i, i:string);
+    l.append(A[i]);
+    s.add(A[i] % 97);
+  }
+  writeln("map size = ", m.size, ", m[42] = ", m[42]);
+  writeln("list size = ", l.size, ", count(0) = ", l.count(0));
+  writeln("set size = ", s.size);
+
+  // strings
+  var str = "";
+  for i in 1..10 do str += i:string + ",";
+  writeln(str.strip(","), " has ", str.count(","), " commas");
+}
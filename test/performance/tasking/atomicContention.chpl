@@ -0,0 +1,51 @@
+//
+// Atomic contention microbenchmark: the cost of a fetchAdd() on a
+// single shared atomic as the number of tasks hammering on it grows
+// from 1 to here.maxTaskPar.  For comparison it also times the same
+// number of fetchAdd()s spread over one atomic per task.
+//
+use Time;
+
+config const numOps = 100000;    // per task
+config const performance = false;
+
+const maxTasks = here.maxTaskPar;
+const taskCounts = [1, max(1, maxTasks/4), max(1, maxTasks/2), maxTasks];
+const taskCountNames = ["1 task", "maxTaskPar/4 tasks",
+                        "maxTaskPar/2 tasks", "maxTaskPar tasks"];
+
+proc report(what: string, t: Timer, numTasks: int) {
+  if performance then
+    writeln(what, " (ns per op): ", t.elapsed() * 1e9 / (numTasks * numOps));
+}
+
+proc sharedAtomic(numTasks: int, name: string) {
+  var x: atomic int;
+  var t: Timer;
+  t.start();
+  coforall 1..numTasks do
+    for 1..numOps do
+      x.fetchAdd(1);
+  t.stop();
+  report("shared fetchAdd with " + name, t, numTasks);
+  return x.read() == numTasks * numOps;
+}
+
+proc privateAtomics(numTasks: int, name: string) {
+  var xs: [1..numTasks] atomic int;
+  var t: Timer;
+  t.start();
+  coforall tid in 1..numTasks do
+    for 1..numOps do
+      xs[tid].fetchAdd(1);
+  t.stop();
+  report("private fetchAdd with " + name, t, numTasks);
+  return + reduce xs.read() == numTasks * numOps;
+}
+
+var ok = true;
+for (n, name) in zip(taskCounts, taskCountNames) do
+  ok &&= sharedAtomic(n, name);
+for (n, name) in zip(taskCounts, taskCountNames) do
+  ok &&= privateAtomics(n, name);
+writeln("atomic contention: ", ok);
@@ -0,0 +1,77 @@
+//
+// Task spawn microbenchmarks: how long it takes to create, run, and
+// wait for tasks through begin/sync, coforall, and nested coforall.
+// Each trial creates numTasks tasks (here.maxTaskPar by default), so
+// the per-task times include both the creation and the join.
+//
+use Time;
+
+config const numTrials = 100;
+config const numTasks = here.maxTaskPar;
+config const performance = false;
+
+proc report(what: string, t: Timer, tasksPerTrial: int) {
+  if performance then
+    writeln(what, " (us per task): ",
+            t.elapsed() * 1e6 / (numTrials * tasksPerTrial));
+}
+
+// begin + sync: the creating task spawns every task itself
+proc beginSpawn() {
+  var count: atomic int;
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    sync { for 1..numTasks do begin count.add(1); }
+  t.stop();
+  report("begin spawn", t, numTasks);
+  return count.read() == numTrials * numTasks;
+}
+
+// coforall: fan-out to numTasks tasks and fan back in
+proc coforallSpawn() {
+  var count: atomic int;
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    coforall 1..numTasks do count.add(1);
+  t.stop();
+  report("coforall fan-out/fan-in", t, numTasks);
+  return count.read() == numTrials * numTasks;
+}
+
+// nested coforall: two levels of sqrt(numTasks)-way fan-out, which
+// exercises tasks that create tasks themselves
+proc nestedCoforallSpawn() {
+  const width = max(2, sqrt(numTasks:real):int);
+  var count: atomic int;
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    coforall 1..width do
+      coforall 1..width do
+        count.add(1);
+  t.stop();
+  report("nested coforall fan-out/fan-in", t, width * width + width);
+  return count.read() == numTrials * width * width;
+}
+
+// a cobegin with two statements, the smallest fan-out there is
+proc cobeginSpawn() {
+  var a, b: atomic int;
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    cobegin {
+      a.add(1);
+      b.add(1);
+    }
+  t.stop();
+  report("cobegin", t, 2);
+  return a.read() == numTrials && b.read() == numTrials;
+}
+
+writeln("begin spawn: ", beginSpawn());
+writeln("coforall: ", coforallSpawn());
+writeln("nested coforall: ", nestedCoforallSpawn());
+writeln("cobegin: ", cobeginSpawn());
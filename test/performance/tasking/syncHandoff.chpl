@@ -0,0 +1,75 @@
+//
+// Synchronization handoff microbenchmarks: how long it takes for one
+// task to wake another through a sync variable, a single variable, or
+// an atomic waitFor().  Each round trip or link is a pair of blocked
+// tasks, so these mostly measure the tasking layer's block/wake path.
+//
+use Time;
+
+config const numHandoffs = 1000;
+config const performance = false;
+
+proc report(what: string, t: Timer, n: int) {
+  if performance then
+    writeln(what, " (us per handoff): ", t.elapsed() * 1e6 / n);
+}
+
+// two tasks passing a value back and forth through a pair of sync vars
+proc syncPingPong() {
+  var ping$, pong$: sync int;
+  var last: int;
+  var t: Timer;
+  t.start();
+  cobegin with (ref last) {
+    for i in 1..numHandoffs {
+      ping$.writeEF(i);
+      last = pong$.readFE();
+    }
+    for 1..numHandoffs do
+      pong$.writeEF(ping$.readFE());
+  }
+  t.stop();
+  report("sync ping-pong", t, 2 * numHandoffs);
+  return last == numHandoffs;
+}
+
+// a chain of tasks, each waiting on a single var written by the one
+// before it
+proc singleChain() {
+  const n = min(numHandoffs, 1000);
+  var links$: [0..n] single int;
+  var t: Timer;
+  t.start();
+  sync {
+    for i in 1..n do
+      begin links$[i].writeEF(links$[i-1].readFF() + 1);
+    links$[0].writeEF(0);
+  }
+  t.stop();
+  report("single chain", t, n);
+  return links$[n].readFF() == n;
+}
+
+// two tasks taking turns by waiting on an atomic
+proc atomicPingPong() {
+  var turn: atomic int;
+  var t: Timer;
+  t.start();
+  cobegin {
+    for i in 0..#numHandoffs {
+      turn.waitFor(2*i);
+      turn.write(2*i + 1);
+    }
+    for i in 0..#numHandoffs {
+      turn.waitFor(2*i + 1);
+      turn.write(2*i + 2);
+    }
+  }
+  t.stop();
+  report("atomic waitFor ping-pong", t, 2 * numHandoffs);
+  return turn.read() == 2 * numHandoffs;
+}
+
+writeln("sync ping-pong: ", syncPingPong());
+writeln("single chain: ", singleChain());
+writeln("atomic ping-pong: ", atomicPingPong());
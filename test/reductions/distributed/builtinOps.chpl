@@ -0,0 +1,48 @@
+// Built-in reductions of whole Block, Cyclic, and Stencil arrays, which
+// are done by the comm layer's allreduce in multilocale runs.
+
+use BlockDist, CyclicDist, StencilDist;
+
+config const n = 1000;
+
+const BD = {1..n} dmapped Block({1..n});
+var A: [BD] int = [i in BD] i;
+var R: [BD] real = [i in BD] i:real / 2;
+var B: [BD] bool = true;
+
+writeln(+ reduce A);
+writeln(min reduce A, " ", max reduce A);
+writeln(+ reduce R, " ", min reduce R, " ", max reduce R);
+writeln(&& reduce B, " ", || reduce B);
+B[n/2] = false;
+writeln(&& reduce B, " ", || reduce B);
+B = false;
+writeln(&& reduce B, " ", || reduce B);
+
+const CD = {1..n} dmapped Cyclic(startIdx=1);
+var C32: [CD] int(32) = [i in CD] (i % 7 - 3): int(32);
+var CU: [CD] uint = [i in CD] i: uint;
+var CR32: [CD] real(32) = [i in CD] (i % 5): real(32);
+writeln(+ reduce C32, " ", min reduce C32, " ", max reduce C32);
+writeln(+ reduce CU, " ", max reduce CU);
+writeln(+ reduce CR32);
+
+const SD = {1..n} dmapped Stencil({1..n}, fluff=(1,));
+var S: [SD] int = [i in SD] i;
+S.updateFluff();
+writeln(+ reduce S);
+
+// Fewer elements than locales, so some own none.
+const SmallD = {1..2} dmapped Block({1..2});
+var Small: [SmallD] int = [i in SmallD] -i;
+writeln(+ reduce Small, " ", min reduce Small, " ", max reduce Small);
+
+// Types the allreduce doesn't handle still work.
+var A8: [BD] int(8) = 1;
+writeln(+ reduce A8);
+
+// Concurrent reductions, started from different locales.
+var total = 0;
+coforall loc in Locales with (+ reduce total) do on loc do
+  total += + reduce A;
+writeln(total == numLocales * n * (n+1) / 2);
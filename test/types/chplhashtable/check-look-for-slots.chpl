@@ -6,11 +6,12 @@ var ht: chpl__hashtable(int, nothing);
 
 // How many buckets can lookForSlots check?
 // Let's find out.
-// Theoretically, quadratic probing should enumerate 1/2 of the slots.
+// Triangular probing over groups of 8 slots should enumerate all of the
+// slots, since table sizes are powers of 2.
 // It should always returns a value in 0..#numSlots
 
 for hash in (max(int)-3, max(int)-2, max(int)-1, max(int), 0, 1, 2, 3) {
-  for numSlots in (3, 7, 11, 19, 23, 31, 47, 83, 191, 383) {
+  for numSlots in (16, 32, 64, 128, 256, 512, 1024) {
     var hits:[0..#numSlots] int;
     for i in ht._lookForSlots(hash, numSlots) {
       if verbose then
@@ -27,7 +28,7 @@ for hash in (max(int)-3, max(int)-2, max(int)-1, max(int), 0, 1, 2, 3) {
     if verbose then
       writeln("lookForSlots(", hash, ",", numSlots, ") resulted in ", fullSlots,
               " full slots");
-    assert(fullSlots >= numSlots / 2);
+    assert(fullSlots == numSlots);
   }
 }
 
@@ -9,10 +9,10 @@ proc printTable(h: chpl__hashtable) {
           " tableNumFullSlots=", h.tableNumFullSlots);
   for slot in h.allSlots() {
     ref entry = h.table[slot];
-    if entry.status == chpl__hash_status.full {
+    if h.isSlotFull(slot) {
       writeln("slot ", slot, " full. key = ", entry.key, " val = ", entry.val);
     } else {
-      writeln("slot ", slot, " ", entry.status:string, ".");
+      writeln("slot ", slot, " ", h.slotStatus(slot):string, ".");
     }
   }
 }
@@ -26,7 +26,7 @@ proc test1() {
 
   (foundFullSlot, slotNum) = h.findAvailableSlot(1);
   assert(!foundFullSlot);
-  assert(slotNum > 0);
+  assert(slotNum >= 0);
   h.fillSlot(slotNum, 1, 10);
 
   for slot in h.allSlots() {
@@ -38,7 +38,7 @@ proc test1() {
 
   (foundFullSlot, slotNum) = h.findFullSlot(1);
   assert(foundFullSlot);
-  assert(slotNum > 0);
+  assert(slotNum >= 0);
 
   var gotKey: int;
   var gotVal: int;
@@ -113,7 +113,7 @@ proc test2() {
     var val = globalRten;
     (foundFullSlot, slotNum) = h.findAvailableSlot(key);
     assert(!foundFullSlot);
-    assert(slotNum > 0);
+    assert(slotNum >= 0);
     h.fillSlot(slotNum, key, val);
   }
 
@@ -136,7 +136,7 @@ proc test2() {
   if debug then
     writeln("found slot ", slotNum);
   assert(foundFullSlot);
-  assert(slotNum > 0);
+  assert(slotNum >= 0);
 
   writeln("requestCapacity");
   h.requestCapacity(100);
@@ -148,7 +148,7 @@ proc test2() {
   if debug then
     writeln("found slot ", slotNum);
   assert(foundFullSlot);
-  assert(slotNum > 0);
+  assert(slotNum >= 0);
 
   writeln("clearing");
   var gotKey: R;
@@ -0,0 +1,40 @@
+// Exercise the lock-striped (concurrent) hashtable used by parSafe
+// associative domains, maps and sets with concurrent adds and removes.
+use Map, Set;
+
+config const n = 10000;
+
+{
+  var D: domain(int, parSafe=true);
+  var A: [D] int;
+  forall i in 1..n with (ref D) do D += i;
+  forall i in 1..n do A[i] = i;
+  writeln(D.size, " ", + reduce A);
+  writeln(&& reduce [i in 1..n] D.contains(i));
+
+  forall i in 1..n by 2 with (ref D) do D -= i;
+  writeln(D.size, " ", + reduce A);
+  writeln(|| reduce [i in 1..n by 2] D.contains(i));
+}
+
+{
+  var D: domain(string, parSafe=true);
+  forall i in 1..n with (ref D) do D += "k" + i:string;
+  forall i in 1..n with (ref D) do D += "k" + i:string;
+  writeln(D.size);
+}
+
+{
+  var m = new map(int, int, parSafe=true);
+  forall i in 1..n with (ref m) do m.add(i, 2*i);
+  writeln(m.size, " ", + reduce m.values());
+  forall i in 1..n with (ref m) do m.remove(i);
+  writeln(m.size);
+}
+
+{
+  var s = new set(string, parSafe=true);
+  forall i in 1..n with (ref s) do s.add(i:string);
+  forall i in 1..n/2 with (ref s) do s.remove(i:string);
+  writeln(s.size, " ", s.contains(n:string), " ", s.contains("1"));
+}
@@ -87,6 +87,7 @@ _chpl ()
 --ignore-nilability-errors \
 --ignore-user-errors \
 --incremental \
+--incremental-cache-dir \
 --infer-const-refs \
 --infer-local-fields \
 --inline \
@@ -113,6 +114,7 @@ _chpl ()
 --live-analysis \
 --lldb \
 --llvm \
+--llvm-jobs \
 --llvm-print-ir \
 --llvm-print-ir-stage \
 --llvm-wide-opt \
@@ -213,6 +215,7 @@ _chpl ()
 --no-print-commands \
 --no-print-id-on-error \
 --no-print-passes \
+--no-print-passes-memory \
 --no-print-search-dirs \
 --no-print-unused-functions \
 --no-print-unused-internal-functions \
@@ -269,6 +272,7 @@ _chpl ()
 --print-module-resolution \
 --print-passes \
 --print-passes-file \
+--print-passes-memory \
 --print-search-dirs \
 --print-statistics \
 --print-unused-functions \
@@ -384,6 +388,7 @@ _chpl ()
 --license \
 --live-analysis \
 --llvm \
+--llvm-jobs \
 --llvm-wide-opt \
 --local \
 --local-checks \
@@ -440,6 +445,7 @@ _chpl ()
 --no-print-code-size \
 --no-print-commands \
 --no-print-passes \
+--no-print-passes-memory \
 --no-print-search-dirs \
 --no-print-unused-functions \
 --no-privatization \
@@ -470,6 +476,7 @@ _chpl ()
 --print-module-files \
 --print-passes \
 --print-passes-file \
+--print-passes-memory \
 --print-search-dirs \
 --print-unused-functions \
 --privatization \